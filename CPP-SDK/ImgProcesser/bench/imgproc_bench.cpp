@@ -0,0 +1,275 @@
+/**
+ * @file imgproc_bench.cpp
+ * @brief Google Benchmark suite for the ImgProcesser pipeline, one case per device image profile.
+ *
+ * Stages: decode, alpha composite, resize/rotate/flip, encode (key, second screen,
+ * background), GIF frame encode, plus the raw pixel kernels at every SIMD level.
+ * Profiles mirror the ImgHelper that StreamDock::initImgHelper() builds from each
+ * HotspotDevice constructor.
+ *
+ * Output defaults to JSON on stdout; any --benchmark_format / --benchmark_out flag
+ * overrides that. Sample images are read from IMGPROC_BENCH_DATA (env) or the
+ * repo's img/ directory.
+ */
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BufferPool.h"
+#include "DecodeCache.h"
+#include "Gif2ImgFrame.h"
+#include "OpenCVImageEncoder.h"
+#include "PixelKernels.h"
+
+#ifndef IMGPROC_BENCH_DATA_DIR
+#define IMGPROC_BENCH_DATA_DIR "img"
+#endif
+
+namespace
+{
+struct DeviceProfile
+{
+	const char* name;
+	ImgHelper helper;
+};
+
+/// Same arguments as StreamDock::initImgHelper() with each device's StreamDockInfo / FeatureOption values.
+std::vector<DeviceProfile> deviceProfiles()
+{
+	return {
+		{ "N1/key", ImgHelper(96, 96, 0.0, ResizeOption::Scale, false, false, ImgType::JPG) },
+		{ "N1/second", ImgHelper(64, 64, 0.0, ResizeOption::Scale, false, false, ImgType::JPG) },
+		{ "N1/background", ImgHelper(480, 854, 0.0, ResizeOption::Scale, false, false, ImgType::JPG) },
+		{ "N4/key", ImgHelper(112, 112, 180.0, ResizeOption::Scale, false, false, ImgType::JPG) },
+		{ "N4/second", ImgHelper(176, 112, 180.0, ResizeOption::Scale, false, false, ImgType::JPG) },
+		{ "N4/background", ImgHelper(800, 480, 180.0, ResizeOption::Scale, false, false, ImgType::JPG) },
+		{ "N4Pro/key", ImgHelper(112, 112, 180.0, ResizeOption::Scale, false, false, ImgType::PNG) },
+		{ "N4Pro/second", ImgHelper(176, 112, 180.0, ResizeOption::Scale, false, false, ImgType::JPG) },
+		{ "M3/key", ImgHelper(96, 96, -90.0, ResizeOption::Scale, false, false, ImgType::PNG) },
+		{ "M3/background", ImgHelper(854, 480, -90.0, ResizeOption::Scale, false, false, ImgType::JPG) },
+		{ "XL/key", ImgHelper(80, 80, 180.0, ResizeOption::Scale, false, false, ImgType::PNG) },
+		{ "XL/background", ImgHelper(1024, 600, 180.0, ResizeOption::Scale, false, false, ImgType::JPG) },
+		{ "293sV3/key", ImgHelper(96, 96, 270.0, ResizeOption::Scale, false, false, ImgType::JPG) },
+		{ "293sV3/second", ImgHelper(80, 80, 270.0, ResizeOption::Scale, false, false, ImgType::JPG) },
+		{ "293V2/background", ImgHelper(800, 480, 180.0, ResizeOption::Scale, false, false, ImgType::RAW, ImgFormat::BGR888) },
+		{ "N3V2/background", ImgHelper(320, 240, 90.0, ResizeOption::Scale, false, false, ImgType::RAW, ImgFormat::RGB16) },
+		{ "M18/key", ImgHelper(64, 64, 0.0, ResizeOption::Scale, false, false, ImgType::JPG) },
+		{ "K1Pro/key", ImgHelper(64, 64, 90.0, ResizeOption::Scale, false, false, ImgType::JPG) },
+	};
+}
+
+std::string dataDir()
+{
+	if (const char* dir = std::getenv("IMGPROC_BENCH_DATA"))
+		return dir;
+	return IMGPROC_BENCH_DATA_DIR;
+}
+
+std::vector<uint8_t> readFile(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/// Sample images per profile kind: keys and second screens get the icon-sized samples, backgrounds the large ones.
+std::vector<std::string> samplesFor(const std::string& profile)
+{
+	if (profile.find("background") != std::string::npos)
+		return { "backgroud_test.png", "backgroud_test2.png" };
+	return { "button_test.jpg", "mark.png" };
+}
+
+void reportBufferPool(benchmark::State& state, const BufferPoolStats& before)
+{
+	const BufferPoolStats after = BufferPool::stats();
+	const double iterations = static_cast<double>(state.iterations());
+	state.counters["allocs/iter"] = static_cast<double>(
+		(after.matAllocations - before.matAllocations) +
+		(after.byteAllocations - before.byteAllocations) +
+		(after.canvasAllocations - before.canvasAllocations)) / iterations;
+}
+
+void BM_Decode(benchmark::State& state, std::string file)
+{
+	const auto bytes = readFile(dataDir() + "/" + file);
+	if (bytes.empty())
+	{
+		state.SkipWithError("sample image not found");
+		return;
+	}
+	for (auto _ : state)
+	{
+		cv::Mat decoded = cv::imdecode(bytes, cv::IMREAD_UNCHANGED);
+		benchmark::DoNotOptimize(decoded.data);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+
+void BM_Composite(benchmark::State& state, SimdLevel level)
+{
+	cv::Mat source = cv::imread(dataDir() + "/mark.png", cv::IMREAD_UNCHANGED);
+	if (source.empty() || source.type() != CV_8UC4)
+	{
+		state.SkipWithError("mark.png with alpha not found");
+		return;
+	}
+	source = source.clone();
+	cv::Mat output(source.rows, source.cols, CV_8UC3);
+	if (PixelKernels::setMaxLevel(level) != level)
+	{
+		state.SkipWithError("SIMD level not supported on this CPU");
+		return;
+	}
+	for (auto _ : state)
+	{
+		PixelKernels::premultiplyToBlack(source.ptr<uint8_t>(), output.ptr<uint8_t>(), source.total());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * source.total()));
+	PixelKernels::setMaxLevel(SimdLevel::AVX2);
+}
+
+void BM_Kernel(benchmark::State& state, void (*kernel)(const uint8_t*, uint8_t*, size_t), int srcChannels, int dstBytes, SimdLevel level)
+{
+	if (PixelKernels::setMaxLevel(level) != level)
+	{
+		state.SkipWithError("SIMD level not supported on this CPU");
+		return;
+	}
+	const size_t pixels = static_cast<size_t>(state.range(0));
+	std::vector<uint8_t> src(pixels * srcChannels);
+	std::vector<uint8_t> dst(pixels * dstBytes);
+	for (size_t i = 0; i < src.size(); ++i)
+		src[i] = static_cast<uint8_t>(i * 131 + 7);
+	for (auto _ : state)
+	{
+		kernel(src.data(), dst.data(), pixels);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pixels));
+	PixelKernels::setMaxLevel(SimdLevel::AVX2);
+}
+
+void BM_Transform(benchmark::State& state, ImgHelper helper, std::string file)
+{
+	cv::Mat source = cv::imread(dataDir() + "/" + file, cv::IMREAD_COLOR);
+	if (source.empty())
+	{
+		state.SkipWithError("sample image not found");
+		return;
+	}
+	OpenCVImageEncoder encoder;
+	const BufferPoolStats before = BufferPool::stats();
+	for (auto _ : state)
+	{
+		cv::Mat processed = encoder.transform(source, helper, false);
+		benchmark::DoNotOptimize(processed.data);
+	}
+	reportBufferPool(state, before);
+}
+
+void BM_Encode(benchmark::State& state, ImgHelper helper, std::string file, bool decodeCache)
+{
+	const auto bytes = readFile(dataDir() + "/" + file);
+	if (bytes.empty())
+	{
+		state.SkipWithError("sample image not found");
+		return;
+	}
+	const size_t capacity = DecodeCache::capacity();
+	DecodeCache::setCapacity(decodeCache ? DecodeCache::DEFAULT_CAPACITY : 0);
+	OpenCVImageEncoder encoder;
+	std::vector<uint8_t> out;
+	const BufferPoolStats before = BufferPool::stats();
+	for (auto _ : state)
+	{
+		if (!encoder.encodeToMemory(out, bytes, 95, helper))
+		{
+			state.SkipWithError("encode failed");
+			break;
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.counters["out_bytes"] = static_cast<double>(out.size());
+	reportBufferPool(state, before);
+	DecodeCache::setCapacity(capacity);
+}
+
+void BM_GifFrames(benchmark::State& state, ImgHelper helper, std::string file)
+{
+	Gif2ImgFrame gif(dataDir() + "/" + file, std::make_shared<OpenCVImageEncoder>());
+	if (!gif.isValid())
+	{
+		state.SkipWithError("sample GIF not found");
+		return;
+	}
+	size_t frames = 0;
+	const BufferPoolStats before = BufferPool::stats();
+	for (auto _ : state)
+	{
+		auto encoded = gif.encodeFramesToMemory(95, helper);
+		frames = encoded.size();
+		benchmark::DoNotOptimize(encoded.data());
+	}
+	state.counters["frames"] = static_cast<double>(frames);
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * frames));
+	reportBufferPool(state, before);
+}
+
+void registerBenchmarks()
+{
+	for (const char* file : { "button_test.jpg", "mark.png", "backgroud_test.png", "backgroud_test2.png" })
+		benchmark::RegisterBenchmark((std::string("Decode/") + file).c_str(), BM_Decode, std::string(file))->Unit(benchmark::kMicrosecond);
+
+	const SimdLevel levels[] = { SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2 };
+	for (SimdLevel level : levels)
+	{
+		const std::string suffix = PixelKernels::levelName(level);
+		benchmark::RegisterBenchmark(("Composite/mark.png/" + suffix).c_str(), BM_Composite, level)->Unit(benchmark::kMicrosecond);
+		benchmark::RegisterBenchmark(("Kernel/premultiplyToBlack/" + suffix).c_str(), BM_Kernel, &PixelKernels::premultiplyToBlack, 4, 3, level)
+			->Arg(112 * 112)->Arg(800 * 480)->Arg(1024 * 600);
+		benchmark::RegisterBenchmark(("Kernel/bgrToRgb565/" + suffix).c_str(), BM_Kernel, &PixelKernels::bgrToRgb565, 3, 2, level)
+			->Arg(320 * 240)->Arg(800 * 480);
+		benchmark::RegisterBenchmark(("Kernel/bgrToRgb888/" + suffix).c_str(), BM_Kernel, &PixelKernels::bgrToRgb888, 3, 3, level)
+			->Arg(320 * 240)->Arg(800 * 480);
+	}
+
+	for (const auto& profile : deviceProfiles())
+	{
+		const std::string name = profile.name;
+		for (const auto& file : samplesFor(name))
+		{
+			benchmark::RegisterBenchmark(("Transform/" + name + "/" + file).c_str(), BM_Transform, profile.helper, file)->Unit(benchmark::kMicrosecond);
+			benchmark::RegisterBenchmark(("Encode/" + name + "/" + file).c_str(), BM_Encode, profile.helper, file, false)->Unit(benchmark::kMicrosecond);
+			benchmark::RegisterBenchmark(("EncodeCachedDecode/" + name + "/" + file).c_str(), BM_Encode, profile.helper, file, true)->Unit(benchmark::kMicrosecond);
+		}
+		if (name.find("background") == std::string::npos)
+			benchmark::RegisterBenchmark(("GifFrames/" + name + "/test.gif").c_str(), BM_GifFrames, profile.helper, std::string("test.gif"))->Unit(benchmark::kMillisecond);
+	}
+}
+}
+
+int main(int argc, char** argv)
+{
+	// Default to JSON so results can be diffed between runs; explicit flags win
+	std::vector<char*> args(argv, argv + argc);
+	bool formatGiven = false;
+	for (int i = 1; i < argc; ++i)
+		formatGiven = formatGiven || std::strncmp(argv[i], "--benchmark_format", 18) == 0;
+	static char jsonFormat[] = "--benchmark_format=json";
+	if (!formatGiven)
+		args.push_back(jsonFormat);
+	int count = static_cast<int>(args.size());
+
+	registerBenchmarks();
+	benchmark::Initialize(&count, args.data());
+	if (benchmark::ReportUnrecognizedArguments(count, args.data()))
+		return 1;
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
@@ -4,15 +4,17 @@
 #include <iostream>
 
 int main() {
-    Gif2ImgFrame gif("234.gif", new OpenCVImageEncoder);
+    Gif2ImgFrame gif("234.gif", std::make_shared<OpenCVImageEncoder>());
 
     if (!gif.isValid()) {
         std::cerr << "Failed to load" << std::endl;
         return 1;
     }
 
-    gif.saveFramesToFiles("out_png", ImgType::JPG);
-    auto data = gif.encodeFramesToMemory(ImgType::JPG, 90);
+    ImgHelper jpegHelper;
+    jpegHelper._imgType = ImgType::JPG;
+    gif.saveFramesToFiles("out_png", 90, jpegHelper);
+    auto data = gif.encodeFramesToMemory(90, jpegHelper);
 
     for (size_t i = 0; i < data.size(); ++i){
          std::cout << "Frame " << i << ": " << data[i].size() << " bytes" << std::endl;
@@ -0,0 +1,166 @@
+#include "BufferPool.h"
+#include <algorithm>
+#include <array>
+
+namespace
+{
+struct MatEntry
+{
+	MatSlot slot;
+	int rows;
+	int cols;
+	int type;
+	uint64_t lastUse;
+	cv::Mat mat;
+};
+
+struct ThreadArena
+{
+	std::vector<MatEntry> mats;
+	std::array<cv::Mat, static_cast<size_t>(MatSlot::Count)> slotMats;
+	std::array<std::vector<uint8_t>, static_cast<size_t>(ByteSlot::Count)> bytes;
+	uint64_t clock = 0;
+};
+
+ThreadArena& localArena()
+{
+	thread_local ThreadArena arena;
+	return arena;
+}
+}
+
+std::atomic<uint64_t> BufferPool::_matAllocations{ 0 };
+std::atomic<uint64_t> BufferPool::_matReuses{ 0 };
+std::atomic<uint64_t> BufferPool::_byteAllocations{ 0 };
+std::atomic<uint64_t> BufferPool::_byteReuses{ 0 };
+std::atomic<uint64_t> BufferPool::_canvasAllocations{ 0 };
+std::atomic<uint64_t> BufferPool::_canvasReuses{ 0 };
+std::mutex BufferPool::_canvasMutex;
+std::vector<std::shared_ptr<RawCanvas>> BufferPool::_canvasPool;
+size_t BufferPool::_canvasPoolBytes = 0;
+
+cv::Mat BufferPool::acquireMat(MatSlot slot, int rows, int cols, int type)
+{
+	ThreadArena& arena = localArena();
+	if (arena.mats.capacity() < MAX_MATS_PER_THREAD)
+		arena.mats.reserve(MAX_MATS_PER_THREAD);
+	++arena.clock;
+	for (auto& entry : arena.mats)
+	{
+		if (entry.slot == slot && entry.rows == rows && entry.cols == cols && entry.type == type)
+		{
+			entry.lastUse = arena.clock;
+			_matReuses.fetch_add(1, std::memory_order_relaxed);
+			return entry.mat;
+		}
+	}
+
+	// Miss: evict the least recently used entry once the arena is full
+	if (arena.mats.size() >= MAX_MATS_PER_THREAD)
+	{
+		auto oldest = std::min_element(arena.mats.begin(), arena.mats.end(),
+			[](const MatEntry& a, const MatEntry& b) { return a.lastUse < b.lastUse; });
+		arena.mats.erase(oldest);
+	}
+	arena.mats.push_back(MatEntry{ slot, rows, cols, type, arena.clock, cv::Mat(rows, cols, type) });
+	_matAllocations.fetch_add(1, std::memory_order_relaxed);
+	return arena.mats.back().mat;
+}
+
+cv::Mat& BufferPool::slotMat(MatSlot slot)
+{
+	return localArena().slotMats[static_cast<size_t>(slot)];
+}
+
+void BufferPool::recordMat(bool allocated)
+{
+	if (allocated)
+		_matAllocations.fetch_add(1, std::memory_order_relaxed);
+	else
+		_matReuses.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<uint8_t>& BufferPool::acquireBytes(ByteSlot slot, size_t size)
+{
+	std::vector<uint8_t>& buffer = localArena().bytes[static_cast<size_t>(slot)];
+	if (size > buffer.capacity())
+		_byteAllocations.fetch_add(1, std::memory_order_relaxed);
+	else
+		_byteReuses.fetch_add(1, std::memory_order_relaxed);
+	buffer.resize(size);
+	return buffer;
+}
+
+std::shared_ptr<RawCanvas> BufferPool::copyCanvas(const RawCanvas& source)
+{
+	std::shared_ptr<RawCanvas> canvas;
+	{
+		std::lock_guard<std::mutex> lock(_canvasMutex);
+		for (const auto& pooled : _canvasPool)
+		{
+			// use_count() == 1: only the pool holds it, no worker is reading it
+			if (pooled.use_count() == 1 && pooled->width == source.width &&
+				pooled->height == source.height && pooled->alpha == source.alpha)
+			{
+				canvas = pooled;
+				break;
+			}
+		}
+		if (!canvas)
+		{
+			canvas = std::make_shared<RawCanvas>(source.width, source.height, source.alpha);
+			_canvasAllocations.fetch_add(1, std::memory_order_relaxed);
+			if (_canvasPoolBytes + canvas->pixels.size() <= MAX_CANVAS_POOL_BYTES)
+			{
+				_canvasPool.push_back(canvas);
+				_canvasPoolBytes += canvas->pixels.size();
+			}
+		}
+		else
+		{
+			_canvasReuses.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	std::copy(source.pixels.begin(), source.pixels.end(), canvas->pixels.begin());
+	return canvas;
+}
+
+BufferPoolStats BufferPool::stats()
+{
+	BufferPoolStats stats;
+	stats.matAllocations = _matAllocations.load(std::memory_order_relaxed);
+	stats.matReuses = _matReuses.load(std::memory_order_relaxed);
+	stats.byteAllocations = _byteAllocations.load(std::memory_order_relaxed);
+	stats.byteReuses = _byteReuses.load(std::memory_order_relaxed);
+	stats.canvasAllocations = _canvasAllocations.load(std::memory_order_relaxed);
+	stats.canvasReuses = _canvasReuses.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void BufferPool::resetStats()
+{
+	_matAllocations = 0;
+	_matReuses = 0;
+	_byteAllocations = 0;
+	_byteReuses = 0;
+	_canvasAllocations = 0;
+	_canvasReuses = 0;
+}
+
+void BufferPool::trim()
+{
+	ThreadArena& arena = localArena();
+	arena.mats.clear();
+	for (auto& mat : arena.slotMats)
+		mat.release();
+	for (auto& bytes : arena.bytes)
+		std::vector<uint8_t>().swap(bytes);
+
+	std::lock_guard<std::mutex> lock(_canvasMutex);
+	auto idle = std::remove_if(_canvasPool.begin(), _canvasPool.end(),
+		[](const std::shared_ptr<RawCanvas>& canvas) { return canvas.use_count() == 1; });
+	_canvasPool.erase(idle, _canvasPool.end());
+	_canvasPoolBytes = 0;
+	for (const auto& canvas : _canvasPool)
+		_canvasPoolBytes += canvas->pixels.size();
+}
@@ -0,0 +1,117 @@
+/**
+ * @file BufferPool.h
+ * @brief Reusable scratch buffers for the image encode pipeline.
+ *
+ * - Thread-local cv::Mat arena keyed by (slot, rows, cols, type)
+ * - Thread-local byte buffers keyed by slot
+ * - Process-wide RawCanvas pool for GIF frame snapshots handed to worker threads
+ *
+ * Buffers handed out by the thread-local arenas are only valid until the same
+ * slot is acquired again on the same thread, so they must not outlive the encode
+ * call that acquired them.
+ *
+ * Scope of the reuse (test/bufferpool_check.cpp holds the steady state to it):
+ * repeating setKeyImgFile() / setBackgroundImgFile() with the same sources reuses
+ * every Mat and byte buffer above, and the encoded bytes go to the transport from
+ * ByteSlot::Output without a copy. Still allocating on that path:
+ * - allocations inside OpenCV and the codecs (libjpeg, libpng, zlib)
+ * - a DecodeCache miss: the cache keeps its own copy of the decoded Mat
+ * - a FormatSelector decision miss: both candidates are decoded again to compare them
+ * - opening the source file (std::ifstream)
+ * - the StateJournal copy of the encoded bytes, when a journal is attached
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "RawCanvas.h"
+
+enum class MatSlot : uint8_t {
+	Decode,		// Decoded source image
+	Prepare,	// Alpha composite / channel conversion
+	Scaled,		// Pad: intermediate scaled image
+	Resize,		// Resize / pad target
+	Rotate,		// Rotation target
+	Flip,		// Flip target
+	Crop,		// Crop target
+	Contiguous,	// Continuous copy before raw conversion
+	Convert,	// Raw bitmap conversion
+	Count
+};
+
+enum class ByteSlot : uint8_t {
+	Input,		// Source image bytes
+	Output,		// Encoded image bytes
+	JpegCandidate,	// FormatSelector: JPEG candidate of a format decision
+	PngCandidate,	// FormatSelector: PNG candidate of a format decision
+	Count
+};
+
+struct BufferPoolStats
+{
+	uint64_t matAllocations = 0;
+	uint64_t matReuses = 0;
+	uint64_t byteAllocations = 0;
+	uint64_t byteReuses = 0;
+	uint64_t canvasAllocations = 0;
+	uint64_t canvasReuses = 0;
+};
+
+class BufferPool
+{
+public:
+	/**
+	 * @brief Get a Mat of the given shape from the calling thread's arena.
+	 * The contents are unspecified; the buffer is reused across calls with the same key.
+	 */
+	static cv::Mat acquireMat(MatSlot slot, int rows, int cols, int type);
+
+	/**
+	 * @brief Get the persistent Mat of a slot whose shape is not known up front (e.g. imdecode target).
+	 */
+	static cv::Mat& slotMat(MatSlot slot);
+
+	/**
+	 * @brief Record whether a slotMat() fill had to allocate.
+	 */
+	static void recordMat(bool allocated);
+
+	/**
+	 * @brief Get the calling thread's byte buffer for a slot, resized to size (capacity is kept).
+	 */
+	static std::vector<uint8_t>& acquireBytes(ByteSlot slot, size_t size = 0);
+
+	/**
+	 * @brief Copy a canvas into a pooled RawCanvas. The canvas returns to the pool when the last reference drops.
+	 */
+	static std::shared_ptr<RawCanvas> copyCanvas(const RawCanvas& source);
+
+	/**
+	 * @brief Allocation counters accumulated since start or the last resetStats().
+	 */
+	static BufferPoolStats stats();
+	static void resetStats();
+
+	/**
+	 * @brief Release the calling thread's arenas and every idle pooled canvas.
+	 */
+	static void trim();
+
+private:
+	static constexpr size_t MAX_MATS_PER_THREAD = 32;					///< Arena entries kept per thread.
+	static constexpr size_t MAX_CANVAS_POOL_BYTES = 32 * 1024 * 1024;	///< Pixel bytes retained by the canvas pool.
+
+	static std::atomic<uint64_t> _matAllocations;
+	static std::atomic<uint64_t> _matReuses;
+	static std::atomic<uint64_t> _byteAllocations;
+	static std::atomic<uint64_t> _byteReuses;
+	static std::atomic<uint64_t> _canvasAllocations;
+	static std::atomic<uint64_t> _canvasReuses;
+
+	static std::mutex _canvasMutex;
+	static std::vector<std::shared_ptr<RawCanvas>> _canvasPool;
+	static size_t _canvasPoolBytes;
+};
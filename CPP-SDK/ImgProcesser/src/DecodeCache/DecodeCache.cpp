@@ -0,0 +1,119 @@
+#include "DecodeCache.h"
+#include <cstring>
+
+std::mutex DecodeCache::_mutex;
+std::list<DecodeCache::Entry> DecodeCache::_lru;
+std::unordered_map<DecodeCache::Key, std::list<DecodeCache::Entry>::iterator, DecodeCache::KeyHash> DecodeCache::_index;
+size_t DecodeCache::_bytes = 0;
+size_t DecodeCache::_capacity = DecodeCache::DEFAULT_CAPACITY;
+uint64_t DecodeCache::_hits = 0;
+uint64_t DecodeCache::_misses = 0;
+uint64_t DecodeCache::_evictions = 0;
+
+cv::Mat DecodeCache::decode(const std::vector<uint8_t>& in)
+{
+	if (in.empty())
+		return cv::Mat();
+
+	const Key key{ hashBytes(in.data(), in.size()), in.size() };
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = _index.find(key);
+		if (it != _index.end() && std::memcmp(it->second->source.data(), in.data(), in.size()) == 0)
+		{
+			_lru.splice(_lru.begin(), _lru, it->second);
+			++_hits;
+			return it->second->mat;
+		}
+		++_misses;
+	}
+
+	// Decode outside the lock; concurrent misses on the same source both decode and the first insert wins
+	cv::Mat decoded = cv::imdecode(in, cv::IMREAD_UNCHANGED);
+	if (!decoded.empty())
+		insert(key, in, decoded);
+	return decoded;
+}
+
+void DecodeCache::setCapacity(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_capacity = bytes;
+	evictTo(_capacity);
+}
+
+size_t DecodeCache::capacity()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _capacity;
+}
+
+DecodeCacheStats DecodeCache::stats()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	DecodeCacheStats stats;
+	stats.hits = _hits;
+	stats.misses = _misses;
+	stats.evictions = _evictions;
+	stats.entries = _lru.size();
+	stats.bytes = _bytes;
+	stats.capacity = _capacity;
+	return stats;
+}
+
+void DecodeCache::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_index.clear();
+	_lru.clear();
+	_bytes = 0;
+}
+
+uint64_t DecodeCache::hashBytes(const uint8_t* data, size_t size)
+{
+	// FNV-1a over 64-bit words with a final avalanche; combined with the length in the key
+	constexpr uint64_t prime = 0x100000001B3ULL;
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		std::memcpy(&word, data + i, sizeof(word));
+		hash = (hash ^ word) * prime;
+		hash ^= hash >> 29;
+	}
+	for (; i < size; ++i)
+		hash = (hash ^ data[i]) * prime;
+
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+void DecodeCache::insert(const Key& key, const std::vector<uint8_t>& source, const cv::Mat& mat)
+{
+	const size_t bytes = mat.total() * mat.elemSize() + source.size();
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (bytes > _capacity || _index.count(key))
+		return; // Also keeps the first of two colliding sources; the other one is decoded on every use
+
+	evictTo(_capacity - bytes);
+	_lru.push_front(Entry{ key, source, mat, bytes });
+	_index.emplace(key, _lru.begin());
+	_bytes += bytes;
+}
+
+void DecodeCache::evictTo(size_t bytes)
+{
+	while (_bytes > bytes && !_lru.empty())
+	{
+		const Entry& oldest = _lru.back();
+		_bytes -= oldest.bytes;
+		_index.erase(oldest.key);
+		_lru.pop_back();
+		++_evictions;
+	}
+}
@@ -0,0 +1,85 @@
+/**
+ * @file DecodeCache.h
+ * @brief LRU cache of decoded source images, keyed by a hash of the encoded bytes.
+ *
+ * The same source is usually encoded for several targets (key, second screen,
+ * pressed variant, other device models). Caching the decoded cv::Mat lets that
+ * fan-out pay for cv::imdecode once. Encoded output is not cached here.
+ *
+ * Entries keep a copy of the source bytes and a hit compares them, so a hash
+ * collision is a miss rather than the wrong image.
+ *
+ * Cached Mats are shared and must be treated as read-only.
+ */
+#pragma once
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+struct DecodeCacheStats
+{
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+	uint64_t evictions = 0;
+	size_t entries = 0;
+	size_t bytes = 0;		///< Decoded pixel and source bytes currently held
+	size_t capacity = 0;	///< Byte cap
+};
+
+class DecodeCache
+{
+public:
+	static constexpr size_t DEFAULT_CAPACITY = 64 * 1024 * 1024;
+
+	/**
+	 * @brief Decode `in` with cv::IMREAD_UNCHANGED, or return the cached result of an earlier decode.
+	 * Returns an empty Mat if the bytes cannot be decoded; failures are not cached.
+	 */
+	static cv::Mat decode(const std::vector<uint8_t>& in);
+
+	/**
+	 * @brief Set the byte cap for decoded pixels plus source bytes. 0 disables the cache. Evicts down to the new cap.
+	 */
+	static void setCapacity(size_t bytes);
+	static size_t capacity();
+
+	static DecodeCacheStats stats();
+	static void clear();
+
+	/// 64-bit content hash used for the cache key; also keys other per-source caches.
+	static uint64_t hashBytes(const uint8_t* data, size_t size);
+
+private:
+	struct Key
+	{
+		uint64_t hash;
+		size_t size;
+		bool operator==(const Key& other) const { return hash == other.hash && size == other.size; }
+	};
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const { return static_cast<size_t>(key.hash ^ (key.size * 0x9E3779B97F4A7C15ULL)); }
+	};
+	struct Entry
+	{
+		Key key;
+		std::vector<uint8_t> source;	///< Encoded bytes the Mat was decoded from; compared on every hit
+		cv::Mat mat;
+		size_t bytes;
+	};
+
+	static void insert(const Key& key, const std::vector<uint8_t>& source, const cv::Mat& mat);
+	static void evictTo(size_t bytes);
+
+	static std::mutex _mutex;
+	static std::list<Entry> _lru;	///< Front is most recently used
+	static std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> _index;
+	static size_t _bytes;
+	static size_t _capacity;
+	static uint64_t _hits;
+	static uint64_t _misses;
+	static uint64_t _evictions;
+};
@@ -0,0 +1,195 @@
+#include "FormatSelector.h"
+#include <cstring>
+#include <opencv2/opencv.hpp>
+#include "BufferPool.h"
+#include "DecodeCache.h"
+#include "PixelKernels.h"
+
+std::mutex FormatSelector::_mutex;
+std::list<std::pair<uint64_t, ImgType>> FormatSelector::_lru;
+std::unordered_map<uint64_t, std::list<std::pair<uint64_t, ImgType>>::iterator> FormatSelector::_index;
+double FormatSelector::_minJpegPsnr = FormatSelector::DEFAULT_MIN_JPEG_PSNR;
+FormatSelectorStats FormatSelector::_stats;
+
+namespace
+{
+inline uint64_t mix(uint64_t hash, uint64_t value)
+{
+	return hash ^ (value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2));
+}
+
+/// Everything that changes the encoded result: source bytes, geometry, quality and PNG strategy.
+uint64_t decisionKey(const std::vector<uint8_t>& in, int quality, const ImgHelper& imgHelper, bool keepAlpha)
+{
+	uint64_t angleBits = 0;
+	std::memcpy(&angleBits, &imgHelper._rotateAngle, sizeof(angleBits));
+	uint64_t errorBits = 0;
+	std::memcpy(&errorBits, &imgHelper._pngOptions.maxMeanError, sizeof(errorBits));
+
+	uint64_t hash = DecodeCache::hashBytes(in.data(), in.size());
+	hash = mix(hash, in.size());
+	hash = mix(hash, static_cast<uint64_t>(imgHelper._width) << 32 | imgHelper._height);
+	hash = mix(hash, static_cast<uint64_t>(static_cast<uint32_t>(imgHelper._crop_offset_x)) << 32 | static_cast<uint32_t>(imgHelper._crop_offset_y));
+	hash = mix(hash, angleBits);
+	hash = mix(hash, static_cast<uint64_t>(imgHelper._resizeOption) | static_cast<uint64_t>(imgHelper._processer) << 8 |
+		static_cast<uint64_t>(imgHelper._flipVertical) << 16 | static_cast<uint64_t>(imgHelper._flipHorizonal) << 17 |
+		static_cast<uint64_t>(keepAlpha) << 18);
+	hash = mix(hash, static_cast<uint64_t>(quality));
+	hash = mix(hash, static_cast<uint64_t>(imgHelper._pngOptions.palette) | static_cast<uint64_t>(imgHelper._pngOptions.filter) << 8 |
+		static_cast<uint64_t>(imgHelper._pngOptions.compressionLevel) << 16 | static_cast<uint64_t>(imgHelper._pngOptions.maxColors) << 32);
+	return mix(hash, errorBits);
+}
+
+bool hasTransparency(const cv::Mat& image)
+{
+	if (image.channels() != 4)
+		return false;
+	cv::Mat alpha;
+	cv::extractChannel(image, alpha, 3);
+	double minAlpha = 255.0;
+	cv::minMaxLoc(alpha, &minAlpha);
+	return minAlpha < 255.0;
+}
+}
+
+bool FormatSelector::encode(const IImageEncoder& encoder, std::vector<uint8_t>& out, const std::vector<uint8_t>& in,
+	int quality, const ImgHelper& imgHelper, bool keepAlpha, ImgType* chosen)
+{
+	ImgHelper jpegHelper = imgHelper;
+	jpegHelper._imgType = ImgType::JPG;
+	ImgHelper pngHelper = imgHelper;
+	pngHelper._imgType = ImgType::PNG;
+
+	const uint64_t key = decisionKey(in, quality, imgHelper, keepAlpha);
+	ImgType type = ImgType::JPG;
+	if (lookup(key, type))
+	{
+		const bool ok = encoder.encodeToMemory(out, in, quality, type == ImgType::PNG ? pngHelper : jpegHelper);
+		if (ok && chosen)
+			*chosen = type;
+		return ok;
+	}
+
+	// Encode both formats one after the other on this thread, into its pooled candidate buffers: the second
+	// encode reuses the decoded source and scratch Mats of the first, and nothing is allocated per decision
+	auto& jpeg = BufferPool::acquireBytes(ByteSlot::JpegCandidate);
+	const bool jpegOk = encoder.encodeToMemory(jpeg, in, quality, jpegHelper);
+	auto& png = BufferPool::acquireBytes(ByteSlot::PngCandidate);
+	const bool pngOk = encoder.encodeToMemory(png, in, quality, pngHelper);
+	if (!jpegOk && !pngOk)
+		return false;
+
+	if (!pngOk)
+		type = ImgType::JPG;
+	else if (!jpegOk)
+		type = ImgType::PNG;
+	else
+		type = decide(jpeg, png, keepAlpha);
+
+	// Only a decision made with both candidates is worth remembering
+	if (jpegOk && pngOk)
+		remember(key, type);
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		++(type == ImgType::PNG ? _stats.png : _stats.jpeg);
+	}
+	const auto& winner = type == ImgType::PNG ? png : jpeg;
+	out.assign(winner.begin(), winner.end()); // Copy rather than swap: `out` (usually ByteSlot::Output) keeps its capacity
+	if (chosen)
+		*chosen = type;
+	return true;
+}
+
+ImgType FormatSelector::decide(const std::vector<uint8_t>& jpeg, const std::vector<uint8_t>& png, bool keepAlpha)
+{
+	cv::Mat pngImage = cv::imdecode(png, cv::IMREAD_UNCHANGED);
+	if (pngImage.empty())
+		return ImgType::JPG;
+	if (keepAlpha && hasTransparency(pngImage))
+		return ImgType::PNG;
+	if (png.size() <= jpeg.size())
+		return ImgType::PNG;
+
+	// JPEG is smaller: accept it only if it stays close to what the PNG would show (transparency composited to black)
+	cv::Mat jpegImage = cv::imdecode(jpeg, cv::IMREAD_COLOR);
+	cv::Mat reference = pngImage;
+	if (pngImage.type() == CV_8UC4 && pngImage.isContinuous())
+	{
+		reference.create(pngImage.rows, pngImage.cols, CV_8UC3);
+		PixelKernels::premultiplyToBlack(pngImage.ptr<uint8_t>(), reference.ptr<uint8_t>(), pngImage.total());
+	}
+	else if (pngImage.channels() != 3)
+	{
+		cv::cvtColor(pngImage, reference, pngImage.channels() == 4 ? cv::COLOR_BGRA2BGR : cv::COLOR_GRAY2BGR);
+	}
+	if (jpegImage.empty() || jpegImage.size() != reference.size() || jpegImage.type() != reference.type())
+		return ImgType::PNG;
+	return cv::PSNR(jpegImage, reference) >= minJpegPsnr() ? ImgType::JPG : ImgType::PNG;
+}
+
+bool FormatSelector::lookup(uint64_t key, ImgType& type)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _index.find(key);
+	if (it == _index.end())
+	{
+		++_stats.misses;
+		return false;
+	}
+	_lru.splice(_lru.begin(), _lru, it->second);
+	type = it->second->second;
+	++_stats.hits;
+	++(type == ImgType::PNG ? _stats.png : _stats.jpeg);
+	return true;
+}
+
+void FormatSelector::remember(uint64_t key, ImgType type)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _index.find(key);
+	if (it != _index.end())
+	{
+		it->second->second = type;
+		_lru.splice(_lru.begin(), _lru, it->second);
+		return;
+	}
+	_lru.emplace_front(key, type);
+	_index.emplace(key, _lru.begin());
+	if (_lru.size() > MAX_DECISIONS)
+	{
+		_index.erase(_lru.back().first);
+		_lru.pop_back();
+	}
+}
+
+void FormatSelector::setMinJpegPsnr(double psnr)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (psnr != _minJpegPsnr)
+	{
+		// Earlier decisions were made against the old bound
+		_minJpegPsnr = psnr;
+		_index.clear();
+		_lru.clear();
+	}
+}
+
+double FormatSelector::minJpegPsnr()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _minJpegPsnr;
+}
+
+FormatSelectorStats FormatSelector::stats()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _stats;
+}
+
+void FormatSelector::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_index.clear();
+	_lru.clear();
+	_stats = FormatSelectorStats();
+}
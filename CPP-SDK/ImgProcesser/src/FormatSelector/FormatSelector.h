@@ -0,0 +1,58 @@
+/**
+ * @file FormatSelector.h
+ * @brief Per-image JPEG vs PNG choice for devices whose keys accept either stream.
+ *
+ * On the first encode of a source, both formats are encoded (one after the other,
+ * into the calling thread's pooled candidate buffers) and the smaller one is kept, with JPEG only accepted when its PSNR against the PNG
+ * rendering (composited to black) reaches the configured bound. Images whose
+ * transparency must be kept always use PNG. The decision is cached per source
+ * content + helper + quality, so later sends of the same image encode once.
+ */
+#pragma once
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "IImageEncoder.h"
+
+struct FormatSelectorStats
+{
+	uint64_t hits = 0;		///< Decisions served from the cache
+	uint64_t misses = 0;	///< Decisions made by encoding both formats
+	uint64_t jpeg = 0;		///< Sends that used JPEG
+	uint64_t png = 0;		///< Sends that used PNG
+};
+
+class FormatSelector
+{
+public:
+	static constexpr double DEFAULT_MIN_JPEG_PSNR = 38.0;
+	static constexpr size_t MAX_DECISIONS = 4096;
+
+	/**
+	 * @brief Encode `in` for `imgHelper` as JPEG or PNG, whichever is smaller within the quality bound.
+	 * @param keepAlpha Force PNG when the image has transparent pixels (device shows transparent icons).
+	 * @param chosen Optional: receives the format that was sent.
+	 */
+	static bool encode(const IImageEncoder& encoder, std::vector<uint8_t>& out, const std::vector<uint8_t>& in,
+		int quality, const ImgHelper& imgHelper, bool keepAlpha, ImgType* chosen = nullptr);
+
+	/// Lowest PSNR (dB) at which JPEG is accepted over a larger PNG.
+	static void setMinJpegPsnr(double psnr);
+	static double minJpegPsnr();
+
+	static FormatSelectorStats stats();
+	static void clear();
+
+private:
+	static ImgType decide(const std::vector<uint8_t>& jpeg, const std::vector<uint8_t>& png, bool keepAlpha);
+	static bool lookup(uint64_t key, ImgType& type);
+	static void remember(uint64_t key, ImgType type);
+
+	static std::mutex _mutex;
+	static std::list<std::pair<uint64_t, ImgType>> _lru;	///< Front is most recently used
+	static std::unordered_map<uint64_t, std::list<std::pair<uint64_t, ImgType>>::iterator> _index;
+	static double _minJpegPsnr;
+	static FormatSelectorStats _stats;
+};
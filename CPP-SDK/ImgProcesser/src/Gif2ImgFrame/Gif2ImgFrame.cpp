@@ -7,6 +7,7 @@
 #include <chrono>
 #include <iostream>
 #include "ThreadPool.h"
+#include "BufferPool.h"
 
 #define DEFAULT_DISPOSAL_MODE DISPOSE_DO_NOT
 #define FIRST_FRAME_DISPOSAL_MODE DISPOSE_DO_NOT
@@ -54,8 +55,6 @@ struct Gif2ImgFrame::Impl
 		GraphicsControlBlock gcb{};
 		DGifSavedExtensionToGCB(gif, i, &gcb);
 
-		std::vector<uint8_t> backup = canvas.pixels; // Used for DISPOSE_PREVIOUS
-
 		if (frameDisposalMode == DISPOSE_BACKGROUND)
 		{
 			for (int y = 0; y < desc.Height; ++y)
@@ -71,10 +70,7 @@ struct Gif2ImgFrame::Impl
 				}
 			}
 		}
-		else if (frameDisposalMode == DISPOSE_PREVIOUS)
-		{
-			canvas.pixels.swap(backup);
-		}
+		// DISPOSE_PREVIOUS keeps the canvas as is; it used to swap in a fresh copy of itself every frame
 
 		for (int y = 0; y < desc.Height; ++y)
 		{
@@ -200,7 +196,7 @@ std::vector<std::vector<uint8_t>> Gif2ImgFrame::encodeFramesToMemory(int quality
 			frameDisposalMode = FIRST_FRAME_DISPOSAL_MODE;
 		}
 		impl_->renderFrameRaw(i, canvas, frameDisposalMode);
-		auto frameCopy = std::make_shared<RawCanvas>(canvas);
+		auto frameCopy = BufferPool::copyCanvas(canvas);
 
 		futures.emplace_back(pool.enqueue([&, i, frameCopy]()
 										  { _encoder->encodeToMemory(result[i], *frameCopy, quality, imgHelper); }));
@@ -291,7 +287,7 @@ std::vector<GifFrameData> Gif2ImgFrame::encodeFramesWithDelay(int quality, const
 		}
 
 		impl_->renderFrameRaw(i, canvas, frameDisposalMode);
-		auto frameCopy = std::make_shared<RawCanvas>(canvas);
+		auto frameCopy = BufferPool::copyCanvas(canvas);
 
 		futures.emplace_back(pool.enqueue([&, i, frameCopy]()
 										  {
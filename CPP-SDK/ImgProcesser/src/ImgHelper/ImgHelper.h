@@ -12,6 +12,44 @@ enum class ResizeOption : uint8_t {
 	Pad,// Pad
 };
 
+enum class PngPalette : uint8_t {
+	None,// Truecolor (24/32-bit)
+	MedianCut,// Median-cut quantisation to an 8-bit palette
+	Octree,// Octree quantisation to an 8-bit palette
+};
+
+enum class PngFilter : uint8_t {
+	Default,// Encoder default (None for palette images)
+	None,
+	Sub,
+	Up,
+	Average,
+	Paeth,
+	Adaptive,// Per-row choice of the five filters
+};
+
+/// PNG encode strategy. The defaults reproduce the plain truecolor, zlib level 3 output.
+struct PngOptions
+{
+	PngPalette palette = PngPalette::None;
+	PngFilter filter = PngFilter::Default;
+	int compressionLevel = 3;// zlib level 0-9
+	uint16_t maxColors = 256;// Palette size cap, 2-256
+	double maxMeanError = 2.0;// Largest mean per-channel error (0-255) accepted for a palette; above it truecolor is used
+
+	bool operator==(const PngOptions& other) const {
+		return palette == other.palette &&
+			filter == other.filter &&
+			compressionLevel == other.compressionLevel &&
+			maxColors == other.maxColors &&
+			maxMeanError == other.maxMeanError;
+	}
+
+	bool operator!=(const PngOptions& other) const {
+		return !(*this == other);
+	}
+};
+
 class ImgHelper
 {
 public:
@@ -37,7 +75,8 @@ public:
 			_flipVertical == other._flipVertical &&
 			_flipHorizonal == other._flipHorizonal &&
 			_imgType == other._imgType &&
-			_imgFormat == other._imgFormat;
+			_imgFormat == other._imgFormat &&
+			_pngOptions == other._pngOptions;
 	}
 
 	bool operator!=(const ImgHelper& other) const {
@@ -56,4 +95,5 @@ public:
 	ImgType _imgType = ImgType::JPG;
 	ImgFormat _imgFormat = ImgFormat::BGR888;
 	ImgProcess _processer = ImgProcess::Resize;
+	PngOptions _pngOptions{};
 };
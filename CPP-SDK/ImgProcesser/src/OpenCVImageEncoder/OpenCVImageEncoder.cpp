@@ -1,4 +1,9 @@
 #include "OpenCVImageEncoder.h"
+#include "BufferPool.h"
+#include "DecodeCache.h"
+#include "PixelKernels.h"
+#include "PngQuantizer.h"
+#include <fstream>
 
 namespace
 {
@@ -7,22 +12,18 @@ cv::Mat compositeAlphaToBlack(const cv::Mat& input)
 	if (input.empty() || input.channels() != 4)
 		return input;
 
-	cv::Mat output(input.rows, input.cols, CV_8UC3);
-	for (int y = 0; y < input.rows; ++y)
+	cv::Mat output = BufferPool::acquireMat(MatSlot::Prepare, input.rows, input.cols, CV_8UC3);
+	if (input.isContinuous())
 	{
-		const cv::Vec4b* src = input.ptr<cv::Vec4b>(y);
-		cv::Vec3b* dst = output.ptr<cv::Vec3b>(y);
-		for (int x = 0; x < input.cols; ++x)
-		{
-			const int alpha = src[x][3];
-			dst[x][0] = static_cast<uint8_t>((static_cast<int>(src[x][0]) * alpha + 127) / 255);
-			dst[x][1] = static_cast<uint8_t>((static_cast<int>(src[x][1]) * alpha + 127) / 255);
-			dst[x][2] = static_cast<uint8_t>((static_cast<int>(src[x][2]) * alpha + 127) / 255);
-		}
+		PixelKernels::premultiplyToBlack(input.ptr<uint8_t>(), output.ptr<uint8_t>(), input.total());
+		return output;
 	}
+	for (int y = 0; y < input.rows; ++y)
+		PixelKernels::premultiplyToBlack(input.ptr<uint8_t>(y), output.ptr<uint8_t>(y), static_cast<size_t>(input.cols));
 	return output;
 }
 
+/// The later stages never write into their input, so no defensive copy is made here.
 cv::Mat prepareForOutput(const cv::Mat& input, ImgType targetType)
 {
 	if (input.empty())
@@ -31,18 +32,56 @@ cv::Mat prepareForOutput(const cv::Mat& input, ImgType targetType)
 	if (input.channels() == 4)
 	{
 		if (IImageEncoder::supportsAlpha(targetType))
-			return input.clone();
+			return input;
 		return compositeAlphaToBlack(input);
 	}
 
 	if (input.channels() == 1 && !IImageEncoder::supportsAlpha(targetType))
 	{
-		cv::Mat bgr;
+		cv::Mat bgr = BufferPool::acquireMat(MatSlot::Prepare, input.rows, input.cols, CV_8UC3);
 		cv::cvtColor(input, bgr, cv::COLOR_GRAY2BGR);
 		return bgr;
 	}
 
-	return input.clone();
+	return input;
+}
+
+/// Decode through the shared decode cache so one source fanned out to several targets decodes once.
+/// With the cache disabled, decode into the calling thread's decode slot instead.
+cv::Mat decodeSource(const std::vector<uint8_t>& in)
+{
+	if (DecodeCache::capacity() > 0)
+		return DecodeCache::decode(in);
+
+	cv::Mat& target = BufferPool::slotMat(MatSlot::Decode);
+	const uchar* previous = target.datastart;
+	cv::Mat decoded = cv::imdecode(in, cv::IMREAD_UNCHANGED, &target);
+	if (!decoded.empty())
+		BufferPool::recordMat(target.datastart != previous);
+	return decoded;
+}
+
+/// Fill a per-thread parameter vector so encoding does not allocate one per call.
+const std::vector<int>& pooledEncodeParams(ImgType type, int quality, const PngOptions& png = PngOptions())
+{
+	thread_local std::vector<int> params;
+	OpenCVImageEncoder::imgEncodeParams(type, quality, params, png);
+	return params;
+}
+
+/// Palette PNG: quantise, and when the result is within options.maxMeanError write it as an indexed PNG.
+/// Builds without zlib encode the quantised pixels as truecolor instead, which still compresses far better.
+bool encodePalettePng(std::vector<uint8_t>& out, const cv::Mat& input, const PngOptions& options)
+{
+	IndexedImage indexed;
+	if (!PngQuantizer::quantize(input, options.palette, options.maxColors, indexed) || indexed.meanError > options.maxMeanError)
+		return false;
+	if (PngQuantizer::writeIndexedPng(indexed, options, out))
+		return true;
+
+	cv::Mat quantized = BufferPool::acquireMat(MatSlot::Convert, input.rows, input.cols, input.type());
+	PngQuantizer::toMat(indexed, quantized, input.channels() == 4);
+	return cv::imencode(".png", quantized, out, pooledEncodeParams(ImgType::PNG, 0, options));
 }
 }
 
@@ -57,61 +96,12 @@ bool OpenCVImageEncoder::encodeToFile(const std::string& filename,
 
 	// Default parameters: write directly
 	if (imgHelper == ImgHelper())
-		return cv::imwrite(filename, input, imgEncodeParams(ImgType::JPG, quality));
-
-	// Extract parameters
-	int32_t crop_offset_x = static_cast<int32_t>(imgHelper._crop_offset_x);
-	int32_t crop_offset_y = static_cast<int32_t>(imgHelper._crop_offset_y);
-	uint32_t targetWidth = imgHelper._width;
-	uint32_t targetHeight = imgHelper._height;
-	double angle = imgHelper._rotateAngle;
-	bool flipV = imgHelper._flipVertical;
-	bool flipH = imgHelper._flipHorizonal;
-	ResizeOption resizeOpt = imgHelper._resizeOption;
-
-	cv::Mat processed;
-
-	// Determine crop or scale
-	if (imgHelper._processer == ImgProcess::Crop && (crop_offset_x >= 0 && crop_offset_y >= 0 && targetWidth > 0 && targetHeight > 0)) {
-		// Crop first if crop parameters exist
-		crop(input, crop_offset_x, crop_offset_y, targetWidth, targetHeight);
-		processed = input;
-	}
-	else if (imgHelper._processer == ImgProcess::Resize && (targetWidth > 0 && targetHeight > 0)) {
-		// Otherwise scale or pad
-		if (resizeOpt == ResizeOption::Scale) {
-			cv::resize(input, processed, cv::Size(targetWidth, targetHeight), 0, 0, cv::INTER_AREA);
-		}
-		else if (resizeOpt == ResizeOption::Pad) {
-			double scale = std::min(
-				static_cast<double>(targetWidth) / input.cols,
-				static_cast<double>(targetHeight) / input.rows
-			);
-			cv::Mat scaled;
-			cv::resize(input, scaled, cv::Size(), scale, scale, cv::INTER_AREA);
-
-			int top = (targetHeight - scaled.rows) / 2;
-			int bottom = targetHeight - scaled.rows - top;
-			int left = (targetWidth - scaled.cols) / 2;
-			int right = targetWidth - scaled.cols - left;
-
-			cv::copyMakeBorder(scaled, processed, top, bottom, left, right, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
-		}
-		else {
-			processed = input.clone(); // fallback
-		}
-	}
-	else {
-		// Fallback to original image
-		processed = input.clone();
-	}
+		return cv::imwrite(filename, input, pooledEncodeParams(ImgType::JPG, quality));
 
-	// Rotate & flip
-	rotate(processed, angle);
-	flip(processed, flipH, flipV);
+	cv::Mat processed = transform(input, imgHelper, true);
 
 	// Write file
-	return cv::imwrite(filename, processed, imgEncodeParams(imgHelper._imgType, quality));
+	return writeMat(filename, processed, quality, imgHelper);
 }
 
 
@@ -125,61 +115,12 @@ bool OpenCVImageEncoder::encodeToMemory(std::vector<uint8_t>& out,
 	if (input.empty()) return false;
 
 	if (imgHelper == ImgHelper())
-		return cv::imencode(imgTypeToExt(ImgType::JPG), input, out, imgEncodeParams(ImgType::JPG, quality));
+		return cv::imencode(imgTypeToExt(ImgType::JPG), input, out, pooledEncodeParams(ImgType::JPG, quality));
 
-	// Get parameters
-	int32_t crop_offset_x = static_cast<int32_t>(imgHelper._crop_offset_x);
-	int32_t crop_offset_y = static_cast<int32_t>(imgHelper._crop_offset_y);
-	uint32_t targetWidth = imgHelper._width;
-	uint32_t targetHeight = imgHelper._height;
-	double angle = imgHelper._rotateAngle;
-	bool flipV = imgHelper._flipVertical;
-	bool flipH = imgHelper._flipHorizonal;
-	ResizeOption resizeOpt = imgHelper._resizeOption;
-
-	cv::Mat processed;
-
-	// Determine whether to crop or scale/pad
-	if (imgHelper._processer == ImgProcess::Crop && (crop_offset_x >= 0 && crop_offset_y >= 0 && targetWidth > 0 && targetHeight > 0)) {
-		// Crop area not empty -> crop
-		crop(input, crop_offset_x, crop_offset_y, targetWidth, targetHeight);
-		processed = input;
-	}
-	else if (imgHelper._processer == ImgProcess::Resize && (targetWidth > 0 && targetHeight > 0)) {
-		// No crop offset -> resize
-		if (resizeOpt == ResizeOption::Scale) {
-			cv::resize(input, processed, cv::Size(targetWidth, targetHeight), 0, 0, cv::INTER_AREA);
-		}
-		else if (resizeOpt == ResizeOption::Pad) {
-			double scale = std::min(
-				static_cast<double>(targetWidth) / input.cols,
-				static_cast<double>(targetHeight) / input.rows
-			);
-			cv::Mat scaled;
-			cv::resize(input, scaled, cv::Size(), scale, scale, cv::INTER_AREA);
-
-			int top = (targetHeight - scaled.rows) / 2;
-			int bottom = targetHeight - scaled.rows - top;
-			int left = (targetWidth - scaled.cols) / 2;
-			int right = targetWidth - scaled.cols - left;
-
-			cv::copyMakeBorder(scaled, processed, top, bottom, left, right, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
-		}
-		else {
-			processed = input.clone(); // fallback
-		}
-	}
-	else {
-		// fallback to original
-		processed = input.clone();
-	}
-
-	// Apply rotation & flip
-	rotate(processed, angle);
-	flip(processed, flipH, flipV);
+	cv::Mat processed = transform(input, imgHelper, true);
 
 	// Encode to image byte stream
-	return cv::imencode(imgTypeToExt(imgHelper._imgType), processed, out, imgEncodeParams(imgHelper._imgType, quality));
+	return encodeMat(out, processed, quality, imgHelper);
 }
 
 
@@ -189,46 +130,16 @@ bool OpenCVImageEncoder::encodeToFile(const std::string& filename,
 	const ImgHelper& imgHelper) const
 {
 	const ImgType targetType = imgHelper == ImgHelper() ? ImgType::JPG : imgHelper._imgType;
-	cv::Mat input = prepareForOutput(cv::imdecode(in, cv::IMREAD_UNCHANGED), targetType);
+	cv::Mat input = prepareForOutput(decodeSource(in), targetType);
 	if (input.empty()) return false;
 
 	// Reuse existing flow
 	if (imgHelper == ImgHelper())
-		return cv::imwrite(filename, input, imgEncodeParams(ImgType::JPG, quality));
+		return cv::imwrite(filename, input, pooledEncodeParams(ImgType::JPG, quality));
 
-	// Get parameters
-	uint32_t targetWidth = imgHelper._width;
-	uint32_t targetHeight = imgHelper._height;
-	double angle = imgHelper._rotateAngle;
-	bool flipV = imgHelper._flipVertical;
-	bool flipH = imgHelper._flipHorizonal;
-	ResizeOption resizeOpt = imgHelper._resizeOption;
+	cv::Mat resized = transform(input, imgHelper, false);
 
-	cv::Mat resized;
-	if (resizeOpt == ResizeOption::Scale) {
-		cv::resize(input, resized, cv::Size(targetWidth, targetHeight), 0, 0, cv::INTER_AREA);
-	}
-	else if (resizeOpt == ResizeOption::Pad) {
-		double scale = std::min(static_cast<double>(targetWidth) / input.cols,
-			static_cast<double>(targetHeight) / input.rows);
-		cv::Mat scaled;
-		cv::resize(input, scaled, cv::Size(), scale, scale, cv::INTER_AREA);
-
-		int top = (targetHeight - scaled.rows) / 2;
-		int bottom = targetHeight - scaled.rows - top;
-		int left = (targetWidth - scaled.cols) / 2;
-		int right = targetWidth - scaled.cols - left;
-
-		cv::copyMakeBorder(scaled, resized, top, bottom, left, right, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
-	}
-	else {
-		resized = input.clone();
-	}
-
-	rotate(resized, angle);
-	flip(resized, flipH, flipV);
-
-	return cv::imwrite(filename, resized, imgEncodeParams(imgHelper._imgType, quality));
+	return writeMat(filename, resized, quality, imgHelper);
 }
 
 bool OpenCVImageEncoder::encodeToMemory(std::vector<uint8_t>& out,
@@ -237,50 +148,19 @@ bool OpenCVImageEncoder::encodeToMemory(std::vector<uint8_t>& out,
 	const ImgHelper& imgHelper) const
 {
 	const ImgType targetType = imgHelper == ImgHelper() ? ImgType::JPG : imgHelper._imgType;
-	cv::Mat input = prepareForOutput(cv::imdecode(in, cv::IMREAD_UNCHANGED), targetType);
+	cv::Mat input = prepareForOutput(decodeSource(in), targetType);
 	if (input.empty()) return false;
 
 	if (imgHelper == ImgHelper())
-		return cv::imencode(imgTypeToExt(ImgType::JPG), input, out, imgEncodeParams(ImgType::JPG, quality));
+		return cv::imencode(imgTypeToExt(ImgType::JPG), input, out, pooledEncodeParams(ImgType::JPG, quality));
 
-	if (imgHelper._imgType == ImgType::RAW)   /// If raw data is needed, encodeToBitmap directly
-		return encodeToBitmap(out, in, imgHelper);
+	if (imgHelper._imgType == ImgType::RAW)   /// If raw data is needed, convert the already decoded source directly
+		return encodeMatToBitmap(out, input, imgHelper);
 
-	// Get parameters
-	uint32_t targetWidth = imgHelper._width;
-	uint32_t targetHeight = imgHelper._height;
-	double angle = imgHelper._rotateAngle;
-	bool flipV = imgHelper._flipVertical;
-	bool flipH = imgHelper._flipHorizonal;
-	ResizeOption resizeOpt = imgHelper._resizeOption;
-
-	cv::Mat resized;
-	if (resizeOpt == ResizeOption::Scale) {
-		cv::resize(input, resized, cv::Size(targetWidth, targetHeight), 0, 0, cv::INTER_AREA);
-	}
-	else if (resizeOpt == ResizeOption::Pad) {
-		double scale = std::min(static_cast<double>(targetWidth) / input.cols,
-			static_cast<double>(targetHeight) / input.rows);
-		cv::Mat scaled;
-		cv::resize(input, scaled, cv::Size(), scale, scale, cv::INTER_AREA);
-
-		int top = (targetHeight - scaled.rows) / 2;
-		int bottom = targetHeight - scaled.rows - top;
-		int left = (targetWidth - scaled.cols) / 2;
-		int right = targetWidth - scaled.cols - left;
-
-		cv::copyMakeBorder(scaled, resized, top, bottom, left, right, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
-	}
-	else {
-		resized = input.clone();
-	}
+	cv::Mat resized = transform(input, imgHelper, false);
 
-	rotate(resized, angle);
-	flip(resized, flipH, flipV);
-
-	return cv::imencode(imgTypeToExt(imgHelper._imgType), resized, out, imgEncodeParams(imgHelper._imgType, quality));
+	return encodeMat(out, resized, quality, imgHelper);
 }
-#include <fstream>
 
 bool saveToFile(const std::string& filename, const std::vector<uint8_t>& out)
 {
@@ -299,30 +179,86 @@ bool OpenCVImageEncoder::encodeToBitmap(std::vector<uint8_t>& out,
 	const std::vector<uint8_t>& in,
 	const ImgHelper& imgHelper) const
 {
-	cv::Mat input = prepareForOutput(cv::imdecode(in, cv::IMREAD_UNCHANGED), ImgType::RAW);
+	cv::Mat input = prepareForOutput(decodeSource(in), ImgType::RAW);
 
 	if (input.empty()) return false;
 
+	return encodeMatToBitmap(out, input, imgHelper);
+}
+
+bool OpenCVImageEncoder::encodeMat(std::vector<uint8_t>& out,
+	const cv::Mat& input,
+	int quality,
+	const ImgHelper& imgHelper) const
+{
+	const PngOptions& png = imgHelper._pngOptions;
+	if (imgHelper._imgType == ImgType::PNG && png.palette != PngPalette::None && encodePalettePng(out, input, png))
+		return true;
+	return cv::imencode(imgTypeToExt(imgHelper._imgType), input, out, pooledEncodeParams(imgHelper._imgType, quality, png));
+}
+
+bool OpenCVImageEncoder::writeMat(const std::string& filename,
+	const cv::Mat& input,
+	int quality,
+	const ImgHelper& imgHelper) const
+{
+	if (imgHelper._imgType == ImgType::PNG && imgHelper._pngOptions.palette != PngPalette::None)
+	{
+		std::vector<uint8_t> encoded;
+		return encodeMat(encoded, input, quality, imgHelper) && saveToFile(filename, encoded);
+	}
+	return cv::imwrite(filename, input, pooledEncodeParams(imgHelper._imgType, quality, imgHelper._pngOptions));
+}
+
+bool OpenCVImageEncoder::encodeMatToBitmap(std::vector<uint8_t>& out,
+	const cv::Mat& input,
+	const ImgHelper& imgHelper) const
+{
+	cv::Mat processed = imgHelper == ImgHelper() ? input : transform(input, imgHelper, false);
+
+	if (!processed.isContinuous()) {
+		cv::Mat contiguous = BufferPool::acquireMat(MatSlot::Contiguous, processed.rows, processed.cols, processed.type());
+		processed.copyTo(contiguous); // Ensure contiguous memory
+		processed = contiguous;
+	}
+
+	convertMatToRawBytes(processed, out, imgHelper._imgFormat);
+	return true;
+}
+
+cv::Mat OpenCVImageEncoder::transform(const cv::Mat& input, const ImgHelper& imgHelper, bool allowCrop) const
+{
+	// Extract parameters
+	int32_t crop_offset_x = static_cast<int32_t>(imgHelper._crop_offset_x);
+	int32_t crop_offset_y = static_cast<int32_t>(imgHelper._crop_offset_y);
+	uint32_t targetWidth = imgHelper._width;
+	uint32_t targetHeight = imgHelper._height;
+	double angle = imgHelper._rotateAngle;
+	bool flipV = imgHelper._flipVertical;
+	bool flipH = imgHelper._flipHorizonal;
+	ResizeOption resizeOpt = imgHelper._resizeOption;
+
 	cv::Mat processed;
 
-	if (imgHelper == ImgHelper()) {
+	// Determine crop or scale. Sources decoded from bytes always scale/pad.
+	if (allowCrop && imgHelper._processer == ImgProcess::Crop && (crop_offset_x >= 0 && crop_offset_y >= 0 && targetWidth > 0 && targetHeight > 0)) {
+		// Crop first if crop parameters exist
 		processed = input;
+		crop(processed, crop_offset_x, crop_offset_y, targetWidth, targetHeight);
 	}
-	else {
-		uint32_t targetWidth = imgHelper._width;
-		uint32_t targetHeight = imgHelper._height;
-		double angle = imgHelper._rotateAngle;
-		bool flipV = imgHelper._flipVertical;
-		bool flipH = imgHelper._flipHorizonal;
-		ResizeOption resizeOpt = imgHelper._resizeOption;
-
+	else if (!allowCrop || (imgHelper._processer == ImgProcess::Resize && (targetWidth > 0 && targetHeight > 0))) {
+		// Otherwise scale or pad
 		if (resizeOpt == ResizeOption::Scale) {
+			processed = BufferPool::acquireMat(MatSlot::Resize, targetHeight, targetWidth, input.type());
 			cv::resize(input, processed, cv::Size(targetWidth, targetHeight), 0, 0, cv::INTER_AREA);
 		}
 		else if (resizeOpt == ResizeOption::Pad) {
-			double scale = std::min(static_cast<double>(targetWidth) / input.cols,
-				static_cast<double>(targetHeight) / input.rows);
-			cv::Mat scaled;
+			double scale = std::min(
+				static_cast<double>(targetWidth) / input.cols,
+				static_cast<double>(targetHeight) / input.rows
+			);
+			// Pre-size the target with the same rounding cv::resize applies to a scale factor
+			cv::Mat scaled = BufferPool::acquireMat(MatSlot::Scaled, cvRound(input.rows * scale), cvRound(input.cols * scale), input.type());
 			cv::resize(input, scaled, cv::Size(), scale, scale, cv::INTER_AREA);
 
 			int top = (targetHeight - scaled.rows) / 2;
@@ -330,38 +266,60 @@ bool OpenCVImageEncoder::encodeToBitmap(std::vector<uint8_t>& out,
 			int left = (targetWidth - scaled.cols) / 2;
 			int right = targetWidth - scaled.cols - left;
 
-			cv::copyMakeBorder(scaled, processed, top, bottom, left, right,
-				cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
+			processed = BufferPool::acquireMat(MatSlot::Resize, targetHeight, targetWidth, input.type());
+			cv::copyMakeBorder(scaled, processed, top, bottom, left, right, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
 		}
 		else {
-			processed = input.clone();
+			processed = input; // fallback
 		}
-
-		rotate(processed, angle);
-		flip(processed, flipH, flipV);
 	}
-
-	if (!processed.isContinuous()) {
-		processed = processed.clone(); // Ensure contiguous memory
+	else {
+		// Fallback to original image
+		processed = input;
 	}
 
-	convertMatToRawBytes(processed, out, imgHelper._imgFormat);
-	return true;
+	// Rotate & flip
+	rotate(processed, angle);
+	flip(processed, flipH, flipV);
+	return processed;
 }
 
-
 std::vector<int> OpenCVImageEncoder::imgEncodeParams(ImgType type, int quality)
 {
+	std::vector<int> params;
+	imgEncodeParams(type, quality, params);
+	return params;
+}
+
+void OpenCVImageEncoder::imgEncodeParams(ImgType type, int quality, std::vector<int>& params, const PngOptions& png)
+{
+	params.clear();
 	switch (type)
 	{
 	case ImgType::JPG:
-		return { cv::IMWRITE_JPEG_QUALITY, quality };
+		params.insert(params.end(), { cv::IMWRITE_JPEG_QUALITY, quality });
+		break;
 	case ImgType::PNG:
-		return { cv::IMWRITE_PNG_COMPRESSION, 3 };
+		params.insert(params.end(), { cv::IMWRITE_PNG_COMPRESSION, std::clamp(png.compressionLevel, 0, 9) });
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 11)
+		// Row filter selection was added to the PNG writer in OpenCV 4.11
+		switch (png.filter)
+		{
+		case PngFilter::None: params.insert(params.end(), { cv::IMWRITE_PNG_FILTER, cv::IMWRITE_PNG_FILTER_NONE }); break;
+		case PngFilter::Sub: params.insert(params.end(), { cv::IMWRITE_PNG_FILTER, cv::IMWRITE_PNG_FILTER_SUB }); break;
+		case PngFilter::Up: params.insert(params.end(), { cv::IMWRITE_PNG_FILTER, cv::IMWRITE_PNG_FILTER_UP }); break;
+		case PngFilter::Average: params.insert(params.end(), { cv::IMWRITE_PNG_FILTER, cv::IMWRITE_PNG_FILTER_AVG }); break;
+		case PngFilter::Paeth: params.insert(params.end(), { cv::IMWRITE_PNG_FILTER, cv::IMWRITE_PNG_FILTER_PAETH }); break;
+		case PngFilter::Adaptive: params.insert(params.end(), { cv::IMWRITE_PNG_FILTER, cv::IMWRITE_PNG_ALL_FILTERS }); break;
+		default: break;
+		}
+#endif
+		break;
 	case ImgType::WEBP:
-		return { cv::IMWRITE_WEBP_QUALITY, quality };
+		params.insert(params.end(), { cv::IMWRITE_WEBP_QUALITY, quality });
+		break;
 	default:
-		return {};
+		break;
 	}
 }
 
@@ -373,24 +331,27 @@ void OpenCVImageEncoder::rotate(cv::Mat& mat, double angle) const
 	int normalizedAngle = static_cast<int>(angle) % 360;
 	if (normalizedAngle < 0) normalizedAngle += 360;
 
-	// Special-case multiples of 90°
-	if (normalizedAngle == 90) {
-		cv::rotate(mat, mat, cv::ROTATE_90_CLOCKWISE);
+	// An exact 0° rotation is the identity
+	if (normalizedAngle == 0 && angle == static_cast<int>(angle))
 		return;
-	}
-	else if (normalizedAngle == 180) {
-		cv::rotate(mat, mat, cv::ROTATE_180);
+
+	// Special-case multiples of 90°
+	if (normalizedAngle == 90 || normalizedAngle == 270) {
+		cv::Mat rotated = BufferPool::acquireMat(MatSlot::Rotate, mat.cols, mat.rows, mat.type());
+		cv::rotate(mat, rotated, normalizedAngle == 90 ? cv::ROTATE_90_CLOCKWISE : cv::ROTATE_90_COUNTERCLOCKWISE);
+		mat = rotated;
 		return;
 	}
-	else if (normalizedAngle == 270) {
-		cv::rotate(mat, mat, cv::ROTATE_90_COUNTERCLOCKWISE);
+	cv::Mat rotated = BufferPool::acquireMat(MatSlot::Rotate, mat.rows, mat.cols, mat.type());
+	if (normalizedAngle == 180) {
+		cv::rotate(mat, rotated, cv::ROTATE_180);
+		mat = rotated;
 		return;
 	}
 
 	// For general angles, use warpAffine and keep size unchanged
 	cv::Point2f center(mat.cols / 2.0f, mat.rows / 2.0f);
 	cv::Mat rotationMat = cv::getRotationMatrix2D(center, angle, 1.0);
-	cv::Mat rotated;
 	cv::warpAffine(mat, rotated, rotationMat, mat.size(), cv::INTER_LINEAR, cv::BORDER_REPLICATE);
 	mat = rotated;
 }
@@ -413,7 +374,7 @@ void OpenCVImageEncoder::flip(cv::Mat& mat, bool hflip, bool vflip) const
 		flipCode = 0;   // Vertical only
 	}
 
-	cv::Mat flipped;
+	cv::Mat flipped = BufferPool::acquireMat(MatSlot::Flip, mat.rows, mat.cols, mat.type());
 	cv::flip(mat, flipped, flipCode);
 	mat = flipped;
 }
@@ -439,7 +400,9 @@ void OpenCVImageEncoder::crop(cv::Mat& mat, uint32_t x, uint32_t y, uint32_t wid
 
 	// Crop
 	cv::Rect roi(x1, y1, w, h);
-	mat = mat(roi).clone();
+	cv::Mat cropped = BufferPool::acquireMat(MatSlot::Crop, h, w, mat.type());
+	mat(roi).copyTo(cropped);
+	mat = cropped;
 }
 
 bool OpenCVImageEncoder::convertMatToRawBytes(const cv::Mat& inputBGR, std::vector<uint8_t>& out, ImgFormat format) const {
@@ -456,15 +419,29 @@ bool OpenCVImageEncoder::convertMatToRawBytes(const cv::Mat& inputBGR, std::vect
 	}
 	case ImgFormat::RGB16:
 	{
-		cv::Mat rgb;
-		cv::cvtColor(inputBGR, rgb, cv::COLOR_BGR2RGB);
-		cv::Mat rgb565;
-		cv::cvtColor(rgb, rgb565, cv::COLOR_RGB2BGR565);
-		out.assign(rgb565.datastart, rgb565.dataend);
+		// Little-endian RGB565, red in the high bits: the same bits as BGR->RGB followed by RGB->BGR565
+		if (inputBGR.type() != CV_8UC3 || !inputBGR.isContinuous())
+		{
+			cv::Mat rgb565 = BufferPool::acquireMat(MatSlot::Convert, inputBGR.rows, inputBGR.cols, CV_8UC2);
+			cv::cvtColor(inputBGR, rgb565, cv::COLOR_BGR2BGR565);
+			out.assign(rgb565.datastart, rgb565.dataend);
+			break;
+		}
+		out.resize(inputBGR.total() * 2);
+		PixelKernels::bgrToRgb565(inputBGR.ptr<uint8_t>(), out.data(), inputBGR.total());
 		break;
 	}
 	case ImgFormat::RGB888:
 	{
+		if (inputBGR.type() != CV_8UC3 || !inputBGR.isContinuous())
+		{
+			cv::Mat rgb = BufferPool::acquireMat(MatSlot::Convert, inputBGR.rows, inputBGR.cols, CV_8UC3);
+			cv::cvtColor(inputBGR, rgb, cv::COLOR_BGR2RGB);
+			out.assign(rgb.datastart, rgb.dataend);
+			break;
+		}
+		out.resize(inputBGR.total() * 3);
+		PixelKernels::bgrToRgb888(inputBGR.ptr<uint8_t>(), out.data(), inputBGR.total());
 		break;
 	}
 	default:
@@ -31,15 +31,26 @@ public:
 		const ImgHelper& imgHelper = ImgHelper()) const override;
 
 	static std::vector<int> imgEncodeParams(ImgType type, int quality);
+	static void imgEncodeParams(ImgType type, int quality, std::vector<int>& params, const PngOptions& png = PngOptions());
 
 	enum class FlipMode {
 		Horizontal,  // Flip horizontally
 		Vertical     // Flip vertically
 	};
+	/// rotate/flip/crop write into the calling thread's scratch arena (see BufferPool.h) and never into
+	/// the buffer `mat` referenced on entry; clone() the result to keep it past the next encode.
 	void rotate(cv::Mat& mat, double angle) const;
 	void flip(cv::Mat& mat, bool hflip, bool vflip) const;
 	void crop(cv::Mat& mat, uint32_t x, uint32_t y, uint32_t width, uint32_t height) const;
 	bool convertMatToRawBytes(const cv::Mat& inputBGR, std::vector<uint8_t>&, ImgFormat format) const;
+	/// Crop (when allowCrop) or resize/pad, then rotate and flip. The result may alias `input` or arena memory.
+	cv::Mat transform(const cv::Mat& input, const ImgHelper& imgHelper, bool allowCrop) const;
+
+private:
+	bool encodeMatToBitmap(std::vector<uint8_t>& out, const cv::Mat& input, const ImgHelper& imgHelper) const;
+	/// Encode a processed Mat as imgHelper._imgType, honouring imgHelper._pngOptions for PNG.
+	bool encodeMat(std::vector<uint8_t>& out, const cv::Mat& input, int quality, const ImgHelper& imgHelper) const;
+	bool writeMat(const std::string& filename, const cv::Mat& input, int quality, const ImgHelper& imgHelper) const;
 };
 
 template <>
@@ -0,0 +1,183 @@
+#include "PixelKernels.h"
+#include "PixelKernelsImpl.h"
+#include <atomic>
+
+#if defined(PIXEL_KERNELS_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace
+{
+using Kernel = void (*)(const uint8_t*, uint8_t*, size_t);
+
+struct KernelTable
+{
+	Kernel premultiplyToBlack;
+	Kernel bgrToRgb565;
+	Kernel bgrToRgb888;
+};
+
+const KernelTable SCALAR_TABLE{
+	PixelKernelsImpl::premultiplyToBlackScalar,
+	PixelKernelsImpl::bgrToRgb565Scalar,
+	PixelKernelsImpl::bgrToRgb888Scalar
+};
+#if defined(PIXEL_KERNELS_X86)
+const KernelTable SSE41_TABLE{
+	PixelKernelsImpl::premultiplyToBlackSSE41,
+	PixelKernelsImpl::bgrToRgb565SSE41,
+	PixelKernelsImpl::bgrToRgb888SSE41
+};
+const KernelTable AVX2_TABLE{
+	PixelKernelsImpl::premultiplyToBlackAVX2,
+	PixelKernelsImpl::bgrToRgb565AVX2,
+	PixelKernelsImpl::bgrToRgb888AVX2
+};
+#endif
+
+SimdLevel detectLevel()
+{
+#if defined(PIXEL_KERNELS_X86) && defined(_MSC_VER)
+	int info[4] = {};
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+	__cpuid(info, 1);
+	const bool sse41 = (info[2] & (1 << 19)) != 0;
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	bool avx2 = false;
+	// AVX2 also needs the OS to save YMM state (XCR0 bits 1 and 2)
+	if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6)
+	{
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+	if (avx2)
+		return SimdLevel::AVX2;
+	if (sse41)
+		return SimdLevel::SSE41;
+	return SimdLevel::Scalar;
+#elif defined(PIXEL_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return SimdLevel::AVX2;
+	if (__builtin_cpu_supports("sse4.1"))
+		return SimdLevel::SSE41;
+	return SimdLevel::Scalar;
+#else
+	return SimdLevel::Scalar;
+#endif
+}
+
+const KernelTable* tableFor(SimdLevel level)
+{
+	switch (level)
+	{
+#if defined(PIXEL_KERNELS_X86)
+	case SimdLevel::AVX2:
+		return &AVX2_TABLE;
+	case SimdLevel::SSE41:
+		return &SSE41_TABLE;
+#endif
+	default:
+		return &SCALAR_TABLE;
+	}
+}
+
+std::atomic<SimdLevel> g_activeLevel{ SimdLevel::Scalar };
+std::atomic<const KernelTable*> g_table{ nullptr };
+
+const KernelTable& table()
+{
+	const KernelTable* current = g_table.load(std::memory_order_acquire);
+	if (current)
+		return *current;
+	const SimdLevel level = PixelKernels::supportedLevel();
+	g_activeLevel.store(level, std::memory_order_relaxed);
+	g_table.store(tableFor(level), std::memory_order_release);
+	return *tableFor(level);
+}
+}
+
+void PixelKernels::premultiplyToBlack(const uint8_t* bgra, uint8_t* bgr, size_t pixels)
+{
+	table().premultiplyToBlack(bgra, bgr, pixels);
+}
+
+void PixelKernels::bgrToRgb565(const uint8_t* bgr, uint8_t* rgb565, size_t pixels)
+{
+	table().bgrToRgb565(bgr, rgb565, pixels);
+}
+
+void PixelKernels::bgrToRgb888(const uint8_t* bgr, uint8_t* rgb, size_t pixels)
+{
+	table().bgrToRgb888(bgr, rgb, pixels);
+}
+
+SimdLevel PixelKernels::supportedLevel()
+{
+	static const SimdLevel level = detectLevel();
+	return level;
+}
+
+SimdLevel PixelKernels::activeLevel()
+{
+	table();
+	return g_activeLevel.load(std::memory_order_relaxed);
+}
+
+SimdLevel PixelKernels::setMaxLevel(SimdLevel level)
+{
+	const SimdLevel selected = level < supportedLevel() ? level : supportedLevel();
+	g_activeLevel.store(selected, std::memory_order_relaxed);
+	g_table.store(tableFor(selected), std::memory_order_release);
+	return selected;
+}
+
+const char* PixelKernels::levelName(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::AVX2:
+		return "avx2";
+	case SimdLevel::SSE41:
+		return "sse4.1";
+	default:
+		return "scalar";
+	}
+}
+
+namespace PixelKernelsImpl
+{
+void premultiplyToBlackScalar(const uint8_t* bgra, uint8_t* bgr, size_t pixels)
+{
+	for (size_t i = 0; i < pixels; ++i, bgra += 4, bgr += 3)
+	{
+		const int alpha = bgra[3];
+		bgr[0] = static_cast<uint8_t>((bgra[0] * alpha + 127) / 255);
+		bgr[1] = static_cast<uint8_t>((bgra[1] * alpha + 127) / 255);
+		bgr[2] = static_cast<uint8_t>((bgra[2] * alpha + 127) / 255);
+	}
+}
+
+void bgrToRgb565Scalar(const uint8_t* bgr, uint8_t* rgb565, size_t pixels)
+{
+	for (size_t i = 0; i < pixels; ++i, bgr += 3, rgb565 += 2)
+	{
+		const uint16_t value = static_cast<uint16_t>((bgr[0] >> 3) | ((bgr[1] & 0xFC) << 3) | ((bgr[2] & 0xF8) << 8));
+		rgb565[0] = static_cast<uint8_t>(value);
+		rgb565[1] = static_cast<uint8_t>(value >> 8);
+	}
+}
+
+void bgrToRgb888Scalar(const uint8_t* bgr, uint8_t* rgb, size_t pixels)
+{
+	for (size_t i = 0; i < pixels; ++i, bgr += 3, rgb += 3)
+	{
+		rgb[0] = bgr[2];
+		rgb[1] = bgr[1];
+		rgb[2] = bgr[0];
+	}
+}
+}
@@ -0,0 +1,38 @@
+/**
+ * @file PixelKernels.h
+ * @brief Per-pixel conversion kernels with SSE4.1 / AVX2 paths selected at runtime.
+ *
+ * - premultiplyToBlack: BGRA -> BGR composited over black, (c * a + 127) / 255
+ * - bgrToRgb565: BGR888 -> little-endian RGB565 (same bits as cv::COLOR_BGR2BGR565)
+ * - bgrToRgb888: BGR888 -> RGB888
+ *
+ * Every vector path produces exactly the bytes of the scalar path. The best level
+ * supported by the CPU is picked on first use; setMaxLevel() caps it (e.g. to
+ * compare against the scalar code or to benchmark each level).
+ * Source and destination must not overlap.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+enum class SimdLevel : uint8_t {
+	Scalar,
+	SSE41,
+	AVX2
+};
+
+class PixelKernels
+{
+public:
+	static void premultiplyToBlack(const uint8_t* bgra, uint8_t* bgr, size_t pixels);
+	static void bgrToRgb565(const uint8_t* bgr, uint8_t* rgb565, size_t pixels);
+	static void bgrToRgb888(const uint8_t* bgr, uint8_t* rgb, size_t pixels);
+
+	/// Highest level supported by this CPU and build.
+	static SimdLevel supportedLevel();
+	/// Level currently in use.
+	static SimdLevel activeLevel();
+	/// Use at most `level`; returns the level actually selected.
+	static SimdLevel setMaxLevel(SimdLevel level);
+	static const char* levelName(SimdLevel level);
+};
@@ -0,0 +1,21 @@
+// Internal: per-level kernel entry points shared by the PixelKernels translation units.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace PixelKernelsImpl
+{
+void premultiplyToBlackScalar(const uint8_t* bgra, uint8_t* bgr, size_t pixels);
+void bgrToRgb565Scalar(const uint8_t* bgr, uint8_t* rgb565, size_t pixels);
+void bgrToRgb888Scalar(const uint8_t* bgr, uint8_t* rgb, size_t pixels);
+
+#if defined(PIXEL_KERNELS_X86)
+void premultiplyToBlackSSE41(const uint8_t* bgra, uint8_t* bgr, size_t pixels);
+void bgrToRgb565SSE41(const uint8_t* bgr, uint8_t* rgb565, size_t pixels);
+void bgrToRgb888SSE41(const uint8_t* bgr, uint8_t* rgb, size_t pixels);
+
+void premultiplyToBlackAVX2(const uint8_t* bgra, uint8_t* bgr, size_t pixels);
+void bgrToRgb565AVX2(const uint8_t* bgr, uint8_t* rgb565, size_t pixels);
+void bgrToRgb888AVX2(const uint8_t* bgr, uint8_t* rgb, size_t pixels);
+#endif
+}
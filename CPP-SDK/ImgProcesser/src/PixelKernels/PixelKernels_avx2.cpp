@@ -0,0 +1,107 @@
+// AVX2 kernels. Built with -mavx2 (GCC/Clang) or /arch:AVX2 (MSVC); only called once PixelKernels has checked the CPU.
+#include "PixelKernelsImpl.h"
+
+#if defined(PIXEL_KERNELS_X86)
+#include <cstring>
+#include <immintrin.h>
+
+namespace
+{
+/// (x + 127) / 255 for x in [0, 255 * 255], exact.
+inline __m256i div255(__m256i x)
+{
+	x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+	return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+/// Same 16-byte shuffle control in both lanes.
+inline __m256i laneMask(__m128i mask)
+{
+	return _mm256_broadcastsi128_si256(mask);
+}
+}
+
+namespace PixelKernelsImpl
+{
+void premultiplyToBlackAVX2(const uint8_t* bgra, uint8_t* bgr, size_t pixels)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i alphaMask = laneMask(_mm_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15));
+	const __m256i packMask = laneMask(_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+
+	size_t i = 0;
+	for (; i + 8 <= pixels; i += 8)
+	{
+		const __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bgra + i * 4));
+		const __m256i alpha = _mm256_shuffle_epi8(px, alphaMask);
+		// unpack/pack both work per 128-bit lane, so pixel order is preserved
+		const __m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(px, zero), _mm256_unpacklo_epi8(alpha, zero));
+		const __m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(px, zero), _mm256_unpackhi_epi8(alpha, zero));
+		const __m256i out = _mm256_shuffle_epi8(_mm256_packus_epi16(div255(lo), div255(hi)), packMask);
+
+		// Each lane holds 12 output bytes; the first store's padding is overwritten by the second lane
+		uint8_t* dst = bgr + i * 3;
+		const __m128i first = _mm256_castsi256_si128(out);
+		const __m128i second = _mm256_extracti128_si256(out, 1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), first);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 12), second);
+		const int tail = _mm_extract_epi32(second, 2);
+		std::memcpy(dst + 20, &tail, sizeof(tail));
+	}
+	premultiplyToBlackScalar(bgra + i * 4, bgr + i * 3, pixels - i);
+}
+
+void bgrToRgb565AVX2(const uint8_t* bgr, uint8_t* rgb565, size_t pixels)
+{
+	// Two 8-pixel groups, one per lane; see bgrToRgb565SSE41 for the byte layout
+	const __m256i bLo = laneMask(_mm_setr_epi8(0, -1, 3, -1, 6, -1, 9, -1, 12, -1, 15, -1, -1, -1, -1, -1));
+	const __m256i bHi = laneMask(_mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, -1, 5, -1));
+	const __m256i gLo = laneMask(_mm_setr_epi8(1, -1, 4, -1, 7, -1, 10, -1, 13, -1, -1, -1, -1, -1, -1, -1));
+	const __m256i gHi = laneMask(_mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, -1, 3, -1, 6, -1));
+	const __m256i rLo = laneMask(_mm_setr_epi8(2, -1, 5, -1, 8, -1, 11, -1, 14, -1, -1, -1, -1, -1, -1, -1));
+	const __m256i rHi = laneMask(_mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, -1, 4, -1, 7, -1));
+	const __m256i gKeep = _mm256_set1_epi16(0xFC);
+	const __m256i rKeep = _mm256_set1_epi16(0xF8);
+
+	size_t i = 0;
+	for (; i + 16 <= pixels; i += 16)
+	{
+		const uint8_t* src = bgr + i * 3;
+		const __m256i lo = _mm256_inserti128_si256(
+			_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 24)), 1);
+		const __m256i hi = _mm256_inserti128_si256(
+			_mm256_castsi128_si256(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 16))),
+			_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 40)), 1);
+		const __m256i b = _mm256_or_si256(_mm256_shuffle_epi8(lo, bLo), _mm256_shuffle_epi8(hi, bHi));
+		const __m256i g = _mm256_or_si256(_mm256_shuffle_epi8(lo, gLo), _mm256_shuffle_epi8(hi, gHi));
+		const __m256i r = _mm256_or_si256(_mm256_shuffle_epi8(lo, rLo), _mm256_shuffle_epi8(hi, rHi));
+		const __m256i value = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi16(b, 3),
+			_mm256_slli_epi16(_mm256_and_si256(g, gKeep), 3)),
+			_mm256_slli_epi16(_mm256_and_si256(r, rKeep), 8));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(rgb565 + i * 2), value);
+	}
+	bgrToRgb565Scalar(bgr + i * 3, rgb565 + i * 2, pixels - i);
+}
+
+void bgrToRgb888AVX2(const uint8_t* bgr, uint8_t* rgb, size_t pixels)
+{
+	// Two 5-pixel blocks per iteration; see bgrToRgb888SSE41
+	const __m256i swapMask = laneMask(_mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15));
+
+	size_t i = 0;
+	for (; i + 11 <= pixels; i += 10)
+	{
+		const uint8_t* src = bgr + i * 3;
+		uint8_t* dst = rgb + i * 3;
+		const __m256i px = _mm256_inserti128_si256(
+			_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 15)), 1);
+		const __m256i out = _mm256_shuffle_epi8(px, swapMask);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(out));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 15), _mm256_extracti128_si256(out, 1));
+	}
+	bgrToRgb888Scalar(bgr + i * 3, rgb + i * 3, pixels - i);
+}
+}
+#endif
@@ -0,0 +1,86 @@
+// SSE4.1 kernels. Built with -msse4.1 (GCC/Clang); only called once PixelKernels has checked the CPU.
+#include "PixelKernelsImpl.h"
+
+#if defined(PIXEL_KERNELS_X86)
+#include <cstring>
+#include <smmintrin.h>
+
+namespace
+{
+/// (x + 127) / 255 for x in [0, 255 * 255], exact.
+inline __m128i div255(__m128i x)
+{
+	x = _mm_add_epi16(x, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+}
+
+namespace PixelKernelsImpl
+{
+void premultiplyToBlackSSE41(const uint8_t* bgra, uint8_t* bgr, size_t pixels)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaMask = _mm_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+	const __m128i packMask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+	size_t i = 0;
+	for (; i + 4 <= pixels; i += 4)
+	{
+		const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + i * 4));
+		const __m128i alpha = _mm_shuffle_epi8(px, alphaMask);
+		const __m128i lo = _mm_mullo_epi16(_mm_cvtepu8_epi16(px), _mm_cvtepu8_epi16(alpha));
+		const __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(px, zero), _mm_unpackhi_epi8(alpha, zero));
+		const __m128i out = _mm_shuffle_epi8(_mm_packus_epi16(div255(lo), div255(hi)), packMask);
+
+		uint8_t* dst = bgr + i * 3;
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst), out);
+		const int tail = _mm_extract_epi32(out, 2);
+		std::memcpy(dst + 8, &tail, sizeof(tail));
+	}
+	premultiplyToBlackScalar(bgra + i * 4, bgr + i * 3, pixels - i);
+}
+
+void bgrToRgb565SSE41(const uint8_t* bgr, uint8_t* rgb565, size_t pixels)
+{
+	// 8 pixels = 24 source bytes: bytes 0-15 in `lo`, 16-23 in `hi`, gathered into 16-bit lanes
+	const __m128i bLo = _mm_setr_epi8(0, -1, 3, -1, 6, -1, 9, -1, 12, -1, 15, -1, -1, -1, -1, -1);
+	const __m128i bHi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, -1, 5, -1);
+	const __m128i gLo = _mm_setr_epi8(1, -1, 4, -1, 7, -1, 10, -1, 13, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i gHi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, -1, 3, -1, 6, -1);
+	const __m128i rLo = _mm_setr_epi8(2, -1, 5, -1, 8, -1, 11, -1, 14, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i rHi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, -1, 4, -1, 7, -1);
+	const __m128i gKeep = _mm_set1_epi16(0xFC);
+	const __m128i rKeep = _mm_set1_epi16(0xF8);
+
+	size_t i = 0;
+	for (; i + 8 <= pixels; i += 8)
+	{
+		const uint8_t* src = bgr + i * 3;
+		const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		const __m128i hi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 16));
+		const __m128i b = _mm_or_si128(_mm_shuffle_epi8(lo, bLo), _mm_shuffle_epi8(hi, bHi));
+		const __m128i g = _mm_or_si128(_mm_shuffle_epi8(lo, gLo), _mm_shuffle_epi8(hi, gHi));
+		const __m128i r = _mm_or_si128(_mm_shuffle_epi8(lo, rLo), _mm_shuffle_epi8(hi, rHi));
+		const __m128i value = _mm_or_si128(_mm_or_si128(_mm_srli_epi16(b, 3),
+			_mm_slli_epi16(_mm_and_si128(g, gKeep), 3)),
+			_mm_slli_epi16(_mm_and_si128(r, rKeep), 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(rgb565 + i * 2), value);
+	}
+	bgrToRgb565Scalar(bgr + i * 3, rgb565 + i * 2, pixels - i);
+}
+
+void bgrToRgb888SSE41(const uint8_t* bgr, uint8_t* rgb, size_t pixels)
+{
+	// 5 pixels per 16-byte block; byte 15 is rewritten by the next block or the scalar tail
+	const __m128i swapMask = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+
+	size_t i = 0;
+	for (; i + 6 <= pixels; i += 5)
+	{
+		const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgr + i * 3));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(rgb + i * 3), _mm_shuffle_epi8(px, swapMask));
+	}
+	bgrToRgb888Scalar(bgr + i * 3, rgb + i * 3, pixels - i);
+}
+}
+#endif
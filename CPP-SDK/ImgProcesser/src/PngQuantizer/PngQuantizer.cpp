@@ -0,0 +1,502 @@
+#include "PngQuantizer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <unordered_map>
+#if defined(IMGPROCESSER_HAS_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace
+{
+struct ColorCount
+{
+	uint32_t color;		///< B | G << 8 | R << 16 | A << 24
+	uint32_t count;
+};
+
+using ColorLookup = std::unordered_map<uint32_t, uint32_t>;
+using Palette = std::vector<std::array<uint8_t, 4>>;
+
+inline uint8_t channelOf(uint32_t color, int channel)
+{
+	return static_cast<uint8_t>(color >> (channel * 8));
+}
+
+inline uint32_t packPixel(const uint8_t* p, bool alpha)
+{
+	return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 | static_cast<uint32_t>(p[2]) << 16 |
+		static_cast<uint32_t>(alpha ? p[3] : 255) << 24;
+}
+
+void histogram(const cv::Mat& input, std::vector<ColorCount>& colors, ColorLookup& lookup)
+{
+	const bool alpha = input.channels() == 4;
+	const int channels = input.channels();
+	lookup.clear();
+	for (int y = 0; y < input.rows; ++y)
+	{
+		const uint8_t* row = input.ptr<uint8_t>(y);
+		for (int x = 0; x < input.cols; ++x)
+			++lookup[packPixel(row + x * channels, alpha)];
+	}
+	colors.clear();
+	colors.reserve(lookup.size());
+	for (const auto& entry : lookup)
+		colors.push_back(ColorCount{ entry.first, entry.second });
+	// unordered_map order is unspecified; sort so the palette is deterministic
+	std::sort(colors.begin(), colors.end(), [](const ColorCount& a, const ColorCount& b) { return a.color < b.color; });
+}
+
+void exactPalette(const std::vector<ColorCount>& colors, Palette& palette, ColorLookup& lookup)
+{
+	palette.clear();
+	for (const auto& entry : colors)
+	{
+		lookup[entry.color] = static_cast<uint32_t>(palette.size());
+		palette.push_back({ channelOf(entry.color, 0), channelOf(entry.color, 1), channelOf(entry.color, 2), channelOf(entry.color, 3) });
+	}
+}
+
+void medianCut(std::vector<ColorCount>& colors, int maxColors, Palette& palette, ColorLookup& lookup)
+{
+	struct Box
+	{
+		size_t begin;
+		size_t end;
+		int axis;		///< Channel with the widest range
+		int range;
+		uint64_t count;
+	};
+	auto makeBox = [&colors](size_t begin, size_t end) {
+		int lo[4] = { 255, 255, 255, 255 };
+		int hi[4] = { 0, 0, 0, 0 };
+		uint64_t count = 0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				lo[c] = std::min<int>(lo[c], channelOf(colors[i].color, c));
+				hi[c] = std::max<int>(hi[c], channelOf(colors[i].color, c));
+			}
+			count += colors[i].count;
+		}
+		Box box{ begin, end, 0, -1, count };
+		for (int c = 0; c < 4; ++c)
+		{
+			if (hi[c] - lo[c] > box.range)
+			{
+				box.range = hi[c] - lo[c];
+				box.axis = c;
+			}
+		}
+		return box;
+	};
+
+	std::vector<Box> boxes{ makeBox(0, colors.size()) };
+	while (static_cast<int>(boxes.size()) < maxColors)
+	{
+		// Split the box with the widest channel range; pixel count breaks ties
+		int target = -1;
+		for (size_t i = 0; i < boxes.size(); ++i)
+		{
+			if (boxes[i].end - boxes[i].begin < 2)
+				continue;
+			if (target < 0 || boxes[i].range > boxes[target].range ||
+				(boxes[i].range == boxes[target].range && boxes[i].count > boxes[target].count))
+				target = static_cast<int>(i);
+		}
+		if (target < 0)
+			break;
+
+		const Box box = boxes[target];
+		std::sort(colors.begin() + box.begin, colors.begin() + box.end, [axis = box.axis](const ColorCount& a, const ColorCount& b) {
+			const uint8_t ca = channelOf(a.color, axis);
+			const uint8_t cb = channelOf(b.color, axis);
+			return ca != cb ? ca < cb : a.color < b.color;
+		});
+
+		// Weighted median, keeping at least one colour on each side
+		size_t split = box.end - 1;
+		uint64_t accumulated = 0;
+		for (size_t i = box.begin; i + 1 < box.end; ++i)
+		{
+			accumulated += colors[i].count;
+			if (accumulated * 2 >= box.count)
+			{
+				split = i + 1;
+				break;
+			}
+		}
+		boxes[target] = makeBox(box.begin, split);
+		boxes.push_back(makeBox(split, box.end));
+	}
+
+	palette.clear();
+	for (const auto& box : boxes)
+	{
+		uint64_t sum[4] = {};
+		for (size_t i = box.begin; i < box.end; ++i)
+		{
+			for (int c = 0; c < 4; ++c)
+				sum[c] += static_cast<uint64_t>(channelOf(colors[i].color, c)) * colors[i].count;
+			lookup[colors[i].color] = static_cast<uint32_t>(palette.size());
+		}
+		std::array<uint8_t, 4> entry{};
+		for (int c = 0; c < 4; ++c)
+			entry[c] = static_cast<uint8_t>((sum[c] + box.count / 2) / box.count);
+		palette.push_back(entry);
+	}
+}
+
+void octree(const std::vector<ColorCount>& colors, int maxColors, Palette& palette, ColorLookup& lookup)
+{
+	// 4-D (BGRA) octree: 16 children per node, leaves at depth 8
+	constexpr int DEPTH = 8;
+	struct Node
+	{
+		uint64_t sum[4] = {};
+		uint64_t count = 0;
+		int32_t children[16];
+		bool leaf = false;
+		int32_t paletteIndex = -1;
+		Node() { std::fill(std::begin(children), std::end(children), -1); }
+	};
+	auto childIndex = [](uint32_t color, int level) {
+		const int shift = DEPTH - 1 - level;
+		return ((channelOf(color, 0) >> shift) & 1) | ((channelOf(color, 1) >> shift) & 1) << 1 |
+			((channelOf(color, 2) >> shift) & 1) << 2 | ((channelOf(color, 3) >> shift) & 1) << 3;
+	};
+
+	std::vector<Node> nodes(1);
+	std::vector<std::vector<int32_t>> reducible(DEPTH);
+	reducible[0].push_back(0);
+	size_t leaves = 0;
+	for (const auto& entry : colors)
+	{
+		int32_t node = 0;
+		nodes[node].count += entry.count;
+		for (int level = 0; level < DEPTH; ++level)
+		{
+			const int child = childIndex(entry.color, level);
+			if (nodes[node].children[child] < 0)
+			{
+				const int32_t created = static_cast<int32_t>(nodes.size());
+				nodes.emplace_back();
+				nodes[node].children[child] = created;
+				if (level + 1 < DEPTH)
+					reducible[level + 1].push_back(created);
+				else
+				{
+					nodes[created].leaf = true;
+					++leaves;
+				}
+			}
+			node = nodes[node].children[child];
+			nodes[node].count += entry.count;
+		}
+		for (int c = 0; c < 4; ++c)
+			nodes[node].sum[c] += static_cast<uint64_t>(channelOf(entry.color, c)) * entry.count;
+	}
+
+	// Fold the least used nodes of the deepest level into single leaves until the palette fits
+	for (auto& level : reducible)
+		std::sort(level.begin(), level.end(), [&nodes](int32_t a, int32_t b) { return nodes[a].count > nodes[b].count; });
+	for (int level = DEPTH - 1; level >= 0 && leaves > static_cast<size_t>(maxColors); )
+	{
+		if (reducible[level].empty())
+		{
+			--level;
+			continue;
+		}
+		Node& node = nodes[reducible[level].back()];
+		reducible[level].pop_back();
+		size_t merged = 0;
+		for (auto& child : node.children)
+		{
+			if (child < 0)
+				continue;
+			for (int c = 0; c < 4; ++c)
+				node.sum[c] += nodes[child].sum[c];
+			child = -1;
+			++merged;
+		}
+		node.leaf = true;
+		leaves -= merged - 1;
+	}
+
+	palette.clear();
+	for (const auto& entry : colors)
+	{
+		int32_t node = 0;
+		for (int level = 0; !nodes[node].leaf; ++level)
+			node = nodes[node].children[childIndex(entry.color, level)];
+		Node& leaf = nodes[node];
+		if (leaf.paletteIndex < 0)
+		{
+			leaf.paletteIndex = static_cast<int32_t>(palette.size());
+			std::array<uint8_t, 4> value{};
+			for (int c = 0; c < 4; ++c)
+				value[c] = static_cast<uint8_t>((leaf.sum[c] + leaf.count / 2) / leaf.count);
+			palette.push_back(value);
+		}
+		lookup[entry.color] = static_cast<uint32_t>(leaf.paletteIndex);
+	}
+}
+
+/// Order the palette (translucent entries first to keep tRNS short, then by use), measure the error and index every pixel.
+void finalize(const cv::Mat& input, const std::vector<ColorCount>& colors, const Palette& palette, ColorLookup& lookup, IndexedImage& out)
+{
+	const bool alpha = input.channels() == 4;
+	const int channels = input.channels();
+	std::vector<uint64_t> usage(palette.size(), 0);
+	uint64_t error = 0;
+	for (const auto& entry : colors)
+	{
+		const uint32_t index = lookup[entry.color];
+		usage[index] += entry.count;
+		for (int c = 0; c < channels; ++c)
+			error += static_cast<uint64_t>(std::abs(static_cast<int>(channelOf(entry.color, c)) - palette[index][c])) * entry.count;
+	}
+
+	std::vector<uint32_t> order(palette.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+		const bool opaqueA = palette[a][3] == 255;
+		const bool opaqueB = palette[b][3] == 255;
+		if (opaqueA != opaqueB)
+			return !opaqueA;
+		if (usage[a] != usage[b])
+			return usage[a] > usage[b];
+		return a < b;
+	});
+	std::vector<uint32_t> remap(palette.size());
+	out.palette.resize(palette.size());
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		remap[order[i]] = static_cast<uint32_t>(i);
+		out.palette[i] = palette[order[i]];
+	}
+	for (auto& entry : lookup)
+		entry.second = remap[entry.second];
+
+	out.width = input.cols;
+	out.height = input.rows;
+	out.indices.resize(input.total());
+	uint8_t* index = out.indices.data();
+	for (int y = 0; y < input.rows; ++y)
+	{
+		const uint8_t* row = input.ptr<uint8_t>(y);
+		for (int x = 0; x < input.cols; ++x)
+			*index++ = static_cast<uint8_t>(lookup[packPixel(row + x * channels, alpha)]);
+	}
+	const uint64_t samples = static_cast<uint64_t>(input.total()) * channels;
+	out.meanError = samples ? static_cast<double>(error) / samples : 0.0;
+}
+
+#if defined(IMGPROCESSER_HAS_ZLIB)
+void putU32(std::vector<uint8_t>& out, uint32_t value)
+{
+	out.push_back(static_cast<uint8_t>(value >> 24));
+	out.push_back(static_cast<uint8_t>(value >> 16));
+	out.push_back(static_cast<uint8_t>(value >> 8));
+	out.push_back(static_cast<uint8_t>(value));
+}
+
+void putChunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t size)
+{
+	putU32(out, static_cast<uint32_t>(size));
+	const size_t start = out.size();
+	out.insert(out.end(), type, type + 4);
+	if (size)
+		out.insert(out.end(), data, data + size);
+	putU32(out, static_cast<uint32_t>(crc32(0L, out.data() + start, static_cast<uInt>(size + 4))));
+}
+
+inline uint8_t paethPredictor(int a, int b, int c)
+{
+	const int p = a + b - c;
+	const int pa = std::abs(p - a);
+	const int pb = std::abs(p - b);
+	const int pc = std::abs(p - c);
+	if (pa <= pb && pa <= pc)
+		return static_cast<uint8_t>(a);
+	return static_cast<uint8_t>(pb <= pc ? b : c);
+}
+
+/// Filter one scanline (1 byte per filter unit, as for every palette bit depth). dst[0] receives the filter type.
+void filterRow(int type, const uint8_t* row, const uint8_t* prev, size_t size, uint8_t* dst)
+{
+	dst[0] = static_cast<uint8_t>(type);
+	for (size_t i = 0; i < size; ++i)
+	{
+		const int left = i ? row[i - 1] : 0;
+		const int up = prev[i];
+		const int upLeft = i ? prev[i - 1] : 0;
+		int predicted = 0;
+		switch (type)
+		{
+		case 1: predicted = left; break;
+		case 2: predicted = up; break;
+		case 3: predicted = (left + up) / 2; break;
+		case 4: predicted = paethPredictor(left, up, upLeft); break;
+		default: break;
+		}
+		dst[i + 1] = static_cast<uint8_t>(row[i] - predicted);
+	}
+}
+
+uint64_t filterCost(const uint8_t* filtered, size_t size)
+{
+	uint64_t cost = 0;
+	for (size_t i = 1; i <= size; ++i)
+		cost += static_cast<uint64_t>(std::abs(static_cast<int>(static_cast<int8_t>(filtered[i]))));
+	return cost;
+}
+#endif
+}
+
+bool PngQuantizer::quantize(const cv::Mat& input, PngPalette method, int maxColors, IndexedImage& out)
+{
+	if (method == PngPalette::None || input.empty() || (input.type() != CV_8UC3 && input.type() != CV_8UC4))
+		return false;
+	maxColors = std::clamp(maxColors, 2, 256);
+
+	std::vector<ColorCount> colors;
+	ColorLookup lookup;
+	Palette palette;
+	histogram(input, colors, lookup);
+	if (colors.size() <= static_cast<size_t>(maxColors))
+		exactPalette(colors, palette, lookup);
+	else if (method == PngPalette::MedianCut)
+		medianCut(colors, maxColors, palette, lookup);
+	else
+		octree(colors, maxColors, palette, lookup);
+
+	finalize(input, colors, palette, lookup, out);
+	return true;
+}
+
+void PngQuantizer::toMat(const IndexedImage& image, cv::Mat& out, bool alpha)
+{
+	const int channels = alpha ? 4 : 3;
+	out.create(image.height, image.width, alpha ? CV_8UC4 : CV_8UC3);
+	const uint8_t* index = image.indices.data();
+	for (int y = 0; y < image.height; ++y)
+	{
+		uint8_t* row = out.ptr<uint8_t>(y);
+		for (int x = 0; x < image.width; ++x, ++index)
+			std::copy_n(image.palette[*index].data(), channels, row + x * channels);
+	}
+}
+
+bool PngQuantizer::supportsIndexedPng()
+{
+#if defined(IMGPROCESSER_HAS_ZLIB)
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool PngQuantizer::writeIndexedPng(const IndexedImage& image, const PngOptions& options, std::vector<uint8_t>& out)
+{
+#if defined(IMGPROCESSER_HAS_ZLIB)
+	if (image.width <= 0 || image.height <= 0 || image.palette.empty() || image.palette.size() > 256)
+		return false;
+
+	const size_t colors = image.palette.size();
+	const int bitDepth = colors <= 2 ? 1 : colors <= 4 ? 2 : colors <= 16 ? 4 : 8;
+	const int perByte = 8 / bitDepth;
+	const size_t rowBytes = (static_cast<size_t>(image.width) * bitDepth + 7) / 8;
+
+	// Pack indices, then filter every row
+	std::vector<uint8_t> packed(rowBytes * image.height, 0);
+	for (int y = 0; y < image.height; ++y)
+	{
+		const uint8_t* src = image.indices.data() + static_cast<size_t>(y) * image.width;
+		uint8_t* dst = packed.data() + y * rowBytes;
+		for (int x = 0; x < image.width; ++x)
+			dst[x / perByte] |= static_cast<uint8_t>(src[x] << (8 - bitDepth * (x % perByte + 1)));
+	}
+
+	std::vector<uint8_t> filtered((rowBytes + 1) * image.height);
+	std::vector<uint8_t> candidate(rowBytes + 1);
+	const std::vector<uint8_t> zeroRow(rowBytes, 0);
+	for (int y = 0; y < image.height; ++y)
+	{
+		const uint8_t* row = packed.data() + y * rowBytes;
+		const uint8_t* prev = y ? row - rowBytes : zeroRow.data();
+		uint8_t* dst = filtered.data() + y * (rowBytes + 1);
+		switch (options.filter)
+		{
+		case PngFilter::Sub: filterRow(1, row, prev, rowBytes, dst); break;
+		case PngFilter::Up: filterRow(2, row, prev, rowBytes, dst); break;
+		case PngFilter::Average: filterRow(3, row, prev, rowBytes, dst); break;
+		case PngFilter::Paeth: filterRow(4, row, prev, rowBytes, dst); break;
+		case PngFilter::Adaptive:
+		{
+			// Minimum sum of absolute differences heuristic
+			filterRow(0, row, prev, rowBytes, dst);
+			uint64_t best = filterCost(dst, rowBytes);
+			for (int type = 1; type <= 4; ++type)
+			{
+				filterRow(type, row, prev, rowBytes, candidate.data());
+				const uint64_t cost = filterCost(candidate.data(), rowBytes);
+				if (cost < best)
+				{
+					best = cost;
+					std::copy(candidate.begin(), candidate.end(), dst);
+				}
+			}
+			break;
+		}
+		default:
+			filterRow(0, row, prev, rowBytes, dst);
+			break;
+		}
+	}
+
+	uLongf compressedSize = compressBound(static_cast<uLong>(filtered.size()));
+	std::vector<uint8_t> compressed(compressedSize);
+	if (compress2(compressed.data(), &compressedSize, filtered.data(), static_cast<uLong>(filtered.size()),
+		std::clamp(options.compressionLevel, 0, 9)) != Z_OK)
+		return false;
+
+	static const uint8_t SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	out.assign(SIGNATURE, SIGNATURE + sizeof(SIGNATURE));
+
+	uint8_t header[13];
+	for (int i = 0; i < 4; ++i)
+	{
+		header[i] = static_cast<uint8_t>(static_cast<uint32_t>(image.width) >> (24 - i * 8));
+		header[4 + i] = static_cast<uint8_t>(static_cast<uint32_t>(image.height) >> (24 - i * 8));
+	}
+	header[8] = static_cast<uint8_t>(bitDepth);
+	header[9] = 3;	// Colour type: palette
+	header[10] = header[11] = header[12] = 0;
+	putChunk(out, "IHDR", header, sizeof(header));
+
+	std::vector<uint8_t> plte;
+	std::vector<uint8_t> trns;
+	plte.reserve(colors * 3);
+	for (const auto& entry : image.palette)
+	{
+		plte.insert(plte.end(), { entry[2], entry[1], entry[0] });
+		if (entry[3] != 255)
+			trns.push_back(entry[3]);
+	}
+	putChunk(out, "PLTE", plte.data(), plte.size());
+	// Translucent entries are ordered first, so tRNS only lists those
+	if (!trns.empty())
+		putChunk(out, "tRNS", trns.data(), trns.size());
+	putChunk(out, "IDAT", compressed.data(), compressedSize);
+	putChunk(out, "IEND", nullptr, 0);
+	return true;
+#else
+	(void)image;
+	(void)options;
+	(void)out;
+	return false;
+#endif
+}
@@ -0,0 +1,51 @@
+/**
+ * @file PngQuantizer.h
+ * @brief Palette quantisation and indexed PNG writing for flat key graphics.
+ *
+ * - quantize(): exact palette when the image has at most maxColors colours,
+ *   otherwise median-cut or octree reduction, reporting the mean error
+ * - writeIndexedPng(): colour type 3 PNG with PLTE/tRNS, 1/2/4/8-bit indices,
+ *   selectable row filter and zlib level. Needs zlib (IMGPROCESSER_HAS_ZLIB);
+ *   without it the call returns false and callers fall back to toMat() + a
+ *   truecolor encode of the quantised pixels.
+ */
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "ImgHelper.h"
+
+struct IndexedImage
+{
+	int width = 0;
+	int height = 0;
+	std::vector<std::array<uint8_t, 4>> palette;	///< BGRA entries, translucent entries first
+	std::vector<uint8_t> indices;					///< One palette index per pixel, row-major
+	double meanError = 0.0;							///< Mean absolute error per channel, 0-255
+};
+
+class PngQuantizer
+{
+public:
+	/**
+	 * @brief Reduce a CV_8UC3 / CV_8UC4 image to at most maxColors palette entries.
+	 * @return False for other Mat types or when method is PngPalette::None.
+	 */
+	static bool quantize(const cv::Mat& input, PngPalette method, int maxColors, IndexedImage& out);
+
+	/**
+	 * @brief Expand an indexed image back to BGR (or BGRA when alpha is set).
+	 */
+	static void toMat(const IndexedImage& image, cv::Mat& out, bool alpha);
+
+	/**
+	 * @brief Whether writeIndexedPng() is available in this build.
+	 */
+	static bool supportsIndexedPng();
+
+	/**
+	 * @brief Write an indexed PNG using the filter and zlib level from options.
+	 */
+	static bool writeIndexedPng(const IndexedImage& image, const PngOptions& options, std::vector<uint8_t>& out);
+};
@@ -0,0 +1,178 @@
+/**
+ * @file bufferpool_check.cpp
+ * @brief Checks that repeated key / background encodes reuse the pooled buffers.
+ *
+ * Mirrors StreamDock::setKeyImgFile() / setBackgroundImgFile(): source bytes go into
+ * ByteSlot::Input, the encoder writes into ByteSlot::Output, and that buffer is what
+ * the transport is handed. After a warm-up pass the same sources are encoded again
+ * and BufferPool::stats() must not count a single Mat or byte buffer allocation,
+ * the Output buffer must not move, and the decode cache must only hit. The check
+ * runs with the decode cache on and off (off decodes into the per-thread slot), and
+ * through FormatSelector with every decision forced to a miss, so both candidates are
+ * encoded each time: the candidate buffers must not move and the winner must be copied
+ * into Output rather than replace it.
+ *
+ * Allocations inside OpenCV and the codecs are not counted here; see BufferPool.h.
+ * Sample images are read from IMGPROC_TEST_DATA (env) or the repo's img/ directory.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "BufferPool.h"
+#include "DecodeCache.h"
+#include "FormatSelector.h"
+#include "OpenCVImageEncoder.h"
+
+#ifndef IMGPROC_TEST_DATA_DIR
+#define IMGPROC_TEST_DATA_DIR "img"
+#endif
+
+namespace
+{
+struct EncodeCase
+{
+	const char* name;
+	const char* file;
+	ImgHelper helper;
+	int quality;
+};
+
+/// Key, PNG key, JPEG background and raw bitmap background, as the device constructors set them up.
+std::vector<EncodeCase> encodeCases()
+{
+	return {
+		{ "N4/key", "button_test.jpg", ImgHelper(112, 112, 180.0, ResizeOption::Scale, false, false, ImgType::JPG), 90 },
+		{ "N4Pro/key", "mark.png", ImgHelper(112, 112, 180.0, ResizeOption::Scale, false, false, ImgType::PNG), 90 },
+		{ "N4/background", "backgroud_test.png", ImgHelper(800, 480, 180.0, ResizeOption::Scale, false, false, ImgType::JPG), 85 },
+		{ "293V2/background", "backgroud_test.png", ImgHelper(800, 480, 180.0, ResizeOption::Scale, false, false, ImgType::RAW, ImgFormat::BGR888), 85 },
+	};
+}
+
+constexpr int ROUNDS = 20;
+
+std::string dataDir()
+{
+	if (const char* dir = std::getenv("IMGPROC_TEST_DATA"))
+		return dir;
+	return IMGPROC_TEST_DATA_DIR;
+}
+
+std::vector<uint8_t> readFile(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+enum class Mode
+{
+	Encoder,		///< ImageEncodeProfile without autoFormat
+	AutoFormat,		///< ImageEncodeProfile with autoFormat, every decision made again
+};
+
+/// One setKeyImgFile()-style pass over every case; returns false if an encode fails.
+bool encodeAll(const OpenCVImageEncoder& encoder, const std::vector<EncodeCase>& cases, const std::vector<std::vector<uint8_t>>& sources, Mode mode)
+{
+	if (mode == Mode::AutoFormat)
+		FormatSelector::clear();
+	for (size_t i = 0; i < cases.size(); ++i)
+	{
+		if (mode == Mode::AutoFormat && cases[i].helper._imgType == ImgType::RAW)
+			continue; // Format selection only applies to JPEG/PNG streams
+		auto& input = BufferPool::acquireBytes(ByteSlot::Input, sources[i].size());
+		std::memcpy(input.data(), sources[i].data(), sources[i].size());
+		auto& output = BufferPool::acquireBytes(ByteSlot::Output);
+		const bool ok = mode == Mode::AutoFormat
+			? FormatSelector::encode(encoder, output, input, cases[i].quality, cases[i].helper, false)
+			: encoder.encodeToMemory(output, input, cases[i].quality, cases[i].helper);
+		if (!ok || output.empty())
+		{
+			std::printf("FAIL %s: encode failed\n", cases[i].name);
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Where a pooled byte buffer lives; it must stay put once warmed up.
+struct BufferPlace
+{
+	const uint8_t* data;
+	size_t capacity;
+	bool operator!=(const BufferPlace& other) const { return data != other.data || capacity != other.capacity; }
+};
+
+BufferPlace placeOf(ByteSlot slot)
+{
+	const auto& buffer = BufferPool::acquireBytes(slot);
+	return BufferPlace{ buffer.data(), buffer.capacity() };
+}
+
+int check(const char* name, Mode mode, const OpenCVImageEncoder& encoder, const std::vector<EncodeCase>& cases, const std::vector<std::vector<uint8_t>>& sources)
+{
+	// Warm up twice: the first pass sizes every slot, the second settles the byte buffers at their largest encode
+	if (!encodeAll(encoder, cases, sources, mode) || !encodeAll(encoder, cases, sources, mode))
+		return 1;
+
+	const BufferPoolStats before = BufferPool::stats();
+	const DecodeCacheStats cacheBefore = DecodeCache::stats();
+	const ByteSlot slots[] = { ByteSlot::Output, ByteSlot::JpegCandidate, ByteSlot::PngCandidate };
+	std::vector<BufferPlace> places;
+	for (ByteSlot slot : slots)
+		places.push_back(placeOf(slot));
+
+	for (int round = 0; round < ROUNDS; ++round)
+	{
+		if (!encodeAll(encoder, cases, sources, mode))
+			return 1;
+	}
+
+	const BufferPoolStats after = BufferPool::stats();
+	const DecodeCacheStats cacheAfter = DecodeCache::stats();
+	const uint64_t matAllocations = after.matAllocations - before.matAllocations;
+	const uint64_t byteAllocations = after.byteAllocations - before.byteAllocations;
+	const uint64_t decodeMisses = cacheAfter.misses - cacheBefore.misses;
+	bool outputMoved = false;
+	for (size_t i = 0; i < places.size(); ++i)
+		outputMoved = outputMoved || placeOf(slots[i]) != places[i];
+
+	std::printf("%s: %d rounds, mat allocations %llu, byte allocations %llu, decode misses %llu, byte buffers %s\n",
+		name, ROUNDS, static_cast<unsigned long long>(matAllocations), static_cast<unsigned long long>(byteAllocations),
+		static_cast<unsigned long long>(decodeMisses), outputMoved ? "moved" : "kept");
+	if (matAllocations != 0 || byteAllocations != 0 || decodeMisses != 0 || outputMoved)
+	{
+		std::printf("FAIL %s: steady-state encodes allocated\n", name);
+		return 1;
+	}
+	return 0;
+}
+}
+
+int main()
+{
+	const std::vector<EncodeCase> cases = encodeCases();
+	std::vector<std::vector<uint8_t>> sources;
+	for (const EncodeCase& encodeCase : cases)
+	{
+		sources.push_back(readFile(dataDir() + "/" + encodeCase.file));
+		if (sources.back().empty())
+		{
+			std::printf("FAIL %s: sample image %s not found in %s\n", encodeCase.name, encodeCase.file, dataDir().c_str());
+			return 1;
+		}
+	}
+
+	OpenCVImageEncoder encoder;
+	int failures = check("decode cache", Mode::Encoder, encoder, cases, sources);
+	failures += check("auto format", Mode::AutoFormat, encoder, cases, sources);
+
+	const size_t capacity = DecodeCache::capacity();
+	DecodeCache::setCapacity(0);
+	failures += check("decode slot", Mode::Encoder, encoder, cases, sources);
+	DecodeCache::setCapacity(capacity);
+
+	return failures == 0 ? 0 : 1;
+}
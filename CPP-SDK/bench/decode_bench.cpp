@@ -0,0 +1,122 @@
+/**
+ * @file decode_bench.cpp
+ * @brief Google Benchmark comparison of input report decoding: EventDecodeTable lookup against the
+ * former reverse scan of _readValueMap followed by the dispatchEvent() if-chain.
+ *
+ * Both decoders use the StreamDockN4 key layout (keys, secondary screen buttons, knobs, swipes), the
+ * model with the longest chain. The report stream mixes every registered code with a few unknown ones.
+ */
+#include <benchmark/benchmark.h>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <eventdecodetable.h>
+
+namespace
+{
+static constexpr KeyDecode N4_KEYS[] = {
+	{1, 0x40, RegisterEvent::KeyRelease, RegisterEvent::EveryThing},
+	{2, 0x41, RegisterEvent::KeyRelease, RegisterEvent::EveryThing},
+	{3, 0x42, RegisterEvent::KeyRelease, RegisterEvent::EveryThing},
+	{4, 0x43, RegisterEvent::KeyRelease, RegisterEvent::EveryThing},
+	{6, 0x06},{7, 0x07},{8, 0x08},{9, 0x09}, {10, 0x0A}, {11, 0x01},{12, 0x02},{13, 0x03},{14, 0x04},{15, 0x05},
+	{16, 0xA0, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	{17, 0xA1, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+	{18, 0x50, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	{19, 0x51, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+	{20, 0x90, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	{21, 0x91, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+	{22, 0x70, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	{23, 0x71, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+	{24, 0x37, RegisterEvent::KnobPress, RegisterEvent::EveryThing},
+	{25, 0x35, RegisterEvent::KnobPress, RegisterEvent::EveryThing},
+	{26, 0x33, RegisterEvent::KnobPress, RegisterEvent::EveryThing},
+	{27, 0x36, RegisterEvent::KnobPress, RegisterEvent::EveryThing},
+	{28, 0x38, RegisterEvent::SwipeLeft, RegisterEvent::EveryThing},
+	{29, 0x39, RegisterEvent::SwipeRight, RegisterEvent::EveryThing},
+};
+static constexpr EventDecodeTable N4_DECODE_TABLE(N4_KEYS);
+
+/// StreamDockN4::dispatchEvent() as it was before the decode tables.
+RegisterEvent legacyDispatchEvent(uint8_t readValue, uint8_t eventValue)
+{
+	if ((0x01 <= readValue && readValue <= 0x0A) && eventValue == 0x00)
+		return RegisterEvent::KeyRelease;
+	else if ((0x01 <= readValue && readValue <= 0x0A) && eventValue == 0x01)
+		return RegisterEvent::KeyPress;
+	if ((0x40 <= readValue && readValue <= 0x43) && eventValue == 0x00)
+		return RegisterEvent::KeyRelease;
+	if ((0xA0 == readValue || 0x50 == readValue || 0x90 == readValue || 0x70 == readValue) && eventValue == 0x00)
+		return RegisterEvent::KnobLeft;
+	if ((0xA1 == readValue || 0x51 == readValue || 0x91 == readValue || 0x71 == readValue) && eventValue == 0x00)
+		return RegisterEvent::KnobRight;
+	if ((0x37 == readValue || 0x35 == readValue || 0x33 == readValue || 0x36 == readValue) && eventValue == 0x00)
+		return RegisterEvent::KnobPress;
+	if ((0x38 == readValue) && eventValue == 0x00)
+		return RegisterEvent::SwipeLeft;
+	if ((0x39 == readValue) && eventValue == 0x00)
+		return RegisterEvent::SwipeRight;
+	return RegisterEvent::EveryThing;
+}
+
+/// ReadController's decode step as it was before the decode tables.
+DecodedEvent legacyDecode(const std::unordered_map<uint8_t, uint8_t>& readValueMap, uint8_t readValue, uint8_t eventValue)
+{
+	uint8_t realValue = 0xFF;
+	for (const auto& ite : readValueMap)
+	{
+		if (ite.second == readValue)
+		{
+			realValue = ite.first;
+			break;
+		}
+	}
+	if (realValue == 0xFF)
+		return { EventDecodeTable::NO_KEY, RegisterEvent::EveryThing };
+	return { realValue, legacyDispatchEvent(readValue, eventValue) };
+}
+
+std::vector<std::pair<uint8_t, uint8_t>> reportStream()
+{
+	std::vector<uint8_t> codes;
+	for (const auto& key : N4_KEYS)
+		codes.push_back(key.hardwareCode);
+	codes.push_back(0x00);
+	codes.push_back(0x7F);
+	std::mt19937 rng(42);
+	std::vector<std::pair<uint8_t, uint8_t>> reports(4096);
+	for (auto& report : reports)
+		report = { codes[rng() % codes.size()], static_cast<uint8_t>(rng() % 2) };
+	return reports;
+}
+
+void BM_DecodeLegacy(benchmark::State& state)
+{
+	const auto reports = reportStream();
+	const auto readValueMap = N4_DECODE_TABLE.readValueMap();
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		const auto& report = reports[i++ & (reports.size() - 1)];
+		benchmark::DoNotOptimize(legacyDecode(readValueMap, report.first, report.second));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DecodeLegacy);
+
+void BM_DecodeTable(benchmark::State& state)
+{
+	const auto reports = reportStream();
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		const auto& report = reports[i++ & (reports.size() - 1)];
+		benchmark::DoNotOptimize(N4_DECODE_TABLE.decode(report.first, report.second));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DecodeTable);
+}
+
+BENCHMARK_MAIN();
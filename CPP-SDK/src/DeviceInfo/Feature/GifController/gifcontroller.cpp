@@ -5,12 +5,11 @@
 GifController::GifController(StreamDock* instance)
 	: _instance(instance)
 {
-	startWorkerThread();
 }
 
 GifController::~GifController()
 {
-	stopWorkerThread();
+	_frameTimer.cancel();
 }
 
 void GifController::setKeyGifFile(const std::string& gifPath, uint8_t keyValue)
@@ -44,8 +43,13 @@ void GifController::setKeyGifFile(const std::string& gifPath, uint8_t keyValue)
 		frameDelays.push_back(frame.delayMs);
 	}
 
-	std::lock_guard<std::mutex> lock(_gifMutex);
-	_gifMap.insert_or_assign(keyValue, GifStreamStatus{ gifFrames, frameDelays, 0, 0 });
+	{
+		std::lock_guard<std::mutex> lock(_gifMutex);
+		_gifMap.insert_or_assign(keyValue, GifStreamStatus{ gifFrames, frameDelays, 0, 0 });
+	}
+	if (_instance->_journal)
+		_instance->_journal->setAnimation(keyValue, gifFrames, frameDelays);
+	kickFrameTimer();
 }
 
 void GifController::setKeyGifStream(const std::vector<std::string>& gifStream, const std::vector<uint16_t>& frameDelays, uint8_t keyValue)
@@ -54,8 +58,13 @@ void GifController::setKeyGifStream(const std::vector<std::string>& gifStream, c
 		return;
 	if (_instance->_transport && _instance->_transport->canWrite() && _instance->_feature->isDualDevice)
 	{
-		std::lock_guard<std::mutex> lock(_gifMutex);
-		_gifMap[keyValue] = GifStreamStatus{ gifStream, frameDelays, 0, 0 };
+		{
+			std::lock_guard<std::mutex> lock(_gifMutex);
+			_gifMap[keyValue] = GifStreamStatus{ gifStream, frameDelays, 0, 0 };
+		}
+		if (_instance->_journal)
+			_instance->_journal->setAnimation(keyValue, gifStream, frameDelays);
+		kickFrameTimer();
 	}
 }
 
@@ -97,8 +106,13 @@ void GifController::setBackgroundGifFile(const std::string& gifPath, int16_t bac
 
 	_background_place_x = background_place_x;
 	_background_place_y = background_place_y;
-	std::lock_guard<std::mutex> lock(_gifMutex);
-	_gifMap.insert_or_assign(0, GifStreamStatus{ gifFrames, frameDelays, 0, 0 });   /// Index 0 reserved for background GIF
+	{
+		std::lock_guard<std::mutex> lock(_gifMutex);
+		_gifMap.insert_or_assign(0, GifStreamStatus{ gifFrames, frameDelays, 0, 0 });   /// Index 0 reserved for background GIF
+	}
+	if (_instance->_journal)
+		_instance->_journal->setBackgroundAnimation(gifFrames, frameDelays, _background_place_x, _background_place_y, FBlayer);
+	kickFrameTimer();
 }
 
 void GifController::setBackgroundGifStream(const std::vector<std::string>& gifStream, const std::vector<uint16_t>& frameDelays, int16_t background_place_x, uint16_t background_place_y, uint8_t FBlayer)
@@ -109,8 +123,13 @@ void GifController::setBackgroundGifStream(const std::vector<std::string>& gifSt
 	{
 		_background_place_x = background_place_x;
 		_background_place_y = background_place_y;
-		std::lock_guard<std::mutex> lock(_gifMutex);
-		_gifMap[0] = GifStreamStatus{ gifStream, frameDelays, 0, 0 };
+		{
+			std::lock_guard<std::mutex> lock(_gifMutex);
+			_gifMap[0] = GifStreamStatus{ gifStream, frameDelays, 0, 0 };
+		}
+		if (_instance->_journal)
+			_instance->_journal->setBackgroundAnimation(gifStream, frameDelays, _background_place_x, _background_place_y, FBlayer);
+		kickFrameTimer();
 	}
 }
 
@@ -146,6 +165,8 @@ void GifController::clearKeyGif(uint8_t keyValue)
 	{
 		std::lock_guard<std::mutex> lock(_gifMutex);
 		_gifMap.erase(keyValue);
+		if (_instance->_journal)
+			_instance->_journal->clearAnimation(keyValue);
 	}
 }
 
@@ -157,6 +178,8 @@ void GifController::clearBackgroundyGif()
 	{
 		std::lock_guard<std::mutex> lock(_gifMutex);
 		_gifMap.erase(0);
+		if (_instance->_journal)
+			_instance->_journal->clearAnimation(0);
 	}
 }
 
@@ -165,8 +188,12 @@ void GifController::startGifLoop()
 	if (!_instance)
 		return;
 	if (_instance->_transport && _instance->_transport->canWrite() && _instance->_feature->isDualDevice)
+	{
 		_gifLoopEnabled = true;
-	_gifCv.notify_all();
+		if (_instance->_journal)
+			_instance->_journal->setGifLoopRunning(true);
+	}
+	kickFrameTimer();
 }
 
 void GifController::stopGifLoop()
@@ -174,100 +201,116 @@ void GifController::stopGifLoop()
 	if (!_instance)
 		return;
 	if (_instance->_transport && _instance->_transport->canWrite() && _instance->_feature->isDualDevice)
+	{
 		_gifLoopEnabled = false;
+		if (_instance->_journal)
+			_instance->_journal->setGifLoopRunning(false);
+	}
+	if (_gifLoopEnabled)
+		return;
+	_frameTimer.cancel(); // Must not hold _gifMutex: waits for a running tick
+	std::lock_guard<std::mutex> lock(_gifMutex);
+	_frameScheduled = false;
+}
+
+void GifController::kickFrameTimer()
+{
+	if (!_gifLoopEnabled)
+		return;
+	std::lock_guard<std::mutex> lock(_gifMutex);
+	if (_frameScheduled || _gifMap.empty())
+		return;
+	_frameScheduled = true;
+	_lastTick = std::chrono::steady_clock::now(); // Playback was idle: no elapsed time to catch up on
+	_frameTimer.runAfter(std::chrono::milliseconds(0));
 }
 
 void GifController::gifWorkLoop()
 {
-	if (!_instance || !_instance->canTransportWrite() || !_instance->_feature->isDualDevice) return;
+	if (!_instance || !_instance->_feature->isDualDevice)
+		return;
+	if (!_gifLoopEnabled || !_instance->canTransportWrite())
+	{
+		// Leave the timer idle; startGifLoop() or a new GIF schedules the next tick
+		std::lock_guard<std::mutex> lock(_gifMutex);
+		_frameScheduled = false;
+		return;
+	}
 
-	// Get start time
-	auto lastTime = std::chrono::steady_clock::now();
+	// Compute elapsed time since the previous tick (microseconds)
+	auto currentTime = std::chrono::steady_clock::now();
+	uint64_t nextDueUs = UINT64_MAX;
 
-	while (_running)
+	// Collect GIF frames that need updates
+	std::vector<std::pair<uint8_t, size_t>> framesToUpdate;
 	{
+		std::lock_guard<std::mutex> lock(_gifMutex);
+		auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(currentTime - _lastTick).count();
+		_lastTick = currentTime;
+		for (auto& [index, _gif] : _gifMap)
 		{
-			std::unique_lock<std::mutex> lock(_gifMutex);
-			_gifCv.wait(lock, [this]
-				{ return !_running || _gifLoopEnabled; });
-
-			if (!_instance->canTransportWrite())
-				_running = false;
-			if (!_running)
-				break;
-
-			if (_gifMap.empty()) {
-				lock.unlock();
-				std::this_thread::sleep_for(std::chrono::milliseconds(10));
-				lastTime = std::chrono::steady_clock::now(); // Reset timer to prevent large delta
+			if (_gif.gifFrames.empty() || _gif.frameDelays.empty())
 				continue;
-			}
-		}
 
-		// Compute elapsed time for this frame (microseconds)
-		auto currentTime = std::chrono::steady_clock::now();
-		auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(currentTime - lastTime).count();
-		lastTime = currentTime;
+			// Accumulate time
+			_gif.accumulatedTime += elapsedUs;
 
-		// Collect GIF frames that need updates
-		std::vector<std::pair<uint8_t, size_t>> framesToUpdate;
-		{
-			std::lock_guard<std::mutex> lock(_gifMutex);
-			for (auto& [index, _gif] : _gifMap)
+			// Use the current frame delay
+			uint64_t currentFrameDelay = static_cast<uint64_t>(_gif.frameDelays[_gif.currentFrame % _gif.frameDelays.size()]) * 1000;
+
+			// Check if the current frame delay has been exceeded
+			if (_gif.accumulatedTime >= currentFrameDelay)
 			{
-				if (_gif.gifFrames.empty() || _gif.frameDelays.empty())
-					continue;
-
-				// Accumulate time
-				_gif.accumulatedTime += elapsedUs;
-
-				// Use the current frame delay
-				uint64_t currentFrameDelay = static_cast<uint64_t>(_gif.frameDelays[_gif.currentFrame]) * 1000;
-
-				// Check if the current frame delay has been exceeded
-				if (_gif.accumulatedTime >= currentFrameDelay)
-				{
-					// Update frame index
-					_gif.currentFrame = (_gif.currentFrame + 1) % _gif.gifFrames.size();
-					// Subtract the current frame delay (keep the remainder for precise timing)
-					_gif.accumulatedTime -= currentFrameDelay;
-					framesToUpdate.push_back({index, _gif.currentFrame});
-				}
+				// Update frame index
+				_gif.currentFrame = (_gif.currentFrame + 1) % _gif.gifFrames.size();
+				// Subtract the current frame delay (keep the remainder for precise timing)
+				_gif.accumulatedTime -= currentFrameDelay;
+				framesToUpdate.push_back({index, _gif.currentFrame});
+				currentFrameDelay = static_cast<uint64_t>(_gif.frameDelays[_gif.currentFrame % _gif.frameDelays.size()]) * 1000;
 			}
+
+			// The earliest frame deadline decides when the next tick runs
+			uint64_t remainingUs = currentFrameDelay > _gif.accumulatedTime ? currentFrameDelay - _gif.accumulatedTime : 0;
+			nextDueUs = std::min(nextDueUs, remainingUs);
 		}
+		if (nextDueUs == UINT64_MAX)
+			_frameScheduled = false; // Nothing to play; setting a GIF schedules the next tick
+	}
 
-		// If there are frames to update, perform USB transfer
-		if (!framesToUpdate.empty())
+	// If there are frames to update, perform USB transfer
+	if (!framesToUpdate.empty())
+	{
+		std::lock_guard<std::mutex> lock(_gifMutex);
+		for (const auto& [index, frameIndex] : framesToUpdate)
 		{
-			std::lock_guard<std::mutex> lock(_gifMutex);
-			for (const auto& [index, frameIndex] : framesToUpdate)
-			{
-				auto it = _gifMap.find(index);
-				if (it == _gifMap.end() || it->second.gifFrames.empty())
-					continue;
-
-				const auto& gifFrames = it->second.gifFrames;
-
-				if (index != 0) {
-					_instance->setKeyImgFileStream(gifFrames[frameIndex], index);
-				}
-				else if (index == 0 &&
-					_background_place_x + _instance->getBackgroundGifHelper()->_width <= _instance->getBgImgHelper()->_width &&
-					_background_place_y + _instance->getBackgroundGifHelper()->_height <= _instance->getBgImgHelper()->_height) {
-					setBackgroundGifFileFrame(gifFrames[frameIndex],
-						_instance->getBackgroundGifHelper()->_width, _instance->getBackgroundGifHelper()->_height,
-						_background_place_x, _background_place_y);
-				}
-			}
+			auto it = _gifMap.find(index);
+			if (it == _gifMap.end() || it->second.gifFrames.empty())
+				continue;
 
-			// Batch refresh - refresh once per batch
-			_instance->refresh();
+			const auto& gifFrames = it->second.gifFrames;
+
+			if (index != 0) {
+				_instance->writeKeyImgStream(gifFrames[frameIndex], index, false); // The journal has the whole animation
+			}
+			else if (index == 0 &&
+				_background_place_x + _instance->getBackgroundGifHelper()->_width <= _instance->getBgImgHelper()->_width &&
+				_background_place_y + _instance->getBackgroundGifHelper()->_height <= _instance->getBgImgHelper()->_height) {
+				setBackgroundGifFileFrame(gifFrames[frameIndex],
+					_instance->getBackgroundGifHelper()->_width, _instance->getBackgroundGifHelper()->_height,
+					_background_place_x, _background_place_y);
+			}
 		}
 
-		// Brief sleep to reduce CPU usage (~3 ms)
-		std::this_thread::sleep_for(std::chrono::milliseconds(3));
+		// Batch refresh - refresh once per batch
+		_instance->refresh();
 	}
-	ToolKit::print("[INFO] exit gif worker loop");
+
+	if (nextDueUs == UINT64_MAX)
+		return;
+	// The upload time already counts towards the next frame
+	auto spentUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - currentTime).count();
+	uint64_t delayUs = nextDueUs > static_cast<uint64_t>(spentUs) ? nextDueUs - spentUs : 0;
+	_frameTimer.runAfter(std::chrono::milliseconds((delayUs + 999) / 1000));
 }
 
 bool GifController::gifWorkLoopStatus()
@@ -275,21 +318,6 @@ bool GifController::gifWorkLoopStatus()
 	return _gifLoopEnabled;
 }
 
-void GifController::startWorkerThread()
-{
-	_running = true;
-	_gifThread = std::thread(&GifController::gifWorkLoop, this);
-}
-
-void GifController::stopWorkerThread()
-{
-	_running = false;
-	_gifCv.notify_all();
-	if (_gifThread.joinable())
-		_gifThread.join();
-}
-
-
 void GifController::setBackgroundGifFileFrame(const std::string& stream, uint16_t width, uint16_t height, uint16_t x, uint16_t y, uint8_t FBlayer)
 {
 	if (!_instance)
@@ -1,6 +1,7 @@
 #pragma once
 #include "igifcontroller.h"
 #include "nullgifcontroller.h"
+#include <scheduledtask.h>
 
 class GifController : public IGifController
 {
@@ -26,14 +27,9 @@ public:
 
 private:
 	/**
-	 * @brief Start the internal worker thread for GIF playback.
+	 * @brief Schedule a frame tick now if playback is enabled, GIFs are set and no tick is pending.
 	 */
-	void startWorkerThread();
-
-	/**
-	 * @brief Stop the worker thread.
-	 */
-	void stopWorkerThread();
+	void kickFrameTimer();
 
 	/**
 	 * @brief Draw a single frame to the background framebuffer.
@@ -49,11 +45,10 @@ private:
 	StreamDock* _instance = nullptr;                ///< Parent device instance.
 	/// gif status
 	using GifStreamType = std::vector<std::string>;
-	std::atomic<bool> _running = false;        ///< Worker thread running flag.
 	std::atomic<bool> _gifLoopEnabled = false; ///< Whether GIF looping is enabled.
 	std::mutex _gifMutex;                      ///< Mutex for GIF operations.
-	std::condition_variable _gifCv;            ///< Condition variable for GIF worker wake-up.
-	std::thread _gifThread;                    ///< Worker thread for GIF playback.
+	bool _frameScheduled = false;              ///< A frame tick is pending (guarded by _gifMutex).
+	std::chrono::steady_clock::time_point _lastTick; ///< Time of the previous frame tick (guarded by _gifMutex).
 	struct GifStreamStatus
 	{
 		GifStreamType gifFrames;
@@ -68,4 +63,7 @@ private:
 	// Adaptive timing control (to improve GIF playback smoothness)
 	bool _enableAdaptiveTiming = true;  ///< Enable adaptive delay compensation
 	bool _enablePerformanceLogging = false;  ///< Enable performance logging (debug)
+
+	/// Runs gifWorkLoop() when the next frame is due; declared last so it is cancelled before the GIF state goes away.
+	ScheduledTask _frameTimer{ [this] { gifWorkLoop(); } };
 };
@@ -3,7 +3,7 @@
  * @brief Interface for controlling GIF animations on StreamDock devices.
  *
  * This interface defines methods for setting GIFs on keys and backgrounds,
- * controlling playback, and managing worker threads for animation timing.
+ * and controlling playback; frame timing runs on the shared timer wheel.
  */
 #pragma once
 #include <streamdock.h>
@@ -74,7 +74,7 @@ public:
 	virtual void stopGifLoop() = 0;
 
 	/**
-	 * @brief Worker loop for processing and updating GIF frames.
+	 * @brief Frame tick: advance and upload the GIF frames that are due, then schedule the next tick.
 	 */
 	virtual void gifWorkLoop() = 0;
 
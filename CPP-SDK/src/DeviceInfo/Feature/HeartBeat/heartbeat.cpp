@@ -4,21 +4,22 @@
 HeartBeat::HeartBeat(StreamDock* instance) 
 	: _instance(instance)
 {
-	startWorkerThread();
 }
 
 HeartBeat::~HeartBeat() 
 {
-	stopWorkerThread();
+	_beat.cancel();
 }
 
 void HeartBeat::startHeartBeatLoop()
 {
 	if (!_instance)
 		return;
-	if (_instance->_transport)
-		_HeartBeatLoopEnabled = true;
-	_heartbeatCv.notify_all();
+	if (_instance->_transport && !_HeartBeatLoopEnabled.exchange(true))
+	{
+		std::lock_guard<std::mutex> lock(_supervisorMutex);
+		_beat.runEvery(_options.checkInterval);
+	}
 } 
 
 void HeartBeat::stopHeartBeatLoop()
@@ -27,42 +28,102 @@ void HeartBeat::stopHeartBeatLoop()
 		return;
 	if (_instance->_transport)
 		_HeartBeatLoopEnabled = false;
+	_beat.cancel();
 }
 
 void HeartBeat::heartBeatLoop()
 {
-	if (!_instance || !_instance->canTransportWrite()) return;
+	if (!_instance || !_instance->_transport || !_HeartBeatLoopEnabled)
+		return;
 
-	ToolKit::print("[INFO] heart beat worker started");
+	LinkActivity activity = _instance->_transport->activity();
+	auto now = LinkSupervisor::Clock::now();
+	LinkAction action = LinkAction::None;
+	{
+		std::lock_guard<std::mutex> lock(_supervisorMutex);
+		action = _supervisor.check(_options, activity, now);
+	}
 
-	while (_running)
+	if (action == LinkAction::Keepalive && _instance->canTransportWrite())
+	{
+		/// Send heartbeat packet
+		_instance->heartbeat();
+		std::lock_guard<std::mutex> lock(_supervisorMutex);
+		_supervisor.keepaliveSent(now);
+	}
+	else if (action == LinkAction::Recover)
 	{
+		ToolKit::print("[INFO] link stalled, last transport error", activity.lastErrorCode, "- recovering");
+		bool ok = recoverLink();
+		auto done = LinkSupervisor::Clock::now();
+		std::lock_guard<std::mutex> lock(_supervisorMutex);
+		if (ok)
 		{
-			std::unique_lock<std::mutex> lock(_heartbeatMutex);
-			_heartbeatCv.wait_for(lock, std::chrono::seconds(HEART_BEAT_TIME), [this] {
-				return !_running;
-				});
-
-			if (!_running || !_instance || !_instance->_transport->canWrite())
-				break;
+			_supervisor.recovered(done);
+			ToolKit::print("[INFO] link recovered in ", _supervisor.stats().lastTimeToRecover.count(), " ms");
 		}
+		else
+		{
+			auto delay = _supervisor.recoveryFailed(_options, done);
+			if (delay.count() < 0)
+				ToolKit::print("[ERROR] link recovery failed, giving up until the link moves again");
+			else if (delay < _options.checkInterval)
+			{
+				// Retry sooner than the next periodic check
+				_beat.runAfter(delay);
+				_backoffScheduled = true;
+				return;
+			}
+		}
+	}
 
-		if (!_HeartBeatLoopEnabled) continue;
-		/// Send heartbeat packet
-		_instance->heartbeat();
+	std::lock_guard<std::mutex> lock(_supervisorMutex);
+	if (_backoffScheduled)
+	{
+		_backoffScheduled = false;
+		_beat.runEvery(_options.checkInterval);
+	}
+}
+
+bool HeartBeat::recoverLink()
+{
+	TransportCWrapper *transport = _instance->_transport.get();
+	transport->clearTaskQueue();
+	if (!transport->reopen())
+		return false;
+	std::function<void()> restore;
+	{
+		std::lock_guard<std::mutex> lock(_supervisorMutex);
+		restore = _recoveryCallback;
 	}
-	ToolKit::print("[INFO] exit heart beat worker loop");
+	if (restore)
+		restore();
+	_instance->heartbeat();
+	return transport->activity().consecutiveWriteFailures == 0;
 }
 
-void HeartBeat::startWorkerThread() 
+void HeartBeat::setSupervisorOptions(const LinkSupervisorOptions &options)
 {
-	_running = true;
-	_heartbeatThread = std::thread(&HeartBeat::heartBeatLoop, this);
+	std::lock_guard<std::mutex> lock(_supervisorMutex);
+	_options = options;
+	if (_HeartBeatLoopEnabled && !_backoffScheduled)
+		_beat.runEvery(_options.checkInterval);
 }
-void HeartBeat::stopWorkerThread() 
+
+LinkStats HeartBeat::linkStats()
+{
+	LinkStats stats;
+	{
+		std::lock_guard<std::mutex> lock(_supervisorMutex);
+		stats = _supervisor.stats();
+	}
+	if (_instance && _instance->_transport)
+		stats.activity = _instance->_transport->activity();
+	return stats;
+}
+
+void HeartBeat::setRecoveryCallback(std::function<void()> callback)
 {
-	_running = false;
-	_heartbeatCv.notify_all();
-	if (_heartbeatThread.joinable())
-		_heartbeatThread.join();
+	std::lock_guard<std::mutex> lock(_supervisorMutex);
+	_recoveryCallback = std::move(callback);
 }
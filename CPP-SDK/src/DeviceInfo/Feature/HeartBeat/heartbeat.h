@@ -1,15 +1,17 @@
 /**
  * @file heartbeat.h
- * @brief Concrete implementation of IHeartBeat that periodically sends heartbeat signals to the device.
+ * @brief Concrete implementation of IHeartBeat: activity-aware keepalive and link recovery.
  *
- * This class uses a background worker thread to call the device's `heartbeat()` method
- * at a fixed interval (defined by `HEART_BEAT_TIME`).
+ * While the loop is enabled, the shared timer wheel runs a supervision tick on a CallbackExecutor worker
+ * every `checkInterval`; no thread is kept per device. The tick feeds the transport's LinkActivity to a
+ * LinkSupervisor and sends the device's `heartbeat()` only after `keepaliveIdle` (HEART_BEAT_TIME) without
+ * other writes. A stalled link is recovered by clearing the transport's task queue, reopening the handle,
+ * running the recovery callback and verifying with a heartbeat, retried with backoff a bounded number of times.
  */
 #pragma once
 #include "iheartbeat.h"
 #include "nullheartbeat.h"
-
-constexpr const auto HEART_BEAT_TIME = 10;
+#include <scheduledtask.h>
 
 class HeartBeat : public IHeartBeat
 {
@@ -30,22 +32,29 @@ public:
 	/// @copydoc IHeartBeat::heartBeatLoop
 	virtual void heartBeatLoop() override;
 
-private:
-	/**
-	 * @brief Launch the worker thread for the heartbeat loop.
-	 */
-	void startWorkerThread();
+	/// @copydoc IHeartBeat::setSupervisorOptions
+	virtual void setSupervisorOptions(const LinkSupervisorOptions& options) override;
 
+	/// @copydoc IHeartBeat::linkStats
+	virtual LinkStats linkStats() override;
+
+	/// @copydoc IHeartBeat::setRecoveryCallback
+	virtual void setRecoveryCallback(std::function<void()> callback) override;
+
+private:
 	/**
-	 * @brief Stop the running heartbeat worker thread.
+	 * @brief One recovery attempt: clear the task queue, reopen, restore, verify.
+	 * @return true if the link carries writes again.
 	 */
-	void stopWorkerThread();
+	bool recoverLink();
 
 private:
 	StreamDock* _instance = nullptr;      ///< Pointer to the parent StreamDock device.
-	std::thread _heartbeatThread;         ///< Worker thread for the heartbeat loop.
-	std::atomic<bool> _running = false;   ///< Flag indicating whether the thread is running.
 	std::atomic<bool> _HeartBeatLoopEnabled = false; ///< Flag controlling whether heartbeat loop should continue.
-	std::mutex _heartbeatMutex;           ///< Mutex for synchronizing heartbeat thread state.
-	std::condition_variable _heartbeatCv; ///< Condition variable for worker sleep/wakeup.
+	std::mutex _supervisorMutex;          ///< Guards the members below.
+	LinkSupervisorOptions _options;
+	LinkSupervisor _supervisor;           ///< Run by the tick only; stats read under the mutex.
+	std::function<void()> _recoveryCallback;
+	bool _backoffScheduled = false;       ///< The next tick is an early recovery retry, not the periodic check.
+	ScheduledTask _beat{ [this] { heartBeatLoop(); } }; ///< Supervision tick on the shared timer wheel.
 };
@@ -2,8 +2,8 @@
  * @file iheartbeat.h
  * @brief Defines the interface for heartbeat functionality in StreamDock devices.
  *
- * This interface provides virtual methods for starting and stopping a heartbeat loop,
- * which can be used to periodically notify the device or maintain connection state.
+ * This interface provides virtual methods for starting and stopping link supervision: keepalives
+ * while the link is idle, and detection and recovery of a stalled link.
  */
 #pragma once
 #include <cstdint>
@@ -12,6 +12,8 @@
 #include <mutex>
 #include <atomic>
 #include <condition_variable>
+#include <functional>
+#include "linksupervisor.h"
 
 class StreamDock;
 class IHeartBeat
@@ -20,7 +22,7 @@ public:
 	IHeartBeat() = default;
 	virtual ~IHeartBeat() = default;
 	/**
-	 * @brief Start the heartbeat loop in a background thread.
+	 * @brief Start sending heartbeats periodically.
 	 */
 	virtual void startHeartBeatLoop() = 0;
 
@@ -30,7 +32,24 @@ public:
 	virtual void stopHeartBeatLoop() = 0;
 
 	/**
-	 * @brief Worker loop function executed in a thread.
+	 * @brief Supervision tick: send a keepalive if the link is idle, recover it if stalled.
+	 * Called every LinkSupervisorOptions::checkInterval while the loop is started.
 	 */
 	virtual void heartBeatLoop() = 0;
+
+	/**
+	 * @brief Change keepalive, stall detection and recovery settings. Applies from the next tick.
+	 */
+	virtual void setSupervisorOptions(const LinkSupervisorOptions& options) = 0;
+
+	/**
+	 * @brief Keepalive, stall and recovery counters, with the transport's current activity.
+	 */
+	virtual LinkStats linkStats() = 0;
+
+	/**
+	 * @brief Called (on an executor worker) after the transport was reopened, before the link is verified,
+	 * to restore device state such as brightness and key images.
+	 */
+	virtual void setRecoveryCallback(std::function<void()> callback) = 0;
 };
@@ -0,0 +1,82 @@
+#include "linksupervisor.h"
+#include <algorithm>
+
+LinkAction LinkSupervisor::check(const LinkSupervisorOptions& options, const LinkActivity& activity, Clock::time_point now)
+{
+	if (_recovering)
+	{
+		if (now < _nextAttempt)
+			return LinkAction::None;
+		++_stats.recoveryAttempts;
+		return LinkAction::Recover;
+	}
+
+	// After a stall was given up on, wait for a successful write before judging the link again
+	bool gaveUp = _gaveUpAt != Clock::time_point() && activity.lastTx <= _gaveUpAt;
+	if (!gaveUp && stalled(options, activity, now))
+	{
+		++_stats.stallsDetected;
+		_stallDetected = now;
+		if (!options.recover)
+		{
+			_gaveUpAt = now;
+			return LinkAction::None;
+		}
+		_recovering = true;
+		_attempt = 0;
+		++_stats.recoveryAttempts;
+		return LinkAction::Recover;
+	}
+
+	Clock::time_point lastWrite = std::max(activity.lastTx, _started);
+	if (now - lastWrite >= options.keepaliveIdle)
+		return LinkAction::Keepalive;
+	if (now - std::max(_lastKeepalive, _started) >= options.keepaliveIdle)
+	{
+		// A keepalive interval passed and other traffic kept the link alive
+		++_stats.keepalivesSkipped;
+		_lastKeepalive = now;
+	}
+	return LinkAction::None;
+}
+
+void LinkSupervisor::keepaliveSent(Clock::time_point now)
+{
+	++_stats.keepalivesSent;
+	_lastKeepalive = now;
+}
+
+void LinkSupervisor::recovered(Clock::time_point now)
+{
+	auto took = std::chrono::duration_cast<std::chrono::milliseconds>(now - _stallDetected);
+	++_stats.recoveries;
+	_stats.lastTimeToRecover = took;
+	_stats.maxTimeToRecover = std::max(_stats.maxTimeToRecover, took);
+	_recovering = false;
+	_attempt = 0;
+	_gaveUpAt = Clock::time_point();
+}
+
+std::chrono::milliseconds LinkSupervisor::recoveryFailed(const LinkSupervisorOptions& options, Clock::time_point now)
+{
+	if (++_attempt >= options.maxRecoveryAttempts)
+	{
+		++_stats.failedRecoveries;
+		_recovering = false;
+		_attempt = 0;
+		_gaveUpAt = now;
+		return std::chrono::milliseconds(-1);
+	}
+	auto delay = options.recoveryBackoff * (1 << std::min<uint32_t>(_attempt - 1, 16));
+	_nextAttempt = now + delay;
+	return delay;
+}
+
+bool LinkSupervisor::stalled(const LinkSupervisorOptions& options, const LinkActivity& activity, Clock::time_point now) const
+{
+	if (activity.lastErrorCode == TRANSPORT_ERROR_DEVICE_NOT_CONNECTED || activity.lastErrorCode == TRANSPORT_ERROR_DEVICE_LOST)
+		return false; // Unplugged, not wedged
+	if (activity.consecutiveWriteFailures >= options.stallFailures || activity.consecutiveReadFailures >= options.stallFailures)
+		return true;
+	return activity.consecutiveWriteFailures > 0 && now - std::max(activity.lastTx, _started) >= options.stallTimeout;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file linksupervisor.h
+ * @brief Decides, from a transport's LinkActivity, when a device needs a keepalive or a link recovery.
+ *
+ * A keepalive is only due after the link carried no successful write for `keepaliveIdle`; key images,
+ * GIF frames and other traffic already keep it alive. A stall is a run of failed writes or reads, or
+ * a failure that was not followed by a successful write for `stallTimeout`. Errors that mean the
+ * device is gone (not connected, lost) are not stalls: hotplug handling removes those devices.
+ *
+ * The supervisor only decides; HeartBeat performs the keepalive and the recovery and reports the
+ * outcome back through recovered()/recoveryFailed(). Callers serialize access.
+ */
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <TransportCWrapper.h>
+
+constexpr const auto HEART_BEAT_TIME = 10;
+
+struct LinkSupervisorOptions
+{
+	std::chrono::milliseconds checkInterval{ 1000 };				///< How often activity is inspected.
+	std::chrono::milliseconds keepaliveIdle{ std::chrono::seconds(HEART_BEAT_TIME) };	///< Write-idle time before a keepalive is sent.
+	bool recover = true;											///< Recover stalled links; otherwise only count stalls.
+	uint32_t stallFailures = 3;										///< Consecutive failed writes or reads that make a stall.
+	std::chrono::milliseconds stallTimeout{ 5000 };					///< A failure with no successful write since, for this long, is a stall.
+	uint32_t maxRecoveryAttempts = 3;								///< Reopen attempts per stall.
+	std::chrono::milliseconds recoveryBackoff{ 100 };				///< Delay before the second attempt; doubled for each further one.
+};
+
+struct LinkStats
+{
+	uint64_t keepalivesSent = 0;
+	uint64_t keepalivesSkipped = 0;		///< Keepalive intervals in which other traffic made the keepalive unnecessary.
+	uint64_t stallsDetected = 0;
+	uint64_t recoveries = 0;			///< Stalls ended by a successful recovery.
+	uint64_t failedRecoveries = 0;		///< Stalls where every attempt failed.
+	uint64_t recoveryAttempts = 0;
+	std::chrono::milliseconds lastTimeToRecover{ 0 };	///< Stall detection to verified link.
+	std::chrono::milliseconds maxTimeToRecover{ 0 };
+	LinkActivity activity;				///< Transport counters at the time of the snapshot.
+};
+
+enum class LinkAction : uint8_t
+{
+	None,
+	Keepalive,
+	Recover,	///< Run (or continue) the recovery sequence now.
+};
+
+class LinkSupervisor
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/// Inspect `activity` and return what to do now.
+	LinkAction check(const LinkSupervisorOptions& options, const LinkActivity& activity, Clock::time_point now);
+
+	/// A keepalive was sent at `now`.
+	void keepaliveSent(Clock::time_point now);
+
+	/// The current recovery attempt verified the link.
+	void recovered(Clock::time_point now);
+
+	/// The current recovery attempt failed. Returns the delay before the next one, or a negative value when giving up.
+	std::chrono::milliseconds recoveryFailed(const LinkSupervisorOptions& options, Clock::time_point now);
+
+	bool recovering() const { return _recovering; }
+	const LinkStats& stats() const { return _stats; }
+	void resetStats() { _stats = LinkStats(); }
+
+private:
+	bool stalled(const LinkSupervisorOptions& options, const LinkActivity& activity, Clock::time_point now) const;
+
+	LinkStats _stats;
+	Clock::time_point _started = Clock::now();
+	Clock::time_point _lastKeepalive;		///< Last keepalive sent, or the start of supervision.
+	bool _recovering = false;
+	uint32_t _attempt = 0;
+	Clock::time_point _stallDetected;
+	Clock::time_point _nextAttempt;
+	Clock::time_point _gaveUpAt;			///< A stall that exhausted its attempts; ignored until the link moves again.
+};
@@ -14,4 +14,14 @@ public:
 	virtual void heartBeatLoop() override
 	{
 	}
+	virtual void setSupervisorOptions(const LinkSupervisorOptions& options) override
+	{
+	}
+	virtual LinkStats linkStats() override
+	{
+		return {};
+	}
+	virtual void setRecoveryCallback(std::function<void()> callback) override
+	{
+	}
 };
\ No newline at end of file
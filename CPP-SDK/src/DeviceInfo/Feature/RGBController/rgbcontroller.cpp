@@ -15,7 +15,11 @@ void RGBController::setLedBrightness(uint8_t brightness)
 	if (!_instance)
 		return;
 	if (_instance->_transport && _instance->_transport->canWrite() && _instance->_feature->hasRGBLed)
+	{
 		_instance->_transport->setLedBrightness(brightness);
+		if (_instance->_journal)
+			_instance->_journal->setLedBrightness(brightness);
+	}
 }
 
 void RGBController::setLedColor(uint8_t red, uint8_t green, uint8_t blue)
@@ -23,7 +27,11 @@ void RGBController::setLedColor(uint8_t red, uint8_t green, uint8_t blue)
 	if (!_instance)
 		return;
 	if (_instance->_transport && _instance->_transport->canWrite() && _instance->_feature->hasRGBLed)
+	{
 		_instance->_transport->setLedColor(_instance->_feature->ledCounts, red, green, blue);
+		if (_instance->_journal)
+			_instance->_journal->setLedColor(red, green, blue);
+	}
 }
 
 void RGBController::setSingleLedColor(const std::vector<std::array<uint8_t, 3>> &colors)
@@ -33,7 +41,10 @@ void RGBController::setSingleLedColor(const std::vector<std::array<uint8_t, 3>>
 	if (_instance->_transport && _instance->_transport->canWrite() && _instance->_feature->hasRGBLed)
 	{
 		const auto count = std::min<size_t>(colors.size(), _instance->_feature->ledCounts);
-		_instance->_transport->setSingleLedColor(std::vector<std::array<uint8_t, 3>>(colors.begin(), colors.begin() + count));
+		std::vector<std::array<uint8_t, 3>> used(colors.begin(), colors.begin() + count);
+		_instance->_transport->setSingleLedColor(used);
+		if (_instance->_journal)
+			_instance->_journal->setLedColors(used);
 	}
 }
 
@@ -42,5 +53,9 @@ void RGBController::resetLedColor()
 	if (!_instance)
 		return;
 	if (_instance->_transport && _instance->_transport->canWrite() && _instance->_feature->hasRGBLed)
+	{
 		_instance->_transport->resetLedColor();
+		if (_instance->_journal)
+			_instance->_journal->resetLedColor();
+	}
 }
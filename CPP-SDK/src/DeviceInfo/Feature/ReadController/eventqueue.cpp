@@ -0,0 +1,105 @@
+#include "eventqueue.h"
+#if __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+// Bounded MPMC ring (D. Vyukov): each cell's sequence number says whether it is free for the
+// producer at that position or holds an event for the consumer, so no locks are needed.
+
+EventQueue::EventQueue(size_t capacity)
+{
+	size_t size = 2;
+	while (size < capacity)
+		size <<= 1;
+	_cells.reset(new Cell[size]);
+	for (size_t i = 0; i < size; ++i)
+		_cells[i].sequence.store(i, std::memory_order_relaxed);
+	_mask = size - 1;
+#if __linux__
+	_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+}
+
+EventQueue::~EventQueue()
+{
+#if __linux__
+	if (_fd >= 0)
+		close(_fd);
+#endif
+}
+
+bool EventQueue::push(const DeviceEvent& event)
+{
+	size_t pos = _tail.load(std::memory_order_relaxed);
+	while (true)
+	{
+		Cell& cell = _cells[pos & _mask];
+		size_t sequence = cell.sequence.load(std::memory_order_acquire);
+		intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+		if (diff == 0)
+		{
+			if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				cell.event = event;
+				cell.sequence.store(pos + 1, std::memory_order_release);
+				signal();
+				return true;
+			}
+		}
+		else if (diff < 0)
+		{ // Consumer has not freed this cell yet: full
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else
+			pos = _tail.load(std::memory_order_relaxed);
+	}
+}
+
+bool EventQueue::tryPop(DeviceEvent& event)
+{
+	Cell& cell = _cells[_head & _mask];
+	size_t sequence = cell.sequence.load(std::memory_order_acquire);
+	if (sequence != _head + 1)
+		return false;
+	event = cell.event;
+	cell.sequence.store(_head + _mask + 1, std::memory_order_release);
+	++_head;
+	return true;
+}
+
+size_t EventQueue::drain(DeviceEvent* out, size_t max)
+{
+	// Clear readiness before popping, fd first and flag second: a producer that still sees the flag
+	// set has pushed before the flag is cleared, so the pops below find its event
+	if (_signaled.load(std::memory_order_acquire))
+	{
+#if __linux__
+		uint64_t counter = 0;
+		if (_fd >= 0 && ::read(_fd, &counter, sizeof(counter)) < 0)
+			counter = 0; // EAGAIN: already cleared
+#endif
+		_signaled.exchange(false, std::memory_order_acq_rel);
+	}
+	size_t count = 0;
+	while (count < max && tryPop(out[count]))
+		++count;
+	if (count == max)
+		signal(); // More may be pending; keep the fd readable for level-triggered loops
+	return count;
+}
+
+void EventQueue::signal()
+{
+	if (_signaled.exchange(true, std::memory_order_acq_rel))
+		return;
+#if __linux__
+	if (_fd >= 0)
+	{
+		uint64_t one = 1;
+		if (::write(_fd, &one, sizeof(one)) < 0)
+			_signaled.store(false, std::memory_order_relaxed);
+	}
+#endif
+}
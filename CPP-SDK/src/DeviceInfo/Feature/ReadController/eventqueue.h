@@ -0,0 +1,88 @@
+/**
+ * @file eventqueue.h
+ * @brief Pollable lock-free queue of decoded input events, an alternative to read callbacks.
+ *
+ * Every read loop that has the queue attached pushes one DeviceEvent per decoded report; several
+ * devices can share one queue (multi-producer, single consumer). On Linux fd() is an eventfd that
+ * becomes readable when events arrive, so the queue plugs into an existing epoll/poll/asio loop
+ * without extra threads. On other platforms fd() is -1 and the consumer polls tryPop()/drain().
+ *
+ * The queue is bounded: when it is full, new events are dropped and counted in dropped().
+ *
+ * Example usage:
+ *   auto queue = std::make_shared<EventQueue>();
+ *   device->reader()->setEventQueue(queue);
+ *   epoll_ctl(epfd, EPOLL_CTL_ADD, queue->fd(), &ev);   // EPOLLIN
+ *   ...
+ *   DeviceEvent events[64];
+ *   size_t n = queue->drain(events, 64);   // after epoll_wait reports queue->fd()
+ */
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <streamdockinfo.h>
+
+class StreamDock;
+
+/// One decoded input event.
+struct DeviceEvent
+{
+	StreamDock* device = nullptr;			///< Device that produced the event.
+	uint8_t logicalKey = 0;					///< Key value used with registerReadCallback().
+	RegisterEvent event = RegisterEvent::EveryThing;
+	std::chrono::steady_clock::time_point timestamp;	///< Monotonic time the report was read.
+};
+
+class EventQueue
+{
+public:
+	static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+	/// @param capacity Maximum number of pending events, rounded up to a power of two.
+	explicit EventQueue(size_t capacity = DEFAULT_CAPACITY);
+	~EventQueue();
+	EventQueue(const EventQueue&) = delete;
+	EventQueue& operator=(const EventQueue&) = delete;
+
+	/**
+	 * @brief Append an event. Safe from any number of threads.
+	 * @return false when the queue is full and the event was dropped.
+	 */
+	bool push(const DeviceEvent& event);
+
+	/// Pop one event. Single consumer. Does not clear the fd; use drain() from an fd-driven loop.
+	bool tryPop(DeviceEvent& event);
+
+	/**
+	 * @brief Clear the fd readiness, then pop up to `max` events. Single consumer.
+	 * @return Number of events written to `out`. Call again while it returns `max`.
+	 */
+	size_t drain(DeviceEvent* out, size_t max);
+
+	/// eventfd readable while events may be pending (Linux); -1 elsewhere.
+	int fd() const { return _fd; }
+
+	size_t capacity() const { return _mask + 1; }
+	/// Events dropped because the queue was full.
+	uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		DeviceEvent event;
+	};
+
+	void signal();
+
+	std::unique_ptr<Cell[]> _cells;
+	size_t _mask = 0;
+	alignas(64) std::atomic<size_t> _tail{ 0 };		///< Next position producers claim.
+	alignas(64) size_t _head = 0;					///< Next position the consumer reads.
+	std::atomic<bool> _signaled{ false };			///< fd has been written since the last drain().
+	std::atomic<uint64_t> _dropped{ 0 };
+	int _fd = -1;
+};
@@ -0,0 +1,114 @@
+#include "gesturerecognizer.h"
+#include <algorithm>
+
+GestureRecognizer::GestureRecognizer(std::shared_ptr<TimerWheel> wheel, LongPressHandler onLongPress)
+	: _wheel(std::move(wheel)), _onLongPress(std::move(onLongPress))
+{
+}
+
+GestureRecognizer::~GestureRecognizer()
+{
+	std::vector<TimerWheel::TimerId> timers;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (auto &[logicalKey, key] : _keys)
+		{
+			if (key.longPressTimer != TimerWheel::INVALID_TIMER)
+				timers.push_back(key.longPressTimer);
+		}
+	}
+	for (TimerWheel::TimerId timer : timers)
+		_wheel->cancel(timer); // Waits for a long press that is firing right now
+}
+
+GestureRecognizer::PressResult GestureRecognizer::onPress(const GestureThresholds &thresholds, uint8_t logicalKey, Clock::time_point time, bool wantLongPress, const std::vector<Chord> &chords)
+{
+	PressResult result;
+	TimerWheel::TimerId staleTimer = TimerWheel::INVALID_TIMER;
+	uint64_t generation = 0;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		Key &key = _keys[logicalKey];
+		staleTimer = key.longPressTimer; // Release was missed; the old timer must not fire
+		key.longPressTimer = TimerWheel::INVALID_TIMER;
+		key.down = true;
+		key.pressTime = time;
+		generation = ++key.generation;
+
+		if (key.tapArmed && time - key.lastTapTime <= thresholds.doubleTap)
+		{
+			result.doubleTap = true;
+			key.tapArmed = false; // A third tap starts a new pair
+		}
+		else
+		{
+			key.tapArmed = true;
+			key.lastTapTime = time;
+		}
+
+		size_t best = 0;
+		for (size_t i = 0; i < chords.size(); ++i)
+		{
+			const Chord &chord = chords[i];
+			if (chord.size() < 2 || chord.size() <= best || !std::binary_search(chord.begin(), chord.end(), logicalKey))
+				continue;
+			if (std::find(_firedChords.begin(), _firedChords.end(), chord) != _firedChords.end())
+				continue;
+			Clock::time_point first = time;
+			bool held = std::all_of(chord.begin(), chord.end(), [&](uint8_t member)
+									{
+										auto it = _keys.find(member);
+										if (it == _keys.end() || !it->second.down)
+											return false;
+										first = std::min(first, it->second.pressTime);
+										return true; });
+			if (held && time - first <= thresholds.chordWindow)
+			{
+				result.chord = static_cast<int>(i);
+				best = chord.size();
+			}
+		}
+		if (result.chord >= 0)
+			_firedChords.push_back(chords[result.chord]);
+	}
+	if (staleTimer != TimerWheel::INVALID_TIMER)
+		_wheel->cancel(staleTimer);
+	if (wantLongPress)
+	{
+		TimerWheel::TimerId timer = _wheel->schedule(thresholds.longPress, [this, logicalKey, generation]
+													 { fireLongPress(logicalKey, generation); });
+		std::lock_guard<std::mutex> lock(_mutex);
+		_keys[logicalKey].longPressTimer = timer;
+	}
+	return result;
+}
+
+void GestureRecognizer::onRelease(uint8_t logicalKey)
+{
+	TimerWheel::TimerId timer = TimerWheel::INVALID_TIMER;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		Key &key = _keys[logicalKey];
+		key.down = false;
+		++key.generation;
+		timer = key.longPressTimer;
+		key.longPressTimer = TimerWheel::INVALID_TIMER;
+		_firedChords.erase(std::remove_if(_firedChords.begin(), _firedChords.end(), [logicalKey](const Chord &chord)
+										  { return std::binary_search(chord.begin(), chord.end(), logicalKey); }),
+						   _firedChords.end());
+	}
+	if (timer != TimerWheel::INVALID_TIMER)
+		_wheel->cancel(timer);
+}
+
+void GestureRecognizer::fireLongPress(uint8_t logicalKey, uint64_t generation)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = _keys.find(logicalKey);
+		if (it == _keys.end() || !it->second.down || it->second.generation != generation)
+			return; // Released (or pressed again) since the timer was armed
+	}
+	// longPressTimer stays set until release, so the destructor's cancel() waits for this call
+	_onLongPress(logicalKey);
+}
@@ -0,0 +1,81 @@
+/**
+ * @file gesturerecognizer.h
+ * @brief Long-press, double-tap and chord recognition on top of decoded press/release events.
+ *
+ * The read loop feeds every KeyPress/KnobPress and KeyRelease/KnobRelease here; plain press and
+ * release callbacks still fire as before, gestures come on top:
+ *
+ *   - LongPress: the key is still held `longPress` after it went down. Timed on the shared TimerWheel,
+ *     so pending long presses of every key on every device cost one wheel entry each, not a thread.
+ *   - DoubleTap: a key goes down again within `doubleTap` of its previous press. A third tap starts over.
+ *   - Chord: every key of a registered key set is held and they all went down within `chordWindow`.
+ *     Fires once until one of its keys is released.
+ */
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <timerwheel.h>
+
+struct GestureThresholds
+{
+	std::chrono::milliseconds longPress{ 500 };	///< Hold time before LongPress.
+	std::chrono::milliseconds doubleTap{ 300 };	///< Maximum time between the two presses of a DoubleTap.
+	std::chrono::milliseconds chordWindow{ 50 };	///< Maximum spread of the presses forming a Chord.
+};
+
+class GestureRecognizer
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	using Chord = std::vector<uint8_t>;	///< Sorted, distinct logical keys.
+	/// Called on the timer wheel thread when a long press completes.
+	using LongPressHandler = std::function<void(uint8_t logicalKey)>;
+
+	/// Gestures completed by one press.
+	struct PressResult
+	{
+		bool doubleTap = false;
+		int chord = -1;		///< Index into the `chords` passed to onPress(), or -1.
+	};
+
+	GestureRecognizer(std::shared_ptr<TimerWheel> wheel, LongPressHandler onLongPress);
+	/// Cancels pending long presses; returns once none of them is running.
+	~GestureRecognizer();
+
+	GestureRecognizer(const GestureRecognizer&) = delete;
+	GestureRecognizer& operator=(const GestureRecognizer&) = delete;
+
+	/**
+	 * @brief A key went down.
+	 * @param wantLongPress Arm a long-press timer for this key.
+	 * @param chords Registered chords; the largest one this press completes is reported.
+	 */
+	PressResult onPress(const GestureThresholds& thresholds, uint8_t logicalKey, Clock::time_point time, bool wantLongPress, const std::vector<Chord>& chords);
+
+	/// A key went up.
+	void onRelease(uint8_t logicalKey);
+
+private:
+	struct Key
+	{
+		bool down = false;
+		Clock::time_point pressTime;
+		Clock::time_point lastTapTime;	///< Press time of the previous tap, for DoubleTap.
+		bool tapArmed = false;			///< lastTapTime can start a DoubleTap.
+		uint64_t generation = 0;		///< Bumped on every press; stale long-press timers check it.
+		TimerWheel::TimerId longPressTimer = TimerWheel::INVALID_TIMER;
+	};
+
+	void fireLongPress(uint8_t logicalKey, uint64_t generation);
+
+	std::shared_ptr<TimerWheel> _wheel;
+	LongPressHandler _onLongPress;
+	std::mutex _mutex;	///< Guards the state below; never held while calling out.
+	std::unordered_map<uint8_t, Key> _keys;
+	std::vector<Chord> _firedChords;	///< Chords that fired and have not had a key released yet.
+};
@@ -4,6 +4,8 @@
  *
  * The IReadController interface allows polling or listening to device data.
  * It supports both raw data callbacks and decoded event callbacks.
+ * Callbacks can be (un)registered from any thread, including from inside a callback; the change
+ * applies from the next report.
  */
 #pragma once
 #include <cstdint>
@@ -14,6 +16,15 @@
 #include <atomic>
 #include <unordered_map>
 #include <condition_variable>
+#include "reportring.h"
+#include "readlatency.h"
+#include "eventqueue.h"
+#include "knobaggregator.h"
+#include "gesturerecognizer.h"
+#include "touchtracker.h"
+#include "readwaiter.h"
+#include <callbackexecutor.h>
+#include <inputreactor.h>
 
 class StreamDock;
 class IReadController
@@ -21,6 +32,10 @@ class IReadController
 public:
 	using ReadCallback = std::function<void()>; ///< Callback for specific key or knob event.
 	using RawReadCallback = std::function<void(const std::vector<uint8_t>&)>; ///< Callback for raw data stream.
+	using RawReportCallback = std::function<void(const ReportView&)>; ///< Callback for raw data stream without a copy; keep the view (or toVector()) to retain the bytes.
+	using EventTimingCallback = std::function<void(const EventTiming&)>; ///< Observer of per-event latency, called after each decoded callback returns.
+	using KnobCallback = std::function<void(const KnobDelta&)>; ///< Callback for merged knob rotation.
+	using TouchCallback = std::function<void(const TouchEvent&)>; ///< Callback for decoded touch-bar events.
 
 	IReadController() = default;
 	virtual ~IReadController() = default;
@@ -32,6 +47,13 @@ public:
 	 */
 	virtual std::vector<uint8_t> read(int32_t timeoutMs = -1) = 0;
 
+	/**
+	 * @brief Read one report into the controller's preallocated report ring.
+	 * @param timeoutMs Timeout in milliseconds (-1 for blocking).
+	 * @return View of the report; empty on timeout or error.
+	 */
+	virtual ReportView readReport(int32_t timeoutMs = -1) = 0;
+
 	/**
 	 * @brief Register a decoded event callback for a specific key/knob value and event type.
 	 * @param realValue Logical key/knob value.
@@ -55,6 +77,107 @@ public:
 	 */
 	virtual void registerRawReadCallback(RawReadCallback callback, bool callbackAsync = false) = 0;
 
+	/**
+	 * @brief Register a raw data callback that receives the report slot itself instead of a vector copy.
+	 * Replaces any callback set with registerRawReadCallback().
+	 * @param callback Function to handle raw data.
+	 * @param callbackAsync Whether to invoke the callback asynchronously.
+	 */
+	virtual void registerRawReportCallback(RawReportCallback callback, bool callbackAsync = false) = 0;
+
+	/**
+	 * @brief Choose the executor that runs callbacks registered with callbackAsync = true.
+	 * Defaults to CallbackExecutor::shared(). Async callbacks for the same key (or the raw callback) run in report order.
+	 * @param executor Executor to use; nullptr restores the shared one.
+	 */
+	virtual void setCallbackExecutor(std::shared_ptr<CallbackExecutor> executor) = 0;
+
+	/**
+	 * @brief Set the thresholds of the gesture layer.
+	 * Gestures are recognized while at least one LongPress/DoubleTap callback (registerReadCallback()) or chord callback
+	 * is registered. They fire only their own callbacks, not EveryThing ones; press and release callbacks fire as usual.
+	 * LongPress callbacks registered synchronously run on an SDK dispatch thread, in order with the device's other
+	 * synchronous callbacks in reactor mode.
+	 */
+	virtual void setGestureThresholds(const GestureThresholds& thresholds) = 0;
+
+	/**
+	 * @brief Register a callback for a set of keys held down together (RegisterEvent::Chord).
+	 * @param keys Logical keys of the chord, at least two; order does not matter.
+	 * @param callback Callback function to trigger.
+	 * @param callbackAsync Whether to invoke the callback asynchronously.
+	 */
+	virtual void registerChordCallback(std::vector<uint8_t> keys, ReadCallback callback, bool callbackAsync = false) = 0;
+
+	/**
+	 * @brief Unregister a chord callback.
+	 * @param keys Logical keys of the chord.
+	 */
+	virtual void unregisterChordCallback(std::vector<uint8_t> keys) = 0;
+
+	/**
+	 * @brief Configure knob rotation coalescing (off by default).
+	 * While enabled, detents of knobs that have a knob callback are merged into KnobDelta events and no longer
+	 * fire their per-detent KnobLeft/KnobRight callbacks. Knobs without a knob callback are unaffected.
+	 */
+	virtual void setKnobCoalescing(const KnobCoalesceOptions& options) = 0;
+
+	/**
+	 * @brief Register a callback for merged rotation of one knob.
+	 * @param knobKey Logical key of either rotation direction of the knob.
+	 * @param callback Function receiving the merged delta.
+	 * @param callbackAsync Whether to invoke the callback asynchronously.
+	 */
+	virtual void registerKnobCallback(uint8_t knobKey, KnobCallback callback, bool callbackAsync = false) = 0;
+
+	/**
+	 * @brief Unregister the knob callback of a knob.
+	 * @param knobKey Logical key of either rotation direction of the knob.
+	 */
+	virtual void unregisterKnobCallback(uint8_t knobKey) = 0;
+
+	/**
+	 * @brief Register the touch-bar callback (models with FeatureOption::hasTouchBar).
+	 * Touch reports are decoded in the read loop; the raw callback is not involved.
+	 * @param callback Function receiving Began, Moved and Ended events.
+	 * @param callbackAsync Whether to invoke the callback asynchronously.
+	 */
+	virtual void registerTouchCallback(TouchCallback callback, bool callbackAsync = false) = 0;
+
+	/**
+	 * @brief Unregister the touch-bar callback.
+	 */
+	virtual void unregisterTouchCallback() = 0;
+
+	/**
+	 * @brief Configure touch phase detection, velocity estimation and move coalescing.
+	 */
+	virtual void setTouchOptions(const TouchOptions& options) = 0;
+
+	/**
+	 * @brief Also push every decoded event into `queue`, for fd/poll driven consumers.
+	 * Registered callbacks still run. Several devices may share one queue.
+	 * @param queue Queue to feed; nullptr to stop.
+	 */
+	virtual void setEventQueue(std::shared_ptr<EventQueue> queue) = 0;
+
+	/**
+	 * @brief Latency histograms of decoded events since creation or the last resetLatencyStats().
+	 */
+	virtual ReadLatencyStats latencyStats() const = 0;
+
+	/**
+	 * @brief Clear the latency histograms.
+	 */
+	virtual void resetLatencyStats() = 0;
+
+	/**
+	 * @brief Observe the timing of every decoded callback (e.g. to log slow events).
+	 * Called on the thread that ran the callback, right after it returns. Keep it cheap.
+	 * @param callback Observer; nullptr to remove it.
+	 */
+	virtual void setEventTimingCallback(EventTimingCallback callback) = 0;
+
 	/**
 	 * @brief Unregister the raw data callback.
 	 */
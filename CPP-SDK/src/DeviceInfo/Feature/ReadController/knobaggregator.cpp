@@ -0,0 +1,70 @@
+#include "knobaggregator.h"
+#include <algorithm>
+#include <cmath>
+
+bool KnobAggregator::add(const KnobCoalesceOptions& options, uint8_t knobKey, int direction, Clock::time_point time, KnobDelta& out)
+{
+	Knob& knob = _knobs[knobKey];
+	if (knob.detents == 0)
+		knob.first = time;
+	knob.pending += direction;
+	++knob.detents;
+	knob.last = time;
+	// Quiet knob, or window already over: deliver now instead of waiting for the next flush
+	if (!knob.delivered || time - knob.lastDelivery >= options.window)
+	{
+		out = take(options, knobKey, knob, time);
+		return true;
+	}
+	return false;
+}
+
+void KnobAggregator::flush(const KnobCoalesceOptions& options, Clock::time_point now, std::vector<KnobDelta>& out)
+{
+	for (auto& [knobKey, knob] : _knobs)
+	{
+		if (knob.detents != 0 && now - knob.lastDelivery >= options.window)
+			out.push_back(take(options, knobKey, knob, now));
+	}
+}
+
+int32_t KnobAggregator::nextDeadlineMs(const KnobCoalesceOptions& options, Clock::time_point now) const
+{
+	int32_t next = -1;
+	for (const auto& [knobKey, knob] : _knobs)
+	{
+		if (knob.detents == 0)
+			continue;
+		auto remaining = std::chrono::ceil<std::chrono::milliseconds>(knob.lastDelivery + options.window - now).count();
+		int32_t ms = remaining > 0 ? static_cast<int32_t>(remaining) : 0;
+		if (next < 0 || ms < next)
+			next = ms;
+	}
+	return next;
+}
+
+KnobDelta KnobAggregator::take(const KnobCoalesceOptions& options, uint8_t knobKey, Knob& knob, Clock::time_point now)
+{
+	KnobDelta result;
+	result.knobKey = knobKey;
+	result.delta = knob.pending;
+	result.detents = knob.detents;
+	result.firstTime = knob.first;
+	result.lastTime = knob.last;
+
+	// Velocity over the time since the previous delivery; a knob coming out of a pause counts as slow
+	std::chrono::duration<double> elapsed = knob.delivered ? now - knob.lastDelivery : options.window * 4;
+	elapsed = std::max<std::chrono::duration<double>>(elapsed, std::chrono::milliseconds(1));
+	result.velocity = knob.detents / elapsed.count();
+	if (options.baseVelocity > 0.0 && result.velocity > options.baseVelocity)
+		result.acceleration = std::min(options.maxAcceleration, 1.0 + options.accelerationGain * (result.velocity / options.baseVelocity - 1.0));
+	result.acceleration = std::max(result.acceleration, 1.0);
+	double scaled = result.delta * result.acceleration;
+	result.acceleratedDelta = static_cast<int32_t>(scaled < 0 ? std::floor(scaled) : std::ceil(scaled));
+
+	knob.pending = 0;
+	knob.detents = 0;
+	knob.lastDelivery = now;
+	knob.delivered = true;
+	return result;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file knobaggregator.h
+ * @brief Merges knob detents into signed deltas with a velocity-based acceleration factor.
+ *
+ * Every knob detent arrives as its own KnobLeft/KnobRight report. With coalescing enabled, the read
+ * loop feeds detents here instead of firing one callback each:
+ *
+ *   - the first detent after a quiet period is delivered at once (no added latency);
+ *   - later detents within `window` of the last delivery are summed and delivered together when the
+ *     window ends, so a fast spin costs one callback per window instead of one per detent.
+ *
+ * Each delivered KnobDelta carries the signed detent count (right positive), the spin velocity in
+ * detents per second and an acceleration factor derived from it, for volume/scrub style handlers.
+ *
+ * Only the read loop thread uses an aggregator; options are passed in on every call.
+ */
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct KnobCoalesceOptions
+{
+	bool enabled = false;
+	std::chrono::milliseconds window{ 40 };	///< Detents closer than this to the last delivery are merged.
+	double baseVelocity = 10.0;				///< Detents per second at or below which acceleration is 1.
+	double accelerationGain = 0.5;			///< Extra factor per multiple of baseVelocity above it.
+	double maxAcceleration = 8.0;			///< Upper bound of the acceleration factor.
+};
+
+struct KnobDelta
+{
+	uint8_t knobKey = 0;		///< Logical key of the knob's left rotation (the key KnobLeft is reported on).
+	int32_t delta = 0;			///< Net detents, right positive.
+	int32_t acceleratedDelta = 0;	///< delta scaled by acceleration and rounded away from zero.
+	uint32_t detents = 0;		///< Detents merged into this delta, in either direction.
+	double velocity = 0.0;		///< Detents per second since the previous delivery.
+	double acceleration = 1.0;	///< Factor in [1, maxAcceleration].
+	std::chrono::steady_clock::time_point firstTime;	///< Read time of the first merged detent.
+	std::chrono::steady_clock::time_point lastTime;		///< Read time of the last merged detent.
+};
+
+class KnobAggregator
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * @brief Feed one detent.
+	 * @param direction -1 for KnobLeft, +1 for KnobRight.
+	 * @param time Read time of the report.
+	 * @return true when `out` holds a delta to deliver now.
+	 */
+	bool add(const KnobCoalesceOptions& options, uint8_t knobKey, int direction, Clock::time_point time, KnobDelta& out);
+
+	/// Append the deltas whose window has ended by `now` to `out`.
+	void flush(const KnobCoalesceOptions& options, Clock::time_point now, std::vector<KnobDelta>& out);
+
+	/// Milliseconds until the earliest pending window ends (0 if already due), or -1 when nothing is pending.
+	int32_t nextDeadlineMs(const KnobCoalesceOptions& options, Clock::time_point now) const;
+
+	/// Forget pending detents, e.g. when coalescing is turned off.
+	void clear() { _knobs.clear(); }
+
+private:
+	struct Knob
+	{
+		int32_t pending = 0;
+		uint32_t detents = 0;
+		Clock::time_point first;
+		Clock::time_point last;
+		Clock::time_point lastDelivery;
+		bool delivered = false;		///< lastDelivery is valid.
+	};
+
+	KnobDelta take(const KnobCoalesceOptions& options, uint8_t knobKey, Knob& knob, Clock::time_point now);
+
+	std::unordered_map<uint8_t, Knob> _knobs;
+};
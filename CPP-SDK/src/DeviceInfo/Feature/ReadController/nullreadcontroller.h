@@ -16,6 +16,10 @@ public:
 	{
 		return {};
 	};
+	virtual ReportView readReport(int32_t timeoutMs = -1) override
+	{
+		return {};
+	}
 	virtual void registerReadCallback(uint8_t realValue, IReadController::ReadCallback callback, RegisterEvent event = RegisterEvent::EveryThing, bool callbackAsync = false) override
 	{
 	}
@@ -25,6 +29,52 @@ public:
 	virtual void registerRawReadCallback(IReadController::RawReadCallback callback, bool callbackAsync = false) override
 	{
 	}
+	virtual void registerRawReportCallback(IReadController::RawReportCallback callback, bool callbackAsync = false) override
+	{
+	}
+	virtual void setCallbackExecutor(std::shared_ptr<CallbackExecutor> executor) override
+	{
+	}
+	virtual void setGestureThresholds(const GestureThresholds& thresholds) override
+	{
+	}
+	virtual void registerChordCallback(std::vector<uint8_t> keys, IReadController::ReadCallback callback, bool callbackAsync = false) override
+	{
+	}
+	virtual void unregisterChordCallback(std::vector<uint8_t> keys) override
+	{
+	}
+	virtual void setKnobCoalescing(const KnobCoalesceOptions& options) override
+	{
+	}
+	virtual void registerKnobCallback(uint8_t knobKey, IReadController::KnobCallback callback, bool callbackAsync = false) override
+	{
+	}
+	virtual void unregisterKnobCallback(uint8_t knobKey) override
+	{
+	}
+	virtual void registerTouchCallback(IReadController::TouchCallback callback, bool callbackAsync = false) override
+	{
+	}
+	virtual void unregisterTouchCallback() override
+	{
+	}
+	virtual void setTouchOptions(const TouchOptions& options) override
+	{
+	}
+	virtual void setEventQueue(std::shared_ptr<EventQueue> queue) override
+	{
+	}
+	virtual ReadLatencyStats latencyStats() const override
+	{
+		return {};
+	}
+	virtual void resetLatencyStats() override
+	{
+	}
+	virtual void setEventTimingCallback(IReadController::EventTimingCallback callback) override
+	{
+	}
 	virtual void unregisterRawReadCallback() override
 	{
 	}
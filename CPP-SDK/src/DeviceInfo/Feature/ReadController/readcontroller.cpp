@@ -1,20 +1,33 @@
 #include "readcontroller.h"
 #include <future>
+#include <algorithm>
 #include <iomanip>
 #include <toolkit.h>
 
 ReadController::ReadController(StreamDock *instance)
 	: _instance(instance)
 {
-	startWorkerThread();
+	_gestures = std::make_unique<GestureRecognizer>(TimerWheel::shared(), [this](uint8_t logicalKey)
+													{ onLongPress(logicalKey); });
+	_waiter = std::make_unique<ReadWaiter>(_instance && _instance->_info ? _instance->_info->devicePath : std::string());
+	std::shared_ptr<InputReactor> reactor = InputReactor::shared();
+	if (!(reactor && reactor->available() && _waiter->available() && attachReactor(reactor)))
+		startWorkerThread();
 }
 
 ReadController::~ReadController()
 {
 	stopWorkerThread();
+	closeDispatch();	// Dispatch tasks still queued do nothing from here on
+	_gestures.reset(); // Waits for a long press that is firing right now
 }
 
 std::vector<uint8_t> ReadController::read(int32_t timeoutMs)
+{
+	return readReport(timeoutMs).toVector();
+}
+
+ReportView ReadController::readReport(int32_t timeoutMs)
 {
 	if (!_instance)
 		return {};
@@ -23,49 +36,322 @@ std::vector<uint8_t> ReadController::read(int32_t timeoutMs)
 		ToolKit::print("[ERROR] Transport is not running or cannot write.");
 		return {};
 	}
-	int64_t length = -1;
-	std::vector<uint8_t> response(2048); // Max response length is 2048 bytes
-	_instance->_transport->read(response.data(), reinterpret_cast<size_t *>(&length), timeoutMs);
+	ReportView report = _reportRing.acquire();
+	int64_t length = readInto(ReportRing::buffer(report), timeoutMs);
 	if (length > 0)
 	{
-		response.resize(length);
-		// ToolKit::printHexBuffer(response);
-		return response;
+		ReportRing::commit(report, static_cast<size_t>(length));
+		return report;
 	}
 	else if (length == -1)
 	{ /// disconnect or other abort
 		stopWorkerThread();
+	}
+	return {};
+}
+
+ReportView ReadController::waitReport(int32_t timeoutMs)
+{
+	if (!_waiter->available())
+		return readReport(timeoutMs < 0 || timeoutMs > READ_LOOP_TIMEOUT ? READ_LOOP_TIMEOUT : timeoutMs);
+	switch (_waiter->wait(timeoutMs < 0 ? IDLE_WAIT_TIMEOUT : timeoutMs))
+	{
+	case ReadWaiter::Result::Readable:
+	{
+		ReportView report = readReport(REPORT_PICKUP_TIMEOUT);
+		// Drop the mirror copy even when the transport had nothing (it took the report in an earlier read):
+		// a copy left behind keeps the node readable and turns the wait into back-to-back timed reads
+		_waiter->consume();
+		return report;
+	}
+	case ReadWaiter::Result::Timeout:
+		return timeoutMs < 0 ? readReport(0) : ReportView(); // Idle timeout: catch a report the mirror missed
+	case ReadWaiter::Result::Error:
+		ToolKit::print("[INFO] Device node not pollable any more, falling back to timed reads.");
+		return readReport(0);
+	case ReadWaiter::Result::Woken:
+	default:
 		return {};
 	}
-	else
+}
+
+bool ReadController::attachReactor(std::shared_ptr<InputReactor> reactor)
+{
+	_running = true;
+	_reactor = std::move(reactor);
+	_reactorSource = _reactor->add(_waiter->deviceFd(), [this]
+								   { return onReactorReady(); });
+	if (_reactorSource != InputReactor::INVALID_SOURCE)
+		return true;
+	_reactor.reset();
+	_running = false;
+	return false;
+}
+
+void ReadController::detachReactor()
+{
+	InputReactor::SourceId source = _reactorSource.exchange(InputReactor::INVALID_SOURCE);
+	if (source == InputReactor::INVALID_SOURCE)
+		return;
+	_reactor->remove(source);
+	TimerWheel::TimerId timer = _deadlineTimer.exchange(TimerWheel::INVALID_TIMER);
+	if (timer != TimerWheel::INVALID_TIMER)
+		TimerWheel::shared()->cancel(timer);
+}
+
+bool ReadController::onReactorReady()
+{
+	if (!_running || !_readLoopEnabled)
+		return false; // startReadLoop() re-arms
+	if (!_instance->_transport->canWrite())
 	{
-		// ToolKit::print("No data received.");
+		_running = false;
+		detachReactor();
+		return false;
 	}
-	return {};
+	// Only the reads happen here; decoding and callbacks run on the dispatch strand, off the reactor workers
+	std::vector<ReportView> reports;
+	ReadWaiter::Result result = ReadWaiter::Result::Timeout;
+	for (int burst = 0; burst < REACTOR_BURST && (result = _waiter->wait(0)) == ReadWaiter::Result::Readable; ++burst)
+	{
+		ReportView report = readReport(REPORT_PICKUP_TIMEOUT);
+		if (!_running)
+			return false; // Transport gone; readReport() already detached us
+		_waiter->consume(); // Also after an empty read, so a stale copy cannot keep re-triggering the reactor
+		if (report.empty())
+			break;
+		reports.push_back(std::move(report));
+	}
+	bool keepWatching = true;
+	if (result == ReadWaiter::Result::Error)
+	{
+		ToolKit::print("[INFO] Device node not pollable any more, input reactor stops serving this device.");
+		detachReactor();
+		keepWatching = false;
+	}
+	postDispatch([this, reports = std::move(reports)]
+				 {
+					 for (const ReportView &report : reports)
+						 processReport(report);
+					 scheduleDeadline(); });
+	return keepWatching;
+}
+
+void ReadController::scheduleDeadline()
+{
+	std::shared_ptr<const CallbackTable> table = callbacks();
+	flushDeadlines(*table);
+	int32_t deadline = nextDeadlineMs(*table);
+	TimerWheel::TimerId previous = _deadlineTimer.exchange(TimerWheel::INVALID_TIMER);
+	if (previous != TimerWheel::INVALID_TIMER)
+		TimerWheel::shared()->cancel(previous);
+	InputReactor::SourceId source = _reactorSource;
+	if (deadline >= 0 && source != InputReactor::INVALID_SOURCE)
+	{
+		// The task only touches the reactor, so it is harmless if it fires after this controller is gone
+		_deadlineTimer = TimerWheel::shared()->schedule(std::chrono::milliseconds(deadline), [reactor = _reactor, source]
+														{ reactor->post(source); });
+	}
+}
+
+void ReadController::postDispatch(std::function<void()> task)
+{
+	dispatchExecutor()->post(executorKey(DISPATCH_CHANNEL), [gate = _dispatchGate, task = std::move(task)]
+							 {
+								 std::lock_guard<std::recursive_mutex> lock(gate->mutex);
+								 if (gate->open)
+									 task(); });
+}
+
+void ReadController::closeDispatch()
+{
+	std::lock_guard<std::recursive_mutex> lock(_dispatchGate->mutex); // Waits for a running dispatch task
+	_dispatchGate->open = false;
+}
+
+std::shared_ptr<CallbackExecutor> ReadController::dispatchExecutor()
+{
+	static std::shared_ptr<CallbackExecutor> executor = std::make_shared<CallbackExecutor>(DISPATCH_WORKERS, CallbackExecutor::DEFAULT_CAPACITY, OverflowPolicy::Unbounded);
+	return executor;
+}
+
+void ReadController::wakeReadLoop()
+{
+	if (_waiter)
+		_waiter->wake();
+}
+
+int64_t ReadController::readInto(uint8_t *buffer, int32_t timeoutMs)
+{
+	int64_t length = -1;
+	_instance->_transport->read(buffer, reinterpret_cast<size_t *>(&length), timeoutMs);
+	return length;
 }
 
 void ReadController::registerReadCallback(uint8_t realValue, IReadController::ReadCallback callback, RegisterEvent event, bool callbackAsync)
 {
-	std::lock_guard<std::mutex> lock(_readMutex);
-	_readCallbackMap[{realValue, event}] = CallbackStructure{callback, callbackAsync};
+	updateCallbacks([&](CallbackTable &table)
+					{ table.readCallbacks[{realValue, event}] = CallbackStructure{callback, callbackAsync}; });
 }
 
 void ReadController::unregisterReadCallback(uint8_t realValue, RegisterEvent event)
 {
-	std::lock_guard<std::mutex> lock(_readMutex);
-	_readCallbackMap.erase({realValue, event});
+	updateCallbacks([&](CallbackTable &table)
+					{ table.readCallbacks.erase({realValue, event}); });
 }
 
 void ReadController::registerRawReadCallback(IReadController::RawReadCallback callback, bool callbackAsync)
 {
-	std::lock_guard<std::mutex> lock(_readMutex);
-	_rawReadCallback = {callback, callbackAsync};
+	if (!callback)
+	{
+		registerRawReportCallback(nullptr, callbackAsync);
+		return;
+	}
+	// Vector callbacks get a per-thread buffer refilled from the slot, so steady-state reads stay allocation free
+	registerRawReportCallback([callback](const ReportView &report)
+							  {
+								  thread_local std::vector<uint8_t> buffer;
+								  report.copyTo(buffer);
+								  callback(buffer); },
+							  callbackAsync);
+}
+
+void ReadController::registerRawReportCallback(IReadController::RawReportCallback callback, bool callbackAsync)
+{
+	updateCallbacks([&](CallbackTable &table)
+					{ table.rawCallback = {callback, callbackAsync}; });
+}
+
+void ReadController::setCallbackExecutor(std::shared_ptr<CallbackExecutor> executor)
+{
+	updateCallbacks([&](CallbackTable &table)
+					{ table.executor = executor ? executor : CallbackExecutor::shared(); });
+}
+
+uint64_t ReadController::executorKey(uint16_t channel) const
+{
+	return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(this)) << 9 | channel;
+}
+
+void ReadController::setGestureThresholds(const GestureThresholds &thresholds)
+{
+	updateCallbacks([&](CallbackTable &table)
+					{ table.gestureThresholds = thresholds; });
+}
+
+void ReadController::registerChordCallback(std::vector<uint8_t> keys, IReadController::ReadCallback callback, bool callbackAsync)
+{
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	if (keys.size() < 2)
+	{
+		ToolKit::print("[ERROR] A chord needs at least two distinct keys.");
+		return;
+	}
+	updateCallbacks([&](CallbackTable &table)
+					{
+						auto it = std::find(table.chords.begin(), table.chords.end(), keys);
+						if (it != table.chords.end())
+							table.chordCallbacks[it - table.chords.begin()] = CallbackStructure{callback, callbackAsync};
+						else
+						{
+							table.chords.push_back(keys);
+							table.chordCallbacks.push_back(CallbackStructure{callback, callbackAsync});
+						} });
+}
+
+void ReadController::unregisterChordCallback(std::vector<uint8_t> keys)
+{
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	updateCallbacks([&](CallbackTable &table)
+					{
+						auto it = std::find(table.chords.begin(), table.chords.end(), keys);
+						if (it == table.chords.end())
+							return;
+						table.chordCallbacks.erase(table.chordCallbacks.begin() + (it - table.chords.begin()));
+						table.chords.erase(it); });
+}
+
+void ReadController::setKnobCoalescing(const KnobCoalesceOptions &options)
+{
+	updateCallbacks([&](CallbackTable &table)
+					{ table.knobOptions = options; });
+}
+
+void ReadController::registerKnobCallback(uint8_t knobKey, IReadController::KnobCallback callback, bool callbackAsync)
+{
+	uint8_t key = knobKeyOf(knobKey);
+	updateCallbacks([&](CallbackTable &table)
+					{ table.knobCallbacks[key] = KnobCallbackStructure{callback, callbackAsync}; });
+}
+
+void ReadController::unregisterKnobCallback(uint8_t knobKey)
+{
+	uint8_t key = knobKeyOf(knobKey);
+	updateCallbacks([&](CallbackTable &table)
+					{ table.knobCallbacks.erase(key); });
+}
+
+void ReadController::registerTouchCallback(IReadController::TouchCallback callback, bool callbackAsync)
+{
+	updateCallbacks([&](CallbackTable &table)
+					{ table.touchCallback = TouchCallbackStructure{callback, callbackAsync}; });
+}
+
+void ReadController::unregisterTouchCallback()
+{
+	updateCallbacks([](CallbackTable &table)
+					{ table.touchCallback = TouchCallbackStructure{}; });
+}
+
+void ReadController::setTouchOptions(const TouchOptions &options)
+{
+	updateCallbacks([&](CallbackTable &table)
+					{ table.touchOptions = options; });
+}
+
+void ReadController::setEventQueue(std::shared_ptr<EventQueue> queue)
+{
+	updateCallbacks([&](CallbackTable &table)
+					{ table.eventQueue = queue; });
+}
+
+ReadLatencyStats ReadController::latencyStats() const
+{
+	return _latency->stats();
+}
+
+void ReadController::resetLatencyStats()
+{
+	_latency->reset();
+}
+
+void ReadController::setEventTimingCallback(IReadController::EventTimingCallback callback)
+{
+	updateCallbacks([&](CallbackTable &table)
+					{ table.timingCallback = callback; });
 }
 
 void ReadController::unregisterRawReadCallback()
 {
-	std::lock_guard<std::mutex> lock(_readMutex);
-	_rawReadCallback = {nullptr, false};
+	updateCallbacks([](CallbackTable &table)
+					{ table.rawCallback = {nullptr, false}; });
+}
+
+void ReadController::updateCallbacks(const std::function<void(CallbackTable &)> &edit)
+{
+	std::lock_guard<std::mutex> lock(_registryMutex);
+	auto table = std::make_shared<CallbackTable>(*callbacks());
+	edit(*table);
+	table->gestures = !table->chords.empty() || std::any_of(table->readCallbacks.begin(), table->readCallbacks.end(), [](const auto &entry)
+															 { return entry.first.second == RegisterEvent::LongPress || entry.first.second == RegisterEvent::DoubleTap; });
+	std::atomic_store(&_callbacks, std::shared_ptr<const CallbackTable>(std::move(table)));
+}
+
+std::shared_ptr<const ReadController::CallbackTable> ReadController::callbacks() const
+{
+	return std::atomic_load(&_callbacks);
 }
 
 void ReadController::startReadLoop()
@@ -75,6 +361,9 @@ void ReadController::startReadLoop()
 	if (_instance->_transport)
 		_readLoopEnabled = true;
 	_readCv.notify_all();
+	InputReactor::SourceId source = _reactorSource;
+	if (source != InputReactor::INVALID_SOURCE)
+		_reactor->rearm(source);
 }
 
 void ReadController::stopReadLoop()
@@ -83,6 +372,7 @@ void ReadController::stopReadLoop()
 		return;
 	if (_instance->_transport)
 		_readLoopEnabled = false;
+	wakeReadLoop(); // Park the loop now instead of after the next report
 }
 
 void ReadController::readLoop()
@@ -102,77 +392,263 @@ void ReadController::readLoop()
 				break;
 		}
 
-		std::vector<uint8_t> response = read(READ_LOOP_TIMEOUT);
-		if (response.empty())
-			continue;
-		if (response.size() < 64)
-		{
-			ToolKit::print("[ERROR] Received response is too short.");
-			continue;
-		}
-		/// Raw data callback handling
-		if (_rawReadCallback.callback)
-		{
-			RawReadCallback callback = _rawReadCallback.callback;
-			if (_rawReadCallback.async_)
-				std::thread([callback, response]
-							{ callback(response); })
-					.detach();
-			else
-				callback(response);
+		// Block until a report or a wake, unless merged knob rotation or a touch end is due sooner
+		int32_t deadline = nextDeadlineMs(*callbacks());
+		ReportView response = waitReport(deadline);
+		if (deadline >= 0)
+			flushDeadlines(*callbacks());
+		if (!response.empty())
+			processReport(response);
+	}
+	ToolKit::print("[INFO] exit read worker loop");
+}
+
+void ReadController::processReport(const ReportView &response)
+{
+	if (response.size() < 64)
+	{
+		ToolKit::print("[ERROR] Received response is too short.");
+		return;
+	}
+	// One snapshot per report: callbacks may (un)register freely, changes apply from the next report
+	std::shared_ptr<const CallbackTable> table = callbacks();
+	/// Raw data callback handling
+	const RawReadCallbackStructure &raw = table->rawCallback;
+	if (raw.callback)
+	{
+		if (raw.async_)
+			table->executor->post(executorKey(RAW_CHANNEL), [callback = raw.callback, response]
+								  { callback(response); });
+		else
+			raw.callback(response);
+	}
+	bool isK1Pro = (_instance->_info->originType == DeviceOriginType::K1Pro);
+	/// Registered event callback handling
+	bool flag = isK1Pro ? response[0] == 0x04 &&response[1] == 0x41 && response[2] == 0x43 && response[3] == 0x4B && response[6] == 0x4F && response[7] == 0x4B : response[0] == 0x41 && response[1] == 0x43 && response[2] == 0x4B && response[5] == 0x4F && response[6] == 0x4B; // Check response header
+	if (!flag)
+	{
+		uint16_t x = 0, y = 0;
+		if (table->touchCallback.callback && _instance->_feature->hasTouchBar && _instance->decodeTouch(response.data(), response.size(), x, y))
+			dispatchTouch(*table, _touchTracker.onPoint(table->touchOptions, x, y, response.timestamp()));
+		return; // If the response header doesn't match, skip processing
+	}
+
+	// K1Pro uses response[10] and response[11]; other devices use response[9] and response[10]
+	size_t readValueOffset = isK1Pro ? 10 : 9;
+	size_t eventValueOffset = isK1Pro ? 11 : 10;
+
+	uint8_t readValue = response[readValueOffset];		 // Get key value
+	uint8_t readEventValue = response[eventValueOffset]; // Get event value
+	DecodedEvent decoded = _instance->decodeEvent(readValue, readEventValue);
+	if (decoded.logicalKey == EventDecodeTable::NO_KEY)
+		return; // If no registered device key value is found, skip processing
+	EventTiming timing;
+	timing.readTime = response.timestamp();
+	timing.decodeTime = EventTiming::Clock::now();
+	timing.logicalKey = decoded.logicalKey; // Actual registered device key value
+	timing.event = decoded.event;
+	if (table->eventQueue)
+		table->eventQueue->push({_instance, decoded.logicalKey, decoded.event, timing.readTime});
+	if (table->knobOptions.enabled && (decoded.event == RegisterEvent::KnobLeft || decoded.event == RegisterEvent::KnobRight))
+	{
+		uint8_t knobKey = knobKeyOf(readValue, decoded.logicalKey);
+		if (table->knobCallbacks.count(knobKey))
+		{ // Merged into a KnobDelta instead of per-detent callbacks
+			KnobDelta delta;
+			if (_knobAggregator.add(table->knobOptions, knobKey, decoded.event == RegisterEvent::KnobRight ? 1 : -1, timing.readTime, delta))
+				dispatchKnob(*table, delta);
+			return;
 		}
-		bool isK1Pro = (_instance->_info->originType == DeviceOriginType::K1Pro);
-		/// Registered event callback handling
-		bool flag = isK1Pro ? response[0] == 0x04 &&response[1] == 0x41 && response[2] == 0x43 && response[3] == 0x4B && response[6] == 0x4F && response[7] == 0x4B : response[0] == 0x41 && response[1] == 0x43 && response[2] == 0x4B && response[5] == 0x4F && response[6] == 0x4B; // Check response header
-		if (!flag)
-			continue; // If the response header doesn't match, skip processing
-
-		// K1Pro uses response[10] and response[11]; other devices use response[9] and response[10]
-		size_t readValueOffset = isK1Pro ? 10 : 9;
-		size_t eventValueOffset = isK1Pro ? 11 : 10;
-
-		uint8_t readValue = response[readValueOffset]; // Get key value
-		uint8_t realValue = 0xFF;					   // Actual registered device key value
-		for (const auto &ite : _instance->_readValueMap)
-		{
-			if (ite.second == readValue)
-			{
-				realValue = ite.first;
-				break;
-			}
+	}
+	// `table` keeps the callbacks alive even if one of them unregisters itself
+	auto exactIt = table->readCallbacks.find({decoded.logicalKey, decoded.event});
+	if (exactIt != table->readCallbacks.end() && exactIt->second.callback)
+	{ // Call the exact-match event callback
+		dispatch(*table, exactIt->first.second, exactIt->second, timing);
+		if (!exactIt->second.async_)
+			std::cout.flush(); // Flush output immediately
+	}
+	auto anyIt = table->readCallbacks.find({decoded.logicalKey, RegisterEvent::EveryThing});
+	if (anyIt != table->readCallbacks.end() && anyIt->second.callback)
+		dispatch(*table, anyIt->first.second, anyIt->second, timing);
+	if (table->gestures)
+		recognizeGestures(*table, timing); // After the press/release callbacks of the same report
+}
+
+void ReadController::dispatch(const CallbackTable &table, RegisterEvent registeredEvent, const CallbackStructure &entry, EventTiming timing)
+{
+	if (!entry.async_)
+	{
+		timing.callbackStart = EventTiming::Clock::now();
+		entry.callback();
+		timing.callbackEnd = EventTiming::Clock::now();
+		_latency->record(timing);
+		if (table.timingCallback)
+			table.timingCallback(timing);
+		return;
+	}
+	// Copy everything the task needs: the table entry may be replaced before it runs
+	timing.async = true;
+	uint64_t coalesceTag = static_cast<uint64_t>(registeredEvent) + 1;
+	table.executor->post(executorKey(timing.logicalKey), [callback = entry.callback, timingCallback = table.timingCallback, latency = _latency, timing]() mutable
+						 {
+							 timing.callbackStart = EventTiming::Clock::now();
+							 callback();
+							 timing.callbackEnd = EventTiming::Clock::now();
+							 latency->record(timing);
+							 if (timingCallback)
+								 timingCallback(timing); },
+						 coalesceTag);
+}
+
+uint8_t ReadController::knobKeyOf(uint8_t hardwareCode, uint8_t logicalKey) const
+{
+	if (_instance->decodeEvent(hardwareCode, 0x00).event == RegisterEvent::KnobLeft)
+		return logicalKey;
+	DecodedEvent partner = _instance->decodeEvent(hardwareCode ^ 0x01, 0x00);
+	if (partner.logicalKey != EventDecodeTable::NO_KEY && partner.event == RegisterEvent::KnobLeft)
+		return partner.logicalKey;
+	return logicalKey;
+}
+
+uint8_t ReadController::knobKeyOf(uint8_t logicalKey) const
+{
+	if (!_instance)
+		return logicalKey;
+	auto it = _instance->_readValueMap.find(logicalKey);
+	return it != _instance->_readValueMap.end() ? knobKeyOf(it->second, logicalKey) : logicalKey;
+}
+
+void ReadController::dispatchKnob(const CallbackTable &table, const KnobDelta &delta)
+{
+	if (delta.delta == 0)
+		return; // Left and right detents cancelled out
+	auto it = table.knobCallbacks.find(delta.knobKey);
+	if (it == table.knobCallbacks.end() || !it->second.callback)
+		return;
+	if (!it->second.async_)
+		it->second.callback(delta);
+	else // No coalesce tag: every delta carries detents that must not be lost
+		table.executor->post(executorKey(KNOB_CHANNEL | delta.knobKey), [callback = it->second.callback, delta]
+							 { callback(delta); });
+}
+
+int32_t ReadController::nextDeadlineMs(const CallbackTable &table) const
+{
+	auto now = KnobAggregator::Clock::now();
+	int32_t knob = _knobAggregator.nextDeadlineMs(table.knobOptions, now);
+	int32_t touch = _touchTracker.nextDeadlineMs(table.touchOptions, now);
+	if (knob < 0 || touch < 0)
+		return knob < 0 ? touch : knob;
+	return knob < touch ? knob : touch;
+}
+
+void ReadController::flushDeadlines(const CallbackTable &table)
+{
+	auto now = KnobAggregator::Clock::now();
+	_dueKnobs.clear();
+	_knobAggregator.flush(table.knobOptions, now, _dueKnobs);
+	for (const KnobDelta &delta : _dueKnobs)
+		dispatchKnob(table, delta);
+	TouchEvent ended;
+	if (_touchTracker.flush(table.touchOptions, now, ended))
+		dispatchTouch(table, ended);
+}
+
+void ReadController::dispatchTouch(const CallbackTable &table, const TouchEvent &event)
+{
+	const TouchCallbackStructure &entry = table.touchCallback;
+	if (!entry.callback)
+		return;
+	if (!entry.async_)
+	{
+		entry.callback(event);
+		return;
+	}
+	if (event.phase == TouchPhase::Moved && table.touchOptions.coalesceMoves)
+	{
+		std::lock_guard<std::mutex> lock(_touchMailbox->mutex);
+		if (_touchMailbox->open)
+		{ // A move task has not run yet and nothing was posted behind it: let it deliver this position instead
+			uint32_t merged = _touchMailbox->open->coalesced + 1;
+			*_touchMailbox->open = event;
+			_touchMailbox->open->coalesced = merged;
+			return;
 		}
-		if (realValue == 0xFF)
-			continue;										 // If no registered device key value is found, skip processing
-		uint8_t readEventValue = response[eventValueOffset]; // Get event value
-		RegisterEvent triggeredEvent = _instance->dispatchEvent(readValue, readEventValue);
+		auto slot = std::make_shared<TouchEvent>(event);
+		_touchMailbox->open = slot;
+		table.executor->post(executorKey(TOUCH_CHANNEL), [callback = entry.callback, mailbox = _touchMailbox, slot]
+							 {
+								 TouchEvent latest;
+								 {
+									 std::lock_guard<std::mutex> lock(mailbox->mutex);
+									 latest = *slot;
+									 if (mailbox->open == slot)
+										 mailbox->open.reset();
+								 }
+								 callback(latest); });
+		return;
+	}
+	{ // Close the mailbox: a later move must be delivered after this event, not merged into the task ahead of it
+		std::lock_guard<std::mutex> lock(_touchMailbox->mutex);
+		_touchMailbox->open.reset();
+	}
+	table.executor->post(executorKey(TOUCH_CHANNEL), [callback = entry.callback, event]
+						 { callback(event); });
+}
+
+void ReadController::recognizeGestures(const CallbackTable &table, const EventTiming &timing)
+{
+	switch (timing.event)
+	{
+	case RegisterEvent::KeyPress:
+	case RegisterEvent::KnobPress:
+	case RegisterEvent::DIPPress:
+	{
+		bool wantLongPress = table.readCallbacks.count({timing.logicalKey, RegisterEvent::LongPress}) != 0;
+		GestureRecognizer::PressResult result = _gestures->onPress(table.gestureThresholds, timing.logicalKey, timing.readTime, wantLongPress, table.chords);
+		if (result.doubleTap)
+			emitGesture(table, timing, RegisterEvent::DoubleTap);
+		if (result.chord >= 0)
 		{
-			std::unique_lock<std::mutex> lock(_readMutex);
-			auto exactIt = _readCallbackMap.find({realValue, triggeredEvent});
-			if (exactIt != _readCallbackMap.end() && exactIt->second.callback)
-			{ // Call the exact-match event callback
-				if (!(exactIt->second.async_))
-				{
-					exactIt->second.callback();
-					std::cout.flush();  // Flush output immediately
-				}
-				else
-					std::thread([exactIt]
-								{ exactIt->second.callback(); })
-						.detach();
-			}
-			auto anyIt = _readCallbackMap.find({realValue, RegisterEvent::EveryThing});
-			if (anyIt != _readCallbackMap.end() && anyIt->second.callback)
-			{
-				if (!(anyIt->second.async_))
-					anyIt->second.callback();
-				else
-					std::thread([anyIt]
-								{ anyIt->second.callback(); })
-						.detach();
-			}
+			EventTiming chordTiming = timing;
+			chordTiming.event = RegisterEvent::Chord;
+			if (table.eventQueue)
+				table.eventQueue->push({_instance, timing.logicalKey, RegisterEvent::Chord, timing.readTime});
+			const CallbackStructure &entry = table.chordCallbacks[result.chord];
+			if (entry.callback)
+				dispatch(table, RegisterEvent::Chord, entry, chordTiming);
 		}
+		break;
 	}
-	ToolKit::print("[INFO] exit read worker loop");
+	case RegisterEvent::KeyRelease:
+	case RegisterEvent::KnobRelease:
+	case RegisterEvent::DIPRelease:
+		_gestures->onRelease(timing.logicalKey);
+		break;
+	default:
+		break;
+	}
+}
+
+void ReadController::emitGesture(const CallbackTable &table, EventTiming timing, RegisterEvent gesture)
+{
+	timing.event = gesture;
+	if (table.eventQueue)
+		table.eventQueue->push({_instance, timing.logicalKey, gesture, timing.readTime});
+	auto it = table.readCallbacks.find({timing.logicalKey, gesture});
+	if (it != table.readCallbacks.end() && it->second.callback)
+		dispatch(table, gesture, it->second, timing);
+}
+
+void ReadController::onLongPress(uint8_t logicalKey)
+{
+	EventTiming timing;
+	timing.logicalKey = logicalKey;
+	timing.readTime = timing.decodeTime = EventTiming::Clock::now(); // Synthesized: no report behind it
+	// Not on the timer wheel thread: every device's heartbeats and deadlines share it
+	postDispatch([this, timing]
+				 { emitGesture(*callbacks(), timing, RegisterEvent::LongPress); });
 }
 
 void ReadController::startWorkerThread()
@@ -184,7 +660,10 @@ void ReadController::startWorkerThread()
 void ReadController::stopWorkerThread()
 {
 	_running = false;
+	detachReactor();
 	_readCv.notify_all();
-	if (_readThread.joinable())
+	wakeReadLoop();
+	// The loop itself stops here when the transport reports a disconnect; the destructor joins it later
+	if (_readThread.joinable() && _readThread.get_id() != std::this_thread::get_id())
 		_readThread.join();
 }
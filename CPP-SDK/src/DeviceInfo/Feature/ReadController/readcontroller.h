@@ -26,6 +26,9 @@ public:
 	/// @copydoc IReadController::read
 	virtual std::vector<uint8_t> read(int32_t timeoutMs = -1) override;
 
+	/// @copydoc IReadController::readReport
+	virtual ReportView readReport(int32_t timeoutMs = -1) override;
+
 	/// @copydoc IReadController::registerReadCallback
 	virtual void registerReadCallback(uint8_t realValue, IReadController::ReadCallback callback, RegisterEvent event = RegisterEvent::EveryThing, bool callbackAsync = false) override;
 
@@ -35,6 +38,51 @@ public:
 	/// @copydoc IReadController::registerRawReadCallback
 	virtual void registerRawReadCallback(IReadController::RawReadCallback callback, bool callbackAsync = false) override;
 
+	/// @copydoc IReadController::registerRawReportCallback
+	virtual void registerRawReportCallback(IReadController::RawReportCallback callback, bool callbackAsync = false) override;
+
+	/// @copydoc IReadController::setCallbackExecutor
+	virtual void setCallbackExecutor(std::shared_ptr<CallbackExecutor> executor) override;
+
+	/// @copydoc IReadController::setGestureThresholds
+	virtual void setGestureThresholds(const GestureThresholds& thresholds) override;
+
+	/// @copydoc IReadController::registerChordCallback
+	virtual void registerChordCallback(std::vector<uint8_t> keys, IReadController::ReadCallback callback, bool callbackAsync = false) override;
+
+	/// @copydoc IReadController::unregisterChordCallback
+	virtual void unregisterChordCallback(std::vector<uint8_t> keys) override;
+
+	/// @copydoc IReadController::setKnobCoalescing
+	virtual void setKnobCoalescing(const KnobCoalesceOptions& options) override;
+
+	/// @copydoc IReadController::registerKnobCallback
+	virtual void registerKnobCallback(uint8_t knobKey, IReadController::KnobCallback callback, bool callbackAsync = false) override;
+
+	/// @copydoc IReadController::unregisterKnobCallback
+	virtual void unregisterKnobCallback(uint8_t knobKey) override;
+
+	/// @copydoc IReadController::registerTouchCallback
+	virtual void registerTouchCallback(IReadController::TouchCallback callback, bool callbackAsync = false) override;
+
+	/// @copydoc IReadController::unregisterTouchCallback
+	virtual void unregisterTouchCallback() override;
+
+	/// @copydoc IReadController::setTouchOptions
+	virtual void setTouchOptions(const TouchOptions& options) override;
+
+	/// @copydoc IReadController::setEventQueue
+	virtual void setEventQueue(std::shared_ptr<EventQueue> queue) override;
+
+	/// @copydoc IReadController::latencyStats
+	virtual ReadLatencyStats latencyStats() const override;
+
+	/// @copydoc IReadController::resetLatencyStats
+	virtual void resetLatencyStats() override;
+
+	/// @copydoc IReadController::setEventTimingCallback
+	virtual void setEventTimingCallback(IReadController::EventTimingCallback callback) override;
+
 	/// @copydoc IReadController::unregisterRawReadCallback
 	virtual void unregisterRawReadCallback() override;
 
@@ -58,13 +106,76 @@ private:
 	 */
 	void stopWorkerThread();
 
-private:
-	StreamDock* _instance = nullptr; ///< StreamDock device instance.
-	std::thread _readThread;         ///< Read loop worker thread.
-	std::atomic<bool> _running = false; ///< Whether the worker thread is active.
-	std::atomic<bool> _readLoopEnabled = false; ///< Whether the read loop should continue running.
-	std::mutex _readMutex;
-	std::condition_variable _readCv;
+	/**
+	 * @brief Read one report into `buffer` (ReportRing::SLOT_SIZE bytes).
+	 * @return Report length, 0 on timeout, -1 when the transport is gone.
+	 */
+	int64_t readInto(uint8_t* buffer, int32_t timeoutMs);
+
+	/**
+	 * @brief Read loop wait: block on _waiter until a report arrives or the loop is woken, then read it.
+	 * Falls back to a timed readReport() where _waiter is not available.
+	 * @param timeoutMs Deadline of pending knob/touch work, or -1.
+	 */
+	ReportView waitReport(int32_t timeoutMs);
+
+	/// Wake the read loop out of waitReport().
+	void wakeReadLoop();
+
+	/**
+	 * @brief Serve this device from `reactor` instead of a read thread.
+	 * @return false when the device fd could not be registered.
+	 */
+	bool attachReactor(std::shared_ptr<InputReactor> reactor);
+
+	/// Stop being served by the reactor. Waits for a running handler unless called from it.
+	void detachReactor();
+
+	/**
+	 * @brief Reactor handler: read the reports the device node signalled and hand them to the dispatch strand,
+	 * which processes them, flushes due knob/touch work and arms a timer for the next deadline.
+	 * Returns false to leave the device disarmed.
+	 */
+	bool onReactorReady();
+
+	/// Flush due knob/touch work and arm the reactor deadline timer; dispatch strand only.
+	void scheduleDeadline();
+
+	/**
+	 * @brief Run `task` on this controller's strand of dispatchExecutor(), unless the controller is being destroyed.
+	 * Tasks run one at a time and in posting order.
+	 */
+	void postDispatch(std::function<void()> task);
+
+	/// Stop running dispatch tasks; waits for one that is running unless called from it.
+	void closeDispatch();
+
+	/**
+	 * @brief Executor for the work a device has no read thread of its own for: report processing in reactor mode
+	 * and long presses, and with them the synchronous callbacks. Unbounded and never hooked, so nothing is lost.
+	 */
+	static std::shared_ptr<CallbackExecutor> dispatchExecutor();
+
+	/**
+	 * @brief Decode one report and dispatch it to the raw, touch, event queue, knob, key and gesture consumers.
+	 * Runs on the read loop thread, or on the controller's dispatch strand in reactor mode.
+	 */
+	void processReport(const ReportView& response);
+
+	static constexpr int32_t IDLE_WAIT_TIMEOUT = 5000; ///< Longest blocking wait; a missed mirror report is picked up after this.
+	static constexpr int32_t REPORT_PICKUP_TIMEOUT = 10; ///< Transport read after the mirror signalled a report.
+	static constexpr int REACTOR_BURST = 16; ///< Reports one reactor run handles before yielding the worker.
+	static constexpr size_t DISPATCH_WORKERS = 4; ///< Workers of dispatchExecutor(), shared by every device.
+
+	/**
+	 * @brief Executor ordering key: one per controller and channel (logical key, or RAW_CHANNEL).
+	 */
+	uint64_t executorKey(uint16_t channel) const;
+
+	static constexpr uint16_t RAW_CHANNEL = 0x100;
+	static constexpr uint16_t KNOB_CHANNEL = 0x200; ///< Or-ed with the knob key.
+	static constexpr uint16_t TOUCH_CHANNEL = 0x300;
+	static constexpr uint16_t DISPATCH_CHANNEL = 0x400; ///< dispatchExecutor() strand.
 
 	struct PairHash {
 		std::size_t operator()(const std::pair<uint8_t, RegisterEvent>& p) const {
@@ -77,13 +188,119 @@ private:
 		bool async_ = false;
 	};
 
-	/// Mapping from (logical key, event) to callback structure.
-	std::unordered_map<std::pair<uint8_t, RegisterEvent>, CallbackStructure, PairHash> _readCallbackMap;
-
 	struct RawReadCallbackStructure {
-		RawReadCallback callback = nullptr;
+		RawReportCallback callback = nullptr;
+		bool async_ = false;
+	};
+
+	struct KnobCallbackStructure {
+		KnobCallback callback = nullptr;
 		bool async_ = false;
 	};
 
-	RawReadCallbackStructure _rawReadCallback = { nullptr, false }; ///< Raw read callback configuration.
+	struct TouchCallbackStructure {
+		TouchCallback callback = nullptr;
+		bool async_ = false;
+	};
+
+	/// Lets dispatch tasks that outlive the controller see that it is gone.
+	struct DispatchGate {
+		std::recursive_mutex mutex; ///< Held while a task runs; recursive so a callback may destroy its controller's reader.
+		bool open = true;
+	};
+
+	/// Latest Moved event waiting for an async touch task; newer moves overwrite it.
+	/// Each task owns its slot, so closing the mailbox keeps what that task will deliver.
+	struct TouchMailbox {
+		std::mutex mutex;
+		std::shared_ptr<TouchEvent> open; ///< Slot of the queued task still taking merges; null once it runs or another phase is posted behind it.
+	};
+
+	/// Everything the read loop needs to dispatch a report. Published snapshots are never modified.
+	struct CallbackTable {
+		/// Mapping from (logical key, event) to callback structure.
+		std::unordered_map<std::pair<uint8_t, RegisterEvent>, CallbackStructure, PairHash> readCallbacks;
+		RawReadCallbackStructure rawCallback; ///< Raw read callback configuration.
+		std::shared_ptr<CallbackExecutor> executor = CallbackExecutor::shared(); ///< Runs async callbacks.
+		EventTimingCallback timingCallback = nullptr; ///< Per-event latency observer.
+		std::shared_ptr<EventQueue> eventQueue; ///< Receives every decoded event when set.
+		KnobCoalesceOptions knobOptions; ///< Knob rotation coalescing settings.
+		std::unordered_map<uint8_t, KnobCallbackStructure> knobCallbacks; ///< Keyed by the knob's KnobLeft logical key.
+		GestureThresholds gestureThresholds; ///< Gesture layer settings.
+		std::vector<GestureRecognizer::Chord> chords; ///< Registered chords, parallel to chordCallbacks.
+		std::vector<CallbackStructure> chordCallbacks;
+		bool gestures = false; ///< Any gesture callback registered; kept up to date by updateCallbacks().
+		TouchCallbackStructure touchCallback; ///< Touch-bar callback.
+		TouchOptions touchOptions; ///< Touch-bar settings.
+	};
+
+	/**
+	 * @brief Copy the current table, apply `edit` and publish the copy.
+	 * Safe from any thread, including from inside a callback; the read loop picks the new table up on its next report.
+	 */
+	void updateCallbacks(const std::function<void(CallbackTable&)>& edit);
+
+	/// Current snapshot, without locking.
+	std::shared_ptr<const CallbackTable> callbacks() const;
+
+	/**
+	 * @brief Run (or post) one decoded callback, timing it into _latency.
+	 * @param registeredEvent Event the callback was registered for; async tasks coalesce per key and registered event.
+	 * @param timing readTime, decodeTime, logicalKey and event already filled in.
+	 */
+	void dispatch(const CallbackTable& table, RegisterEvent registeredEvent, const CallbackStructure& entry, EventTiming timing);
+
+	/**
+	 * @brief Knob identity used by KnobAggregator: the logical key its KnobLeft detents are reported on.
+	 * Every model reports a knob's two directions on adjacent hardware codes (left even, right odd).
+	 */
+	uint8_t knobKeyOf(uint8_t hardwareCode, uint8_t logicalKey) const;
+
+	/// knobKeyOf() for a logical key given by the application.
+	uint8_t knobKeyOf(uint8_t logicalKey) const;
+
+	/// Run (or post) the knob callback for a merged delta.
+	void dispatchKnob(const CallbackTable& table, const KnobDelta& delta);
+
+	/// Milliseconds until the earliest knob window or touch end is due, or -1 when none is pending.
+	int32_t nextDeadlineMs(const CallbackTable& table) const;
+
+	/// Deliver merged knob deltas and touch ends that are due.
+	void flushDeadlines(const CallbackTable& table);
+
+	/// Run (or post) the touch callback; async Moved events go through _touchMailbox, other phases close it so delivery keeps report order.
+	void dispatchTouch(const CallbackTable& table, const TouchEvent& event);
+
+	/// Feed a decoded event to the gesture layer and dispatch the gestures it completes.
+	void recognizeGestures(const CallbackTable& table, const EventTiming& timing);
+
+	/// Queue and dispatch one gesture event for a key.
+	void emitGesture(const CallbackTable& table, EventTiming timing, RegisterEvent gesture);
+
+	/// Long-press timer expired (timer wheel thread); the gesture is dispatched on the dispatch strand.
+	void onLongPress(uint8_t logicalKey);
+
+private:
+	StreamDock* _instance = nullptr; ///< StreamDock device instance.
+	std::thread _readThread;         ///< Read loop worker thread.
+	std::atomic<bool> _running = false; ///< Whether the worker thread is active.
+	std::atomic<bool> _readLoopEnabled = false; ///< Whether the read loop should continue running.
+	std::mutex _readMutex;           ///< Guards the read loop's wait on _readCv only.
+	std::condition_variable _readCv;
+
+	ReportRing _reportRing; ///< Report slots filled by the read loop and by read()/readReport() callers.
+	std::unique_ptr<ReadWaiter> _waiter; ///< Interruptible wait for reports (Linux hidraw).
+	std::shared_ptr<InputReactor> _reactor; ///< Set once in the constructor when a shared reactor serves this device.
+	std::atomic<InputReactor::SourceId> _reactorSource{InputReactor::INVALID_SOURCE};
+	std::atomic<TimerWheel::TimerId> _deadlineTimer{TimerWheel::INVALID_TIMER}; ///< Posts the reactor source when knob/touch work is due.
+	KnobAggregator _knobAggregator; ///< Read loop (or dispatch strand) only.
+	std::vector<KnobDelta> _dueKnobs; ///< Scratch for flushDeadlines(), read loop (or dispatch strand) only.
+	std::unique_ptr<GestureRecognizer> _gestures; ///< Fed by the read loop, long presses fire on the timer wheel.
+	TouchTracker _touchTracker; ///< Read loop (or dispatch strand) only.
+	std::shared_ptr<TouchMailbox> _touchMailbox = std::make_shared<TouchMailbox>(); ///< Shared with async touch tasks.
+	std::shared_ptr<ReadLatencyRecorder> _latency = std::make_shared<ReadLatencyRecorder>(); ///< Shared with async tasks.
+	std::shared_ptr<DispatchGate> _dispatchGate = std::make_shared<DispatchGate>(); ///< Shared with dispatch tasks.
+
+	std::mutex _registryMutex; ///< Serializes writers of _callbacks; readers never take it.
+	std::shared_ptr<const CallbackTable> _callbacks = std::make_shared<const CallbackTable>(); ///< Accessed with std::atomic_load/atomic_store.
 };
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "readlatency.h"
+
+namespace
+{
+	size_t bucketOf(uint64_t ns)
+	{
+		uint64_t us = ns / 1000;
+		size_t bucket = 0;
+		while (us != 0 && bucket < LatencySnapshot::BUCKETS - 1)
+		{
+			us >>= 1;
+			++bucket;
+		}
+		return bucket;
+	}
+
+	uint64_t toNs(std::chrono::nanoseconds duration)
+	{
+		return duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+	}
+}
+
+double LatencySnapshot::meanUs() const
+{
+	return count ? static_cast<double>(totalNs) / count / 1000.0 : 0.0;
+}
+
+double LatencySnapshot::percentileUs(double q) const
+{
+	if (count == 0)
+		return 0.0;
+	q = q < 0.0 ? 0.0 : (q > 1.0 ? 1.0 : q);
+	uint64_t rank = static_cast<uint64_t>(q * (count - 1)) + 1;
+	uint64_t seen = 0;
+	double maxUs = maxNs / 1000.0;
+	for (size_t i = 0; i < BUCKETS; ++i)
+	{
+		seen += buckets[i];
+		if (seen >= rank)
+		{
+			double upperUs = static_cast<double>(uint64_t(1) << i);
+			return upperUs < maxUs ? upperUs : maxUs;
+		}
+	}
+	return maxUs;
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds duration)
+{
+	uint64_t ns = toNs(duration);
+	_buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_totalNs.fetch_add(ns, std::memory_order_relaxed);
+	uint64_t max = _maxNs.load(std::memory_order_relaxed);
+	while (ns > max && !_maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+		;
+}
+
+LatencySnapshot LatencyHistogram::snapshot() const
+{
+	LatencySnapshot snapshot;
+	for (size_t i = 0; i < LatencySnapshot::BUCKETS; ++i)
+		snapshot.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+	snapshot.count = _count.load(std::memory_order_relaxed);
+	snapshot.totalNs = _totalNs.load(std::memory_order_relaxed);
+	snapshot.maxNs = _maxNs.load(std::memory_order_relaxed);
+	return snapshot;
+}
+
+void LatencyHistogram::reset()
+{
+	for (auto& bucket : _buckets)
+		bucket.store(0, std::memory_order_relaxed);
+	_count.store(0, std::memory_order_relaxed);
+	_totalNs.store(0, std::memory_order_relaxed);
+	_maxNs.store(0, std::memory_order_relaxed);
+}
+
+void ReadLatencyRecorder::record(const EventTiming& timing)
+{
+	_readToDecode.record(timing.decodeTime - timing.readTime);
+	_decodeToDispatch.record(timing.callbackStart - timing.decodeTime);
+	_callbackDuration.record(timing.callbackEnd - timing.callbackStart);
+}
+
+ReadLatencyStats ReadLatencyRecorder::stats() const
+{
+	ReadLatencyStats stats;
+	stats.readToDecode = _readToDecode.snapshot();
+	stats.decodeToDispatch = _decodeToDispatch.snapshot();
+	stats.callbackDuration = _callbackDuration.snapshot();
+	return stats;
+}
+
+void ReadLatencyRecorder::reset()
+{
+	_readToDecode.reset();
+	_decodeToDispatch.reset();
+	_callbackDuration.reset();
+}
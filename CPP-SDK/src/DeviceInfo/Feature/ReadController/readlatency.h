@@ -0,0 +1,95 @@
+/**
+ * @file readlatency.h
+ * @brief Input-to-callback latency tracking for the read loop.
+ *
+ * Every decoded event is timed at four points on the monotonic clock:
+ *
+ *     readTime       transport read returned the report
+ *     decodeTime     the report was decoded into (logical key, RegisterEvent)
+ *     callbackStart  the registered callback started (on the read loop, or on an executor worker when async)
+ *     callbackEnd    the callback returned
+ *
+ * ReadLatencyRecorder folds these into three histograms per device, which separate read-loop delay
+ * (read -> decode), dispatch and executor queueing delay (decode -> dispatch) and slow application
+ * callbacks (callback duration). USB delay shows up as gaps before readTime and is not measured here.
+ *
+ * Example usage:
+ *   ReadLatencyStats stats = device->reader()->latencyStats();
+ *   printf("p99 callback %.0f us\n", stats.callbackDuration.percentileUs(0.99));
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <streamdockinfo.h>
+
+/// Timing of one decoded event, as handed to IReadController::setEventTimingCallback().
+struct EventTiming
+{
+	using Clock = std::chrono::steady_clock;
+
+	uint8_t logicalKey = 0;
+	RegisterEvent event = RegisterEvent::EveryThing;
+	bool async = false;			///< Callback ran on the callback executor.
+	Clock::time_point readTime;
+	Clock::time_point decodeTime;
+	Clock::time_point callbackStart;
+	Clock::time_point callbackEnd;
+};
+
+/// Copy of a LatencyHistogram. Bucket 0 counts samples under 1 us; bucket i counts [2^(i-1), 2^i) us.
+struct LatencySnapshot
+{
+	static constexpr size_t BUCKETS = 32;
+
+	uint64_t count = 0;
+	uint64_t totalNs = 0;
+	uint64_t maxNs = 0;
+	std::array<uint64_t, BUCKETS> buckets = {};
+
+	double meanUs() const;
+	/// Upper bound of the bucket holding quantile `q` (0..1), capped at the largest sample. 0 when empty.
+	double percentileUs(double q) const;
+};
+
+/// Lock-free log2 histogram. record() may be called from several threads at once.
+class LatencyHistogram
+{
+public:
+	LatencyHistogram() = default;
+	LatencyHistogram(const LatencyHistogram&) = delete;
+	LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+	void record(std::chrono::nanoseconds duration);
+	LatencySnapshot snapshot() const;
+	void reset();
+
+private:
+	std::array<std::atomic<uint64_t>, LatencySnapshot::BUCKETS> _buckets = {};
+	std::atomic<uint64_t> _count{ 0 };
+	std::atomic<uint64_t> _totalNs{ 0 };
+	std::atomic<uint64_t> _maxNs{ 0 };
+};
+
+struct ReadLatencyStats
+{
+	LatencySnapshot readToDecode;		///< Transport read returned -> event decoded.
+	LatencySnapshot decodeToDispatch;	///< Event decoded -> callback started (includes executor queueing).
+	LatencySnapshot callbackDuration;	///< Callback started -> callback returned.
+};
+
+/// Per-device latency histograms. Shared with async callback tasks, so it may outlive its controller.
+class ReadLatencyRecorder
+{
+public:
+	void record(const EventTiming& timing);
+	ReadLatencyStats stats() const;
+	void reset();
+
+private:
+	LatencyHistogram _readToDecode;
+	LatencyHistogram _decodeToDispatch;
+	LatencyHistogram _callbackDuration;
+};
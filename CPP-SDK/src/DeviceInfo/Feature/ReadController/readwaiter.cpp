@@ -0,0 +1,85 @@
+#include "readwaiter.h"
+#if __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+ReadWaiter::ReadWaiter(const std::string& devicePath)
+{
+#if __linux__
+	if (devicePath.rfind("/dev/hidraw", 0) != 0)
+		return; // libusb backend paths have no device node to poll
+	_deviceFd = ::open(devicePath.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (!available())
+		close();
+#endif
+}
+
+ReadWaiter::~ReadWaiter()
+{
+	close();
+#if __linux__
+	if (_wakeFd >= 0)
+		::close(_wakeFd);
+#endif
+}
+
+ReadWaiter::Result ReadWaiter::wait(int32_t timeoutMs)
+{
+#if __linux__
+	if (!available())
+		return Result::Error;
+	pollfd fds[2] = { { _deviceFd, POLLIN, 0 }, { _wakeFd, POLLIN, 0 } };
+	int ready = ::poll(fds, 2, timeoutMs < 0 ? -1 : timeoutMs);
+	if (ready < 0)
+		return errno == EINTR ? Result::Timeout : Result::Error;
+	if (ready == 0)
+		return Result::Timeout;
+	if (fds[1].revents & POLLIN)
+	{
+		uint64_t counter = 0;
+		if (::read(_wakeFd, &counter, sizeof(counter)) < 0)
+			counter = 0; // Already consumed
+		return Result::Woken;
+	}
+	if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL))
+	{
+		close();
+		return Result::Error;
+	}
+	return Result::Readable;
+#else
+	return Result::Error;
+#endif
+}
+
+void ReadWaiter::consume()
+{
+#if __linux__
+	uint8_t scratch[4096];
+	if (_deviceFd >= 0 && ::read(_deviceFd, scratch, sizeof(scratch)) < 0)
+		return; // EAGAIN: the transport's copy arrived without ours; nothing to drop
+#endif
+}
+
+void ReadWaiter::wake()
+{
+#if __linux__
+	uint64_t one = 1;
+	if (_wakeFd >= 0 && ::write(_wakeFd, &one, sizeof(one)) < 0)
+		return; // Counter saturated: a wake is pending anyway
+#endif
+}
+
+void ReadWaiter::close()
+{
+#if __linux__
+	if (_deviceFd >= 0)
+		::close(_deviceFd);
+#endif
+	_deviceFd = -1;
+}
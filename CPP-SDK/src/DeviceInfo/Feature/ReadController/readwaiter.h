@@ -0,0 +1,60 @@
+/**
+ * @file readwaiter.h
+ * @brief Interruptible wait for the next input report, so the read loop can block without polling.
+ *
+ * The transport library only offers timed reads and cannot be interrupted, so the read loop used to
+ * spin on 100 ms reads. On Linux hidraw every open file receives its own copy of each input report;
+ * the waiter opens a second, read-only handle on the device node and poll()s it together with an
+ * eventfd. When a report arrives the loop discards the mirror copy and fetches the report through the
+ * transport as before; wake() from another thread ends the wait at once.
+ *
+ * Where this is not possible (other platforms, non-hidraw paths, no permission) available() is false and
+ * the loop keeps its timed reads.
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+
+class ReadWaiter
+{
+public:
+	enum class Result
+	{
+		Readable,	///< A report is waiting.
+		Timeout,
+		Woken,		///< wake() was called; the wake is consumed.
+		Error,		///< The device node failed (e.g. unplugged); the waiter is closed.
+	};
+
+	/// @param devicePath hid_device_info::path of the device.
+	explicit ReadWaiter(const std::string& devicePath);
+	~ReadWaiter();
+
+	ReadWaiter(const ReadWaiter&) = delete;
+	ReadWaiter& operator=(const ReadWaiter&) = delete;
+
+	/// Whether wait() can be used.
+	bool available() const { return _deviceFd >= 0 && _wakeFd >= 0; }
+
+	/// Mirror handle on the device node, for registering with an InputReactor; -1 when unavailable.
+	int deviceFd() const { return _deviceFd; }
+
+	/// Block until a report arrives, wake() is called or `timeoutMs` passes (-1: no timeout).
+	Result wait(int32_t timeoutMs);
+
+	/**
+	 * @brief Drop the mirror copy of one report after the transport read it. Call it after every Readable
+	 * wait, also when the transport read came back empty: otherwise the copy keeps the node readable.
+	 */
+	void consume();
+
+	/// End the current or next wait(). Safe from any thread.
+	void wake();
+
+	/// Stop using the device node; available() becomes false.
+	void close();
+
+private:
+	int _deviceFd = -1;
+	int _wakeFd = -1;
+};
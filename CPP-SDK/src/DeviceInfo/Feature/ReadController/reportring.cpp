@@ -0,0 +1,137 @@
+#include "reportring.h"
+#include <cstring>
+
+struct ReportView::Slot
+{
+	std::atomic<uint32_t> refs{ 1 };
+	size_t size = 0;
+	std::chrono::steady_clock::time_point timestamp;
+	uint8_t data[ReportRing::SLOT_SIZE];
+};
+
+ReportView::ReportView(const ReportView& other) : _slot(other._slot)
+{
+	if (_slot)
+		_slot->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+ReportView::ReportView(ReportView&& other) noexcept : _slot(other._slot)
+{
+	other._slot = nullptr;
+}
+
+ReportView& ReportView::operator=(const ReportView& other)
+{
+	if (this != &other)
+	{
+		if (other._slot)
+			other._slot->refs.fetch_add(1, std::memory_order_relaxed);
+		release();
+		_slot = other._slot;
+	}
+	return *this;
+}
+
+ReportView& ReportView::operator=(ReportView&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		_slot = other._slot;
+		other._slot = nullptr;
+	}
+	return *this;
+}
+
+ReportView::~ReportView()
+{
+	release();
+}
+
+void ReportView::release()
+{
+	// The last reference frees the slot: heap overflow slots, or ring slots outliving their ring
+	if (_slot && _slot->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		delete _slot;
+	_slot = nullptr;
+}
+
+const uint8_t* ReportView::data() const
+{
+	return _slot ? _slot->data : nullptr;
+}
+
+size_t ReportView::size() const
+{
+	return _slot ? _slot->size : 0;
+}
+
+std::chrono::steady_clock::time_point ReportView::timestamp() const
+{
+	return _slot ? _slot->timestamp : std::chrono::steady_clock::time_point{};
+}
+
+std::vector<uint8_t> ReportView::toVector() const
+{
+	return std::vector<uint8_t>(begin(), end());
+}
+
+void ReportView::copyTo(std::vector<uint8_t>& out) const
+{
+	out.assign(begin(), end());
+}
+
+ReportRing::ReportRing(size_t slots)
+{
+	_slots.reserve(slots ? slots : 1);
+	for (size_t i = 0; i < _slots.capacity(); ++i)
+		_slots.push_back(new ReportView::Slot());
+}
+
+ReportRing::~ReportRing()
+{
+	// Drop the ring's reference; slots still held by a callback are freed by their last view
+	for (auto* slot : _slots)
+	{
+		if (slot->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			delete slot;
+	}
+}
+
+ReportView ReportRing::acquire()
+{
+	_reports.fetch_add(1, std::memory_order_relaxed);
+	for (size_t n = 0; n < _slots.size(); ++n)
+	{
+		ReportView::Slot* slot = _slots[_cursor.fetch_add(1, std::memory_order_relaxed) % _slots.size()];
+		uint32_t idle = 1; // Only the ring's own reference left
+		if (slot->refs.compare_exchange_strong(idle, 2, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			slot->size = 0;
+			return ReportView(slot);
+		}
+	}
+	_overflows.fetch_add(1, std::memory_order_relaxed);
+	return ReportView(new ReportView::Slot());
+}
+
+uint8_t* ReportRing::buffer(ReportView& view)
+{
+	return view._slot ? view._slot->data : nullptr;
+}
+
+void ReportRing::commit(ReportView& view, size_t length)
+{
+	if (!view._slot)
+		return;
+	view._slot->timestamp = std::chrono::steady_clock::now();
+	view._slot->size = length < SLOT_SIZE ? length : SLOT_SIZE;
+}
+
+ReportRingStats ReportRing::stats() const
+{
+	ReportRingStats stats;
+	stats.reports = _reports.load(std::memory_order_relaxed);
+	stats.overflows = _overflows.load(std::memory_order_relaxed);
+	return stats;
+}
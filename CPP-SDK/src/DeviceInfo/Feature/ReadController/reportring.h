@@ -0,0 +1,90 @@
+/**
+ * @file reportring.h
+ * @brief Preallocated ring of fixed-size HID report slots used by the read loop.
+ *
+ * The read loop fills one slot per input report instead of allocating a fresh buffer. Slots are
+ * handed to callbacks as ref-counted ReportView objects: copying a view only bumps a counter, and a slot is
+ * written again only once every view on it is gone. Handlers that keep the bytes past the callback
+ * either hold on to the view or call toVector(). When every slot is still held, the ring falls back to a
+ * heap slot, so a slow handler costs an allocation but never corrupts a report.
+ */
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ReportRing;
+
+/// Read-only, ref-counted view of one report slot.
+class ReportView
+{
+public:
+	ReportView() = default;
+	ReportView(const ReportView& other);
+	ReportView(ReportView&& other) noexcept;
+	ReportView& operator=(const ReportView& other);
+	ReportView& operator=(ReportView&& other) noexcept;
+	~ReportView();
+
+	const uint8_t* data() const;
+	size_t size() const;
+	bool empty() const { return size() == 0; }
+	uint8_t operator[](size_t index) const { return data()[index]; }
+	/// Monotonic time the transport returned this report.
+	std::chrono::steady_clock::time_point timestamp() const;
+	const uint8_t* begin() const { return data(); }
+	const uint8_t* end() const { return data() + size(); }
+
+	/// Copy the report into a vector the caller owns.
+	std::vector<uint8_t> toVector() const;
+	/// Copy the report into `out`, reusing its capacity.
+	void copyTo(std::vector<uint8_t>& out) const;
+
+private:
+	friend class ReportRing;
+	struct Slot;
+	explicit ReportView(Slot* slot) : _slot(slot) {}
+	void release();
+
+	Slot* _slot = nullptr;
+};
+
+struct ReportRingStats
+{
+	uint64_t reports = 0;		///< Slots handed out.
+	uint64_t overflows = 0;		///< Reports that found every slot held and used a heap slot.
+};
+
+class ReportRing
+{
+public:
+	static constexpr size_t SLOT_SIZE = 2048;	///< Largest input report the transport returns.
+	static constexpr size_t DEFAULT_SLOTS = 16;
+
+	explicit ReportRing(size_t slots = DEFAULT_SLOTS);
+	~ReportRing();
+	ReportRing(const ReportRing&) = delete;
+	ReportRing& operator=(const ReportRing&) = delete;
+
+	/**
+	 * @brief Take the next free slot for writing. Safe from several threads at once (the read loop and
+	 * IReadController::read() callers): a slot is claimed with a compare-and-swap on its reference count.
+	 * @return A view holding the slot; fill it through buffer() and commit().
+	 */
+	ReportView acquire();
+
+	/// Writable storage (SLOT_SIZE bytes) of a view returned by acquire() that has not been shared yet.
+	static uint8_t* buffer(ReportView& view);
+	/// Set the number of valid bytes after the transport filled the slot, and stamp the slot with the current time.
+	static void commit(ReportView& view, size_t length);
+
+	ReportRingStats stats() const;
+
+private:
+	std::vector<ReportView::Slot*> _slots;	///< Each slot carries one reference owned by the ring.
+	std::atomic<size_t> _cursor{ 0 };	///< Next slot to try, modulo the slot count.
+	std::atomic<uint64_t> _reports{ 0 };
+	std::atomic<uint64_t> _overflows{ 0 };
+};
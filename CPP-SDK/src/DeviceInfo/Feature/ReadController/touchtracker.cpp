@@ -0,0 +1,56 @@
+#include "touchtracker.h"
+
+TouchEvent TouchTracker::onPoint(const TouchOptions& options, uint16_t x, uint16_t y, Clock::time_point time)
+{
+	TouchEvent event;
+	event.x = x;
+	event.y = y;
+	event.timestamp = time;
+	if (!_active || time - _last.timestamp >= options.endTimeout)
+	{
+		// A quiet gap the loop had no chance to flush yet still starts a new touch
+		event.phase = TouchPhase::Began;
+		_active = true;
+	}
+	else
+	{
+		event.phase = TouchPhase::Moved;
+		if (options.estimateVelocity)
+		{
+			float seconds = std::chrono::duration<float>(time - _last.timestamp).count();
+			if (seconds > 0.0f)
+			{
+				float weight = options.velocitySmoothing;
+				float vx = (static_cast<float>(x) - _last.x) / seconds;
+				float vy = (static_cast<float>(y) - _last.y) / seconds;
+				event.velocityX = weight * vx + (1.0f - weight) * _last.velocityX;
+				event.velocityY = weight * vy + (1.0f - weight) * _last.velocityY;
+			}
+			else
+			{
+				event.velocityX = _last.velocityX;
+				event.velocityY = _last.velocityY;
+			}
+		}
+	}
+	_last = event;
+	return event;
+}
+
+bool TouchTracker::flush(const TouchOptions& options, Clock::time_point now, TouchEvent& ended)
+{
+	if (!_active || now - _last.timestamp < options.endTimeout)
+		return false;
+	_active = false;
+	ended = _last;
+	ended.phase = TouchPhase::Ended;
+	return true;
+}
+
+int32_t TouchTracker::nextDeadlineMs(const TouchOptions& options, Clock::time_point now) const
+{
+	if (!_active)
+		return -1;
+	auto remaining = std::chrono::ceil<std::chrono::milliseconds>(_last.timestamp + options.endTimeout - now).count();
+	return remaining > 0 ? static_cast<int32_t>(remaining) : 0;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file touchtracker.h
+ * @brief Turns touch-bar coordinate reports into Began/Moved/Ended touch events.
+ *
+ * Touch-bar firmware (N4 Pro) only streams coordinates while a finger is down; it sends no explicit
+ * down/up. The tracker infers the phase from report gaps: the first point after a quiet period is
+ * Began, following points are Moved, and Ended is produced once no point arrived for `endTimeout`.
+ * The read loop shortens its read timeout to nextDeadlineMs() so Ended is not held back.
+ *
+ * Only the read loop thread uses a tracker; options are passed in on every call.
+ */
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+enum class TouchPhase : uint8_t
+{
+	Began,
+	Moved,
+	Ended,
+};
+
+struct TouchEvent
+{
+	uint16_t x = 0;
+	uint16_t y = 0;
+	TouchPhase phase = TouchPhase::Began;
+	std::chrono::steady_clock::time_point timestamp;	///< Monotonic read time of the report (of the last point for Ended).
+	float velocityX = 0.0f;	///< Smoothed velocity in touch units per second; 0 unless TouchOptions::estimateVelocity.
+	float velocityY = 0.0f;
+	uint32_t coalesced = 0;	///< Moved events merged into this one by async delivery.
+};
+
+struct TouchOptions
+{
+	std::chrono::milliseconds endTimeout{ 80 };	///< Report gap that ends a touch.
+	bool estimateVelocity = true;
+	float velocitySmoothing = 0.5f;			///< Weight of the newest sample in the exponential average, (0, 1].
+	bool coalesceMoves = true;				///< Async callbacks: merge Moved events still waiting to run into the newest one (never across another phase).
+};
+
+class TouchTracker
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/// Feed one coordinate report. Returns a Began or Moved event.
+	TouchEvent onPoint(const TouchOptions& options, uint16_t x, uint16_t y, Clock::time_point time);
+
+	/// Produce Ended when the touch has been quiet for endTimeout by `now`.
+	bool flush(const TouchOptions& options, Clock::time_point now, TouchEvent& ended);
+
+	/// Milliseconds until the active touch ends (0 if already due), or -1 when no touch is active.
+	int32_t nextDeadlineMs(const TouchOptions& options, Clock::time_point now) const;
+
+private:
+	bool _active = false;
+	TouchEvent _last;
+};
@@ -0,0 +1,289 @@
+#include "devicecache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+#include <toolkit.h>
+
+namespace
+{
+	constexpr auto CACHE_HEADER = "# StreamDock device cache v1: vid pid serial firmware input output feature flags leds";
+
+	/// Capability flags in file order.
+	bool FeatureOption::* const FEATURE_FLAGS[] = {
+		&FeatureOption::isDualDevice,
+		&FeatureOption::hasSecondScreen,
+		&FeatureOption::hasRGBLed,
+		&FeatureOption::supportBackGroundGif,
+		&FeatureOption::supportTransparentIcon,
+		&FeatureOption::supportKeyJpegPngStream,
+		&FeatureOption::supportConfig,
+		&FeatureOption::hasTouchBar,
+	};
+
+	/// Printable ASCII as is, everything else (and tabs, spaces, backslashes) as \uXXXX or \UXXXXXXXX.
+	std::string escape(const std::wstring& text)
+	{
+		std::string out;
+		for (wchar_t ch : text)
+		{
+			if (ch > 0x20 && ch < 0x7F && ch != L'\\')
+			{
+				out += static_cast<char>(ch);
+				continue;
+			}
+			char buffer[16];
+			if (static_cast<unsigned long>(ch) > 0xFFFF)
+				std::snprintf(buffer, sizeof(buffer), "\\U%08lX", static_cast<unsigned long>(ch));
+			else
+				std::snprintf(buffer, sizeof(buffer), "\\u%04X", static_cast<unsigned int>(ch));
+			out += buffer;
+		}
+		return out;
+	}
+
+	std::wstring unescape(const std::string& text)
+	{
+		std::wstring out;
+		for (size_t i = 0; i < text.size(); ++i)
+		{
+			if (text[i] == '\\' && i + 1 < text.size() && (text[i + 1] == 'u' || text[i + 1] == 'U'))
+			{
+				size_t digits = text[i + 1] == 'u' ? 4 : 8;
+				out += static_cast<wchar_t>(std::stoul(text.substr(i + 2, digits), nullptr, 16));
+				i += 1 + digits;
+				continue;
+			}
+			out += static_cast<wchar_t>(static_cast<unsigned char>(text[i]));
+		}
+		return out;
+	}
+
+	std::wstring widen(const std::string& bytes)
+	{
+		std::wstring out;
+		for (char ch : bytes)
+			out += static_cast<wchar_t>(static_cast<unsigned char>(ch));
+		return out;
+	}
+
+	std::string narrow(const std::wstring& text)
+	{
+		std::string out;
+		for (wchar_t ch : text)
+			out += static_cast<char>(ch);
+		return out;
+	}
+}
+
+void DeviceCacheEntry::applyFeatures(FeatureOption& target) const
+{
+	if (!hasFeatures)
+		return;
+	for (auto flag : FEATURE_FLAGS)
+		target.*flag = features.*flag;
+	target.ledCounts = features.ledCounts;
+}
+
+DeviceCache& DeviceCache::instance()
+{
+	static DeviceCache cache;
+	return cache;
+}
+
+std::string DeviceCache::defaultPath()
+{
+	namespace fs = std::filesystem;
+	fs::path base;
+#if defined(_WIN32)
+	if (const char* local = std::getenv("LOCALAPPDATA"))
+		base = local;
+#elif defined(__APPLE__)
+	if (const char* home = std::getenv("HOME"))
+		base = fs::path(home) / "Library" / "Caches";
+#else
+	if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg)
+		base = xdg;
+	else if (const char* home = std::getenv("HOME"))
+		base = fs::path(home) / ".cache";
+#endif
+	if (base.empty())
+		return std::string();
+	return (base / "streamdock" / "devices.cache").string();
+}
+
+void DeviceCache::setPath(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_path = path;
+	_entries.clear();
+	_loaded = false;
+}
+
+std::string DeviceCache::path() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _path;
+}
+
+void DeviceCache::setEnabled(bool enable)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_enabled = enable;
+}
+
+bool DeviceCache::enabled() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _enabled;
+}
+
+bool DeviceCache::find(uint16_t vid, uint16_t pid, const std::wstring& serial, DeviceCacheEntry& entry)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_enabled || _path.empty() || serial.empty())
+		return false;
+	load();
+	auto it = _entries.find(key(vid, pid, serial));
+	if (it == _entries.end())
+		return false;
+	entry = it->second.entry;
+	return true;
+}
+
+void DeviceCache::store(uint16_t vid, uint16_t pid, const std::wstring& serial, DeviceCacheEntry entry)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_enabled || _path.empty() || serial.empty())
+		return;
+	load();
+	entry.firmwareVersion = trimFirmwareVersion(entry.firmwareVersion);
+	auto& record = _entries[key(vid, pid, serial)];
+	if (!entry.hasFeatures && record.entry.hasFeatures)
+	{
+		// Keep capability overrides across firmware/size updates
+		entry.hasFeatures = true;
+		entry.features = record.entry.features;
+	}
+	record = Record{ vid, pid, serial, std::move(entry) };
+	save();
+}
+
+void DeviceCache::erase(uint16_t vid, uint16_t pid, const std::wstring& serial)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_path.empty())
+		return;
+	load();
+	if (_entries.erase(key(vid, pid, serial)))
+		save();
+}
+
+std::string DeviceCache::trimFirmwareVersion(const std::string& version)
+{
+	return version.substr(0, version.find('\0'));
+}
+
+std::wstring DeviceCache::key(uint16_t vid, uint16_t pid, const std::wstring& serial)
+{
+	return std::to_wstring((static_cast<uint32_t>(vid) << 16) | pid) + L":" + serial;
+}
+
+void DeviceCache::load()
+{
+	if (_loaded)
+		return;
+	_loaded = true;
+	std::ifstream file(_path);
+	if (!file)
+		return; // First start
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+		std::vector<std::string> fields;
+		std::istringstream stream(line);
+		std::string field;
+		while (std::getline(stream, field, '\t'))
+			fields.push_back(field);
+		if (fields.size() != 9)
+		{
+			ToolKit::print("[ERROR] Ignoring malformed device cache line in", _path);
+			continue;
+		}
+		try
+		{
+			Record record;
+			record.vid = static_cast<uint16_t>(std::stoul(fields[0], nullptr, 16));
+			record.pid = static_cast<uint16_t>(std::stoul(fields[1], nullptr, 16));
+			record.serial = unescape(fields[2]);
+			record.entry.firmwareVersion = narrow(unescape(fields[3]));
+			record.entry.inputReportSize = static_cast<uint16_t>(std::stoul(fields[4]));
+			record.entry.outputReportSize = static_cast<uint16_t>(std::stoul(fields[5]));
+			record.entry.featureReportSize = static_cast<uint16_t>(std::stoul(fields[6]));
+			if (fields[7] != "-")
+			{
+				unsigned long flags = std::stoul(fields[7], nullptr, 16);
+				for (size_t i = 0; i < std::size(FEATURE_FLAGS); ++i)
+					record.entry.features.*FEATURE_FLAGS[i] = (flags >> i) & 1;
+				record.entry.features.ledCounts = static_cast<uint16_t>(std::stoul(fields[8]));
+				record.entry.hasFeatures = true;
+			}
+			if (!record.serial.empty())
+				_entries[key(record.vid, record.pid, record.serial)] = std::move(record);
+		}
+		catch (const std::exception&)
+		{
+			ToolKit::print("[ERROR] Ignoring malformed device cache line in", _path);
+		}
+	}
+}
+
+void DeviceCache::save()
+{
+	namespace fs = std::filesystem;
+	std::error_code ec;
+	fs::path target(_path);
+	if (target.has_parent_path())
+		fs::create_directories(target.parent_path(), ec);
+	fs::path temp = target;
+	temp += ".tmp";
+	{
+		std::ofstream file(temp, std::ios::out | std::ios::trunc);
+		if (!file)
+		{
+			ToolKit::print("[ERROR] Failed to write device cache", temp.string());
+			return;
+		}
+		file << CACHE_HEADER << "\n";
+		for (const auto& item : _entries)
+		{
+			const Record& record = item.second;
+			char ids[16];
+			std::snprintf(ids, sizeof(ids), "%04x\t%04x", record.vid, record.pid);
+			file << ids << '\t' << escape(record.serial) << '\t' << escape(widen(record.entry.firmwareVersion)) << '\t'
+				 << record.entry.inputReportSize << '\t' << record.entry.outputReportSize << '\t' << record.entry.featureReportSize << '\t';
+			if (record.entry.hasFeatures)
+			{
+				unsigned long flags = 0;
+				for (size_t i = 0; i < std::size(FEATURE_FLAGS); ++i)
+					flags |= static_cast<unsigned long>(record.entry.features.*FEATURE_FLAGS[i]) << i;
+				char text[16];
+				std::snprintf(text, sizeof(text), "%02lx", flags);
+				file << text << '\t' << record.entry.features.ledCounts;
+			}
+			else
+			{
+				file << "-\t0";
+			}
+			file << "\n";
+		}
+	}
+	fs::rename(temp, target, ec); // Replaces the old file in one step
+	if (ec)
+		ToolKit::print("[ERROR] Failed to write device cache", _path, ec.message());
+}
@@ -0,0 +1,98 @@
+/**
+ * @file devicecache.h
+ * @brief On-disk cache of per-device facts that otherwise cost a round-trip at every start.
+ *
+ * Keyed by VID/PID and serial number, an entry holds the firmware version, the report sizes the device
+ * was driven with and its capability flags. A StreamDock whose entry is cached takes its firmware version
+ * from it (so firmware-dependent setup such as the M18/N3 mode selection or the N1 background gate needs
+ * no query) and applies the sizes and flags in init(), before its controllers are created. DeviceManager
+ * revalidates the firmware version in the background and re-creates the device if it changed.
+ *
+ * The file is plain text, one device per line. Flags are only cached when stored explicitly (or edited into
+ * the file) as capability overrides; without them the model's own flags apply, derived from the cached
+ * firmware version where the model does so. Devices without a serial number are not cached.
+ *
+ * The file lives in the user's cache directory (defaultPath()), never in the working directory. Without
+ * one (no XDG_CACHE_HOME/HOME, or LOCALAPPDATA on Windows) the path is empty and nothing is cached.
+ *
+ * Example usage:
+ *   DeviceCache::instance().setPath("/var/cache/streamdock/devices.cache");
+ *   DeviceCache::instance().setEnabled(false);	// always query the devices
+ */
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <featureoption.h>
+
+struct DeviceCacheEntry
+{
+	std::string firmwareVersion;
+	uint16_t inputReportSize = 0;	///< 0: keep the model's default.
+	uint16_t outputReportSize = 0;
+	uint16_t featureReportSize = 0;
+	bool hasFeatures = false;		///< `features` is valid and overrides the model's flags.
+	FeatureOption features;			///< Only the capability flags and ledCounts are kept.
+
+	/// Copy the cached capability flags and ledCounts into `target` if hasFeatures.
+	void applyFeatures(FeatureOption& target) const;
+};
+
+class DeviceCache
+{
+public:
+	/**
+	 * @brief Per-user cache file: $XDG_CACHE_HOME or ~/.cache on Linux, ~/Library/Caches on macOS,
+	 * %LOCALAPPDATA% on Windows, each followed by streamdock/devices.cache. Empty if none is set.
+	 */
+	static std::string defaultPath();
+
+	static DeviceCache& instance();
+
+	DeviceCache(const DeviceCache&) = delete;
+	DeviceCache& operator=(const DeviceCache&) = delete;
+
+	/// Use another file; the current entries are dropped and the new file is loaded on first use. Empty disables the cache.
+	void setPath(const std::string& path);
+	std::string path() const;
+
+	/// A disabled cache finds nothing and stores nothing (enabled by default).
+	void setEnabled(bool enable);
+	bool enabled() const;
+
+	/// Look up a device. Returns false if it is not cached (or has no serial number).
+	bool find(uint16_t vid, uint16_t pid, const std::wstring& serial, DeviceCacheEntry& entry);
+
+	/// Add or replace a device's entry and write the file. An entry without flags keeps the cached flags.
+	void store(uint16_t vid, uint16_t pid, const std::wstring& serial, DeviceCacheEntry entry);
+
+	/// Forget a device and write the file.
+	void erase(uint16_t vid, uint16_t pid, const std::wstring& serial);
+
+	/// Firmware version as cached: without the NUL padding of the report it was read from.
+	static std::string trimFirmwareVersion(const std::string& version);
+
+private:
+	DeviceCache() = default;
+
+	struct Record
+	{
+		uint16_t vid = 0;
+		uint16_t pid = 0;
+		std::wstring serial;
+		DeviceCacheEntry entry;
+	};
+
+	static std::wstring key(uint16_t vid, uint16_t pid, const std::wstring& serial);
+	/// Read the file once, under `_mutex`.
+	void load();
+	/// Write every entry to a temporary file and move it over the cache file, under `_mutex`.
+	void save();
+
+	mutable std::mutex _mutex;
+	std::string _path = defaultPath();
+	bool _enabled = true;
+	bool _loaded = false;
+	std::unordered_map<std::wstring, Record> _entries;
+};
@@ -0,0 +1,92 @@
+/**
+ * @file eventdecodetable.h
+ * @brief Compile-time lookup table decoding input reports into (logical key, RegisterEvent).
+ *
+ * Each device model lists its keys once as KeyDecode rules: the logical key, the hardware code the
+ * device reports for it (response[9], or response[10] on K1Pro), and the event produced for the two
+ * event bytes the firmware sends (0x00 and 0x01). The rules are folded at compile time into a
+ * 256-entry table indexed by the hardware code, so decoding a report is a single indexed load.
+ *
+ * Usage:
+ *
+ *     static constexpr KeyDecode M18_KEYS[] = {
+ *         {1, 0x0B}, {2, 0x0C},	// Plain keys: release on 0x00, press on 0x01
+ *         {16, 0xA0, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},	// Knob detent, sent with 0x00 only
+ *     };
+ *     static constexpr EventDecodeTable M18_DECODE_TABLE(M18_KEYS);
+ *
+ *     // in the device constructor
+ *     setDecodeTable(M18_DECODE_TABLE);
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <streamdockinfo.h>
+
+/// One hardware key as the device reports it. Plain keys only need {logicalKey, hardwareCode}.
+struct KeyDecode
+{
+	uint8_t logicalKey;									///< Key value used with registerReadCallback().
+	uint8_t hardwareCode;								///< Value the device reports for this key.
+	RegisterEvent onRelease = RegisterEvent::KeyRelease;	///< Event for event byte 0x00.
+	RegisterEvent onPress = RegisterEvent::KeyPress;		///< Event for event byte 0x01.
+};
+
+/// Result of decoding one report. logicalKey is EventDecodeTable::NO_KEY for unregistered codes.
+struct DecodedEvent
+{
+	uint8_t logicalKey;
+	RegisterEvent event;
+};
+
+class EventDecodeTable
+{
+public:
+	static constexpr uint8_t NO_KEY = 0xFF;
+
+	constexpr EventDecodeTable() = default;
+
+	template <size_t N>
+	constexpr explicit EventDecodeTable(const KeyDecode (&keys)[N])
+	{
+		for (size_t i = 0; i < N; ++i)
+		{
+			Entry& entry = _entries[keys[i].hardwareCode];
+			entry.logicalKey = keys[i].logicalKey;
+			entry.events[0] = keys[i].onRelease;
+			entry.events[1] = keys[i].onPress;
+		}
+	}
+
+	/**
+	 * @brief Decode a hardware code and event byte.
+	 * Event bytes other than 0x00/0x01 decode to RegisterEvent::EveryThing, as do events a key does not produce.
+	 */
+	constexpr DecodedEvent decode(uint8_t hardwareCode, uint8_t eventValue) const
+	{
+		const Entry& entry = _entries[hardwareCode];
+		return { entry.logicalKey, eventValue <= 0x01 ? entry.events[eventValue] : RegisterEvent::EveryThing };
+	}
+
+	/// Logical key -> hardware code map, the form StreamDock::_readValueMap has always used.
+	std::unordered_map<uint8_t, uint8_t> readValueMap() const
+	{
+		std::unordered_map<uint8_t, uint8_t> map;
+		for (size_t code = 0; code < 256; ++code)
+		{
+			if (_entries[code].logicalKey != NO_KEY)
+				map[_entries[code].logicalKey] = static_cast<uint8_t>(code);
+		}
+		return map;
+	}
+
+private:
+	struct Entry
+	{
+		uint8_t logicalKey = NO_KEY;
+		RegisterEvent events[2] = { RegisterEvent::EveryThing, RegisterEvent::EveryThing };
+	};
+
+	Entry _entries[256] = {};
+};
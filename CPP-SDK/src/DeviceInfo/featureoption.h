@@ -19,6 +19,7 @@ struct FeatureOption
 	bool supportTransparentIcon = false;
 	bool supportKeyJpegPngStream = false;
 	bool supportConfig = false;
+	bool hasTouchBar = false;
 	uint16_t min2rdScreenKey = 0;
 	uint16_t max2rdScreenKey = 0;
 	uint16_t _2rdScreenWidth = 0;
@@ -0,0 +1,135 @@
+#include "statejournal.h"
+
+size_t StateJournal::Snapshot::payloadBytes() const
+{
+	size_t bytes = hasBackground && background.data ? background.data->size() : 0;
+	for (const auto& key : keys)
+		bytes += key.second->size();
+	for (const auto& animation : animations)
+	{
+		for (const auto& frame : *animation.second.frames)
+			bytes += frame.size();
+	}
+	return bytes;
+}
+
+void StateJournal::setKeyBrightness(uint8_t brightness)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state.hasKeyBrightness = true;
+	_state.keyBrightness = brightness;
+}
+
+void StateJournal::setKey(uint8_t keyValue, const std::string& encoded)
+{
+	setKey(keyValue, reinterpret_cast<const uint8_t*>(encoded.data()), encoded.size());
+}
+
+void StateJournal::setKey(uint8_t keyValue, const uint8_t* encoded, size_t size)
+{
+	auto bytes = std::make_shared<const std::string>(reinterpret_cast<const char*>(encoded), size);
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state.keys[keyValue] = std::move(bytes);
+}
+
+void StateJournal::clearKey(uint8_t keyValue)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state.keys.erase(keyValue);
+}
+
+void StateJournal::clearKeys()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state.keys.clear();
+}
+
+void StateJournal::setBackground(const std::string& encoded, int32_t timeoutMs, bool bitmap)
+{
+	setBackground(reinterpret_cast<const uint8_t*>(encoded.data()), encoded.size(), timeoutMs, bitmap);
+}
+
+void StateJournal::setBackground(const uint8_t* encoded, size_t size, int32_t timeoutMs, bool bitmap)
+{
+	Background background{ std::make_shared<const std::string>(reinterpret_cast<const char*>(encoded), size), timeoutMs, bitmap };
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state.hasBackground = true;
+	_state.background = std::move(background);
+}
+
+void StateJournal::setLedBrightness(uint8_t brightness)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state.hasLedBrightness = true;
+	_state.ledBrightness = brightness;
+}
+
+void StateJournal::setLedColor(uint8_t red, uint8_t green, uint8_t blue)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state.hasLedColor = true;
+	_state.ledColor = { red, green, blue };
+	_state.ledColors.clear();
+}
+
+void StateJournal::setLedColors(const std::vector<Color>& colors)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state.hasLedColor = false;
+	_state.ledColors = colors;
+}
+
+void StateJournal::resetLedColor()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state.hasLedColor = false;
+	_state.ledColors.clear();
+}
+
+void StateJournal::setAnimation(uint8_t keyValue, const std::vector<std::string>& frames, const std::vector<uint16_t>& delays)
+{
+	Animation animation{ std::make_shared<const std::vector<std::string>>(frames), delays };
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state.animations[keyValue] = std::move(animation);
+}
+
+void StateJournal::setBackgroundAnimation(const std::vector<std::string>& frames, const std::vector<uint16_t>& delays, uint16_t x, uint16_t y, uint8_t layer)
+{
+	Animation animation{ std::make_shared<const std::vector<std::string>>(frames), delays };
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state.animations[0] = std::move(animation);
+	_state.backgroundGifX = x;
+	_state.backgroundGifY = y;
+	_state.backgroundGifLayer = layer;
+}
+
+void StateJournal::clearAnimation(uint8_t keyValue)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state.animations.erase(keyValue);
+}
+
+void StateJournal::setGifLoopRunning(bool running)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state.gifLoopRunning = running;
+}
+
+StateJournal::Snapshot StateJournal::snapshot() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _state;
+}
+
+bool StateJournal::empty() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return !_state.hasKeyBrightness && !_state.hasBackground && _state.keys.empty() && !_state.hasLedBrightness &&
+		!_state.hasLedColor && _state.ledColors.empty() && _state.animations.empty();
+}
+
+void StateJournal::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_state = Snapshot();
+}
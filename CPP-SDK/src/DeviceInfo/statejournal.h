@@ -0,0 +1,99 @@
+/**
+ * @file statejournal.h
+ * @brief Last state written to a device (brightness, encoded key images, background, LEDs, GIFs), for replay after a reconnect.
+ *
+ * A StreamDock with a journal records every state-setting write after validation, with the bytes exactly as
+ * sent, so a replay needs no decoding or encoding. Later writes replace earlier ones: the journal holds one
+ * image per key, one background, one animation per key, not a history. Payloads are shared, so a snapshot
+ * is cheap and replaying does not block recording.
+ *
+ * DeviceManager keeps one journal per serial number and hands it to the StreamDock created when the same
+ * device comes back (hub reset, KVM switch), which replays it with StreamDock::restoreState().
+ *
+ * Example usage:
+ *   auto journal = std::make_shared<StateJournal>();
+ *   device->setStateJournal(journal);
+ *   ...							// unplug, replug
+ *   newDevice->setStateJournal(journal);
+ *   newDevice->restoreState();
+ */
+#pragma once
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class StateJournal
+{
+public:
+	using Bytes = std::shared_ptr<const std::string>;
+	using Color = std::array<uint8_t, 3>;
+
+	struct Background
+	{
+		Bytes data;
+		int32_t timeoutMs = 3000;
+		bool bitmap = false;	///< Sent with setBackgroundBitmap rather than as a JPEG stream.
+	};
+
+	struct Animation
+	{
+		std::shared_ptr<const std::vector<std::string>> frames;	///< Encoded frames.
+		std::vector<uint16_t> delays;
+	};
+
+	/// Everything recorded; `has*` flags mark values that were set.
+	struct Snapshot
+	{
+		bool hasKeyBrightness = false;
+		uint8_t keyBrightness = 0;
+		bool hasBackground = false;
+		Background background;
+		std::map<uint8_t, Bytes> keys;			///< Encoded image per key value.
+
+		bool hasLedBrightness = false;
+		uint8_t ledBrightness = 0;
+		bool hasLedColor = false;
+		Color ledColor{};						///< One colour for every LED; unused when ledColors is set.
+		std::vector<Color> ledColors;			///< Per-LED colours.
+
+		std::map<uint8_t, Animation> animations;	///< By key value; 0 is the background GIF.
+		uint16_t backgroundGifX = 0;
+		uint16_t backgroundGifY = 0;
+		uint8_t backgroundGifLayer = 0;
+		bool gifLoopRunning = false;
+
+		/// Encoded bytes a replay sends for images and animation frames.
+		size_t payloadBytes() const;
+	};
+
+	void setKeyBrightness(uint8_t brightness);
+	void setKey(uint8_t keyValue, const std::string& encoded);
+	void setKey(uint8_t keyValue, const uint8_t* encoded, size_t size);
+	void clearKey(uint8_t keyValue);
+	void clearKeys();
+	void setBackground(const std::string& encoded, int32_t timeoutMs, bool bitmap);
+	void setBackground(const uint8_t* encoded, size_t size, int32_t timeoutMs, bool bitmap);
+
+	void setLedBrightness(uint8_t brightness);
+	void setLedColor(uint8_t red, uint8_t green, uint8_t blue);
+	void setLedColors(const std::vector<Color>& colors);
+	void resetLedColor();
+
+	void setAnimation(uint8_t keyValue, const std::vector<std::string>& frames, const std::vector<uint16_t>& delays);
+	void setBackgroundAnimation(const std::vector<std::string>& frames, const std::vector<uint16_t>& delays, uint16_t x, uint16_t y, uint8_t layer);
+	void clearAnimation(uint8_t keyValue);
+	void setGifLoopRunning(bool running);
+
+	Snapshot snapshot() const;
+	/// True if nothing worth replaying was recorded.
+	bool empty() const;
+	void clear();
+
+private:
+	mutable std::mutex _mutex;
+	Snapshot _state;
+};
@@ -3,13 +3,42 @@
 #include <iostream>
 #include <mutex>
 #include <Gif2ImgFrame.h>
+#include <BufferPool.h>
+#include <FormatSelector.h>
 #include <toolkit.h>
+#include <typeinfo>
+
+namespace
+{
+/// readImgToString() into the calling thread's pooled input buffer; throws the same way.
+std::vector<uint8_t>& readImgToPool(const std::string& filePath)
+{
+	std::ifstream ifs(filePath, std::ios::binary | std::ios::ate);
+	if (!ifs)
+		throw std::runtime_error("[ERROR] Failed to open file: " + filePath);
+
+	std::streamsize size = ifs.tellg();
+	ifs.seekg(0, std::ios::beg);
+
+	auto& buffer = BufferPool::acquireBytes(ByteSlot::Input, static_cast<size_t>(size));
+	if (!ifs.read(reinterpret_cast<char*>(buffer.data()), size))
+		throw std::runtime_error("[ERROR] Failed to read file: " + filePath);
+	return buffer;
+}
+}
 
 StreamDock::StreamDock(const hid_device_info& device_info)
 	: _transport(std::move(std::make_unique<TransportCWrapper>(device_info)))
 {
 	_info = std::make_unique<StreamDockInfo>();
+	_info->devicePath = device_info.path ? device_info.path : "";
 	_feature = std::make_unique<FeatureOption>();
+	DeviceCacheEntry cached;
+	if (device_info.serial_number && DeviceCache::instance().find(device_info.vendor_id, device_info.product_id, device_info.serial_number, cached))
+	{
+		_info->firmwareVersion = cached.firmwareVersion; /// Firmware-dependent setup in the derived constructor needs no query
+		_cached = std::make_unique<DeviceCacheEntry>(std::move(cached));
+	}
 }
 
 StreamDock::~StreamDock()
@@ -21,8 +50,45 @@ StreamDock::~StreamDock()
 	_transport.reset(); /// This must be last; destroying it earlier may cause null pointer access above
 }
 
+RegisterEvent StreamDock::dispatchEvent(uint8_t readValue, uint8_t eventValue)
+{
+	if (_decodeTable)
+		return _decodeTable->decode(readValue, eventValue).event;
+	return RegisterEvent::EveryThing;
+}
+
+void StreamDock::setDecodeTable(const EventDecodeTable& table)
+{
+	_decodeTable = &table;
+	_readValueMap = table.readValueMap();
+}
+
+DecodedEvent StreamDock::decodeEvent(uint8_t readValue, uint8_t eventValue)
+{
+	if (_decodeTable)
+		return _decodeTable->decode(readValue, eventValue);
+	// Models without a table: reverse-map through _readValueMap and ask dispatchEvent()
+	for (const auto& ite : _readValueMap)
+	{
+		if (ite.second == readValue)
+			return { ite.first, dispatchEvent(readValue, eventValue) };
+	}
+	return { EventDecodeTable::NO_KEY, RegisterEvent::EveryThing };
+}
+
+bool StreamDock::decodeTouch(const uint8_t* report, size_t size, uint16_t& x, uint16_t& y) const
+{
+	return false;
+}
+
 void StreamDock::init()
 {
+	if (_cached)
+	{
+		if (_cached->inputReportSize && _cached->outputReportSize)
+			_transport->setReportSize(_cached->inputReportSize, _cached->outputReportSize, _cached->featureReportSize);
+		_cached->applyFeatures(*_feature);
+	}
 	_readController = std::make_unique<ReadController>(this);
 	_heartBeater = std::make_unique<HeartBeat>(this);
 	if (_feature->hasRGBLed)
@@ -52,6 +118,29 @@ std::string StreamDock::getFirmwareVersion()
 	return _info->firmwareVersion;
 }
 
+bool StreamDock::configuredFromCache() const
+{
+	return _cached != nullptr;
+}
+
+std::string StreamDock::queryFirmwareVersion()
+{
+	return _transport ? _transport->getFirmwareVesion() : std::string();
+}
+
+DeviceCacheEntry StreamDock::cacheEntry() const
+{
+	DeviceCacheEntry entry;
+	entry.firmwareVersion = _info->firmwareVersion;
+	if (_transport)
+	{
+		entry.inputReportSize = _transport->_input_report_size;
+		entry.outputReportSize = _transport->_output_report_size;
+		entry.featureReportSize = _transport->_feature_report_size;
+	}
+	return entry;
+}
+
 void StreamDock::wakeupScreen()
 {
 	if (_transport->canWrite())
@@ -60,13 +149,21 @@ void StreamDock::wakeupScreen()
 void StreamDock::setKeyBrightness(uint8_t brightness)
 {
 	if (_transport->canWrite())
+	{
 		_transport->setKeyBrightness(brightness);
+		if (_journal)
+			_journal->setKeyBrightness(brightness);
+	}
 }
 
 void StreamDock::clearAllKeys()
 {
 	if (_transport->canWrite())
+	{
 		_transport->clearAllKeys();
+		if (_journal)
+			_journal->clearKeys();
+	}
 }
 
 void StreamDock::clearKey(uint8_t keyValue)
@@ -77,7 +174,11 @@ void StreamDock::clearKey(uint8_t keyValue)
 		return;
 	}
 	if (_transport->canWrite())
+	{
 		_transport->clearKey(keyValue);
+		if (_journal)
+			_journal->clearKey(keyValue);
+	}
 }
 
 void StreamDock::refresh()
@@ -121,47 +222,59 @@ void StreamDock::setKeyImgFile(const std::string& filePath, uint8_t keyValue)
 		ToolKit::print("[ERROR] Encoder is not set, cannot encode image.");
 		return;
 	}
-	auto imgData = readImgToString(filePath);
-	std::vector<uint8_t> imgDataVec(imgData.data(), imgData.data() + imgData.size());
-	std::vector<uint8_t> output;
-	if (_encoder->encodeToMemory(output, imgDataVec, 95, *getKyImgHelper(keyValue)))
-		setKeyImgFileStream(std::string(output.data(), output.data() + output.size()), keyValue);
+	auto& input = readImgToPool(filePath);
+	auto& output = BufferPool::acquireBytes(ByteSlot::Output);
+	if (keyEncodeProfile(keyValue).encode(input, output))
+		writeKeyImgStream(output.data(), output.size(), keyValue, true); // Straight from the pooled buffer, no std::string copy
 }
 
-void StreamDock::setKeyImgFileStream(const std::string& stream, uint8_t keyValue)
+bool StreamDock::setKeyImgFileStream(const std::string& stream, uint8_t keyValue)
 {
 	///  we strongly suggest you do not use this directly when it will Invoke `_transport->setKeyBitmap`.
 	/// You'd use `StreamDock::setKeyImgFile`
+	return writeKeyImgStream(stream, keyValue, true);
+}
+
+bool StreamDock::writeKeyImgStream(const std::string& stream, uint8_t keyValue, bool record)
+{
+	return writeKeyImgStream(reinterpret_cast<const uint8_t*>(stream.data()), stream.size(), keyValue, record);
+}
+
+bool StreamDock::writeKeyImgStream(const uint8_t* data, size_t size, uint8_t keyValue, bool record)
+{
 	if (outOfRange(keyValue))
 	{
 		ToolKit::print("[ERROR] Key value out of range: ", static_cast<int>(keyValue));
-		return;
+		return false;
 	}
 	if (!canTransportWrite())
 	{
 		ToolKit::print("[ERROR] Encoder is not set, cannot encode image.");
-		return;
+		return false;
 	}
 	auto keyImgHelper = getKyImgHelper(keyValue);
 	bool validImageData = false;
 	if (_feature->supportKeyJpegPngStream)
 	{
-		validImageData = isJpegData(stream) || isPngData(stream);
+		validImageData = isJpegData(data, size) || isPngData(data, size);
 	}
 	else if (keyImgHelper->_imgType == ImgType::JPG)
 	{
-		validImageData = isJpegData(stream);
+		validImageData = isJpegData(data, size);
 	}
 	else if (keyImgHelper->_imgType == ImgType::PNG)
 	{
-		validImageData = isPngData(stream);
+		validImageData = isPngData(data, size);
 	}
 	if (!validImageData)
 	{
 		ToolKit::print("[ERROR] Invalid image data for this device/key.");
-		return;
+		return false;
 	}
-	_transport->setKeyImgFileStream(stream, keyValue);
+	bool written = _transport->setKeyImgFileStream(data, size, keyValue);
+	if (record && _journal)
+		_journal->setKey(keyValue, data, size);
+	return written;
 }
 
 void StreamDock::setBackgroundImgFile(const std::string& filePath, uint32_t timeoutMs)
@@ -176,34 +289,42 @@ void StreamDock::setBackgroundImgFile(const std::string& filePath, uint32_t time
 		ToolKit::print("[ERROR] Encoder is not set, cannot encode image.");
 		return;
 	}
-	auto imgData = readImgToString(filePath);
-	std::vector<uint8_t> imgDataVec(imgData.data(), imgData.data() + imgData.size());
-	std::vector<uint8_t> output;
-	if (_encoder->encodeToMemory(output, imgDataVec, 85, *_bg_imgHelper))
-		setBackgroundImgStream(std::string(output.data(), output.data() + output.size()), timeoutMs);
+	auto& input = readImgToPool(filePath);
+	auto& output = BufferPool::acquireBytes(ByteSlot::Output);
+	if (backgroundEncodeProfile().encode(input, output))
+		writeBackgroundImg(output.data(), output.size(), timeoutMs); // Straight from the pooled buffer, no std::string copy
+}
+
+bool StreamDock::setBackgroundImgStream(const std::string& stream, uint32_t timeoutMs)
+{
+	return writeBackgroundImg(reinterpret_cast<const uint8_t*>(stream.data()), stream.size(), timeoutMs);
 }
 
-void StreamDock::setBackgroundImgStream(const std::string& stream, uint32_t timeoutMs)
+bool StreamDock::writeBackgroundImg(const uint8_t* data, size_t size, uint32_t timeoutMs)
 {
 	if (!canTransportWrite())
 	{
 		ToolKit::print("[ERROR] Transport is not running.");
-		return;
+		return false;
 	}
 
+	bool written = false;
 	if (_feature->isDualDevice)
 	{
-		if (!isJpegData(stream))
+		if (!isJpegData(data, size))
 		{
 			ToolKit::print("[ERROR] Invalid JPEG data.");
-			return;
+			return false;
 		}
-		_transport->setBackgroundImgStream(stream, timeoutMs);
+		written = _transport->setBackgroundImgStream(data, size, timeoutMs);
 	}
 	else
 	{
-		_transport->setBackgroundBitmap(stream, timeoutMs);
+		written = _transport->setBackgroundBitmap(data, size, timeoutMs);
 	}
+	if (_journal)
+		_journal->setBackground(data, size, static_cast<int32_t>(timeoutMs), !_feature->isDualDevice);
+	return written;
 }
 
 void StreamDock::setFrameBackgroundFile(const std::string& filePath, uint16_t x, uint16_t y, uint8_t FBlayer)
@@ -330,6 +451,61 @@ IConfiger* StreamDock::configer()
 	return _configer.get();
 }
 
+void StreamDock::setStateJournal(std::shared_ptr<StateJournal> journal)
+{
+	_journal = std::move(journal);
+}
+
+std::shared_ptr<StateJournal> StreamDock::stateJournal() const
+{
+	return _journal;
+}
+
+bool StreamDock::restoreState()
+{
+	if (!_journal || !canTransportWrite())
+		return false;
+	auto state = _journal->snapshot();
+
+	// Already encoded: straight to the transport, one refresh for the whole batch
+	if (state.hasKeyBrightness)
+		_transport->setKeyBrightness(state.keyBrightness);
+	if (state.hasBackground)
+	{
+		if (state.background.bitmap)
+			_transport->setBackgroundBitmap(*state.background.data, state.background.timeoutMs);
+		else
+			_transport->setBackgroundImgStream(*state.background.data, state.background.timeoutMs);
+	}
+	for (const auto& key : state.keys)
+		_transport->setKeyImgFileStream(*key.second, key.first);
+	if (state.hasBackground || !state.keys.empty())
+		_transport->refresh();
+
+	if (_rgbController)
+	{
+		if (state.hasLedBrightness)
+			_rgbController->setLedBrightness(state.ledBrightness);
+		if (!state.ledColors.empty())
+			_rgbController->setSingleLedColor(state.ledColors);
+		else if (state.hasLedColor)
+			_rgbController->setLedColor(state.ledColor[0], state.ledColor[1], state.ledColor[2]);
+	}
+	if (_gifController && !state.animations.empty())
+	{
+		for (const auto& animation : state.animations)
+		{
+			if (animation.first == 0)
+				_gifController->setBackgroundGifStream(*animation.second.frames, animation.second.delays, state.backgroundGifX, state.backgroundGifY, state.backgroundGifLayer);
+			else
+				_gifController->setKeyGifStream(*animation.second.frames, animation.second.delays, animation.first);
+		}
+		if (state.gifLoopRunning)
+			_gifController->startGifLoop();
+	}
+	return true;
+}
+
 IHeartBeat* StreamDock::heartbeater()
 {
 	if (!_heartBeater)
@@ -386,16 +562,18 @@ bool StreamDock::isStreamDockHidDeviceUsage(const hid_device_info& device)
 }
 
 bool StreamDock::isJpegData(const std::string& originData)
+{
+	return isJpegData(reinterpret_cast<const uint8_t*>(originData.data()), originData.size());
+}
+
+bool StreamDock::isJpegData(const uint8_t* bytes, size_t len)
 {
 	if (!USE_JPEG_STRICT)
 		return true;
 
-	if (originData.size() < 4)
+	if (len < 4)
 		return false;
 
-	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(originData.data());
-	size_t len = originData.size();
-
 	if (bytes[0] != 0xFF || bytes[1] != 0xD8)
 		return false;
 
@@ -407,15 +585,18 @@ bool StreamDock::isJpegData(const std::string& originData)
 }
 
 bool StreamDock::isPngData(const std::string& originData)
+{
+	return isPngData(reinterpret_cast<const uint8_t*>(originData.data()), originData.size());
+}
+
+bool StreamDock::isPngData(const uint8_t* bytes, size_t size)
 {
 	if (!USE_PNG_STRICT)
 		return true;
 
-	if (originData.size() < 8)
+	if (size < 8)
 		return false;
 
-	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(originData.data());
-
 	// PNG header signature: 89 50 4E 47 0D 0A 1A 0A
 	return bytes[0] == 0x89 &&
 		bytes[1] == 0x50 &&
@@ -476,6 +657,60 @@ void StreamDock::setEncoder(std::shared_ptr<IImageEncoder> encoder)
 	_encoder = std::move(encoder);
 }
 
+ImageEncodeProfile StreamDock::keyEncodeProfile(uint8_t keyValue) const
+{
+	ImageEncodeProfile profile;
+	profile.encoder = _encoder;
+	profile.helper = *getKyImgHelper(keyValue);
+	profile.quality = 95;
+	profile.autoFormat = _autoKeyFormat && _feature->supportKeyJpegPngStream;
+	profile.keepAlpha = _feature->supportTransparentIcon;
+	return profile;
+}
+
+ImageEncodeProfile StreamDock::backgroundEncodeProfile() const
+{
+	ImageEncodeProfile profile;
+	profile.encoder = _encoder;
+	profile.helper = *getBgImgHelper();
+	profile.quality = 85;
+	return profile;
+}
+
+bool ImageEncodeProfile::valid() const
+{
+	return encoder && helper._width != 0 && helper._height != 0;
+}
+
+bool ImageEncodeProfile::sameAs(const ImageEncodeProfile& other) const
+{
+	return valid() && other.valid() && typeid(*encoder) == typeid(*other.encoder) && helper == other.helper &&
+		   quality == other.quality && autoFormat == other.autoFormat && (!autoFormat || keepAlpha == other.keepAlpha);
+}
+
+bool ImageEncodeProfile::encode(const std::vector<uint8_t>& in, std::vector<uint8_t>& out) const
+{
+	if (!encoder)
+		return false;
+	if (autoFormat)
+		return FormatSelector::encode(*encoder, out, in, quality, helper, keepAlpha);
+	return encoder->encodeToMemory(out, in, quality, helper);
+}
+
+void StreamDock::setPngOptions(const PngOptions& options)
+{
+	for (const auto& helper : { _ky_imgHelper, _2rdsc_imgHelper })
+	{
+		if (helper && helper->_imgType == ImgType::PNG)
+			helper->_pngOptions = options;
+	}
+}
+
+void StreamDock::setAutoKeyFormat(bool enable)
+{
+	_autoKeyFormat = enable;
+}
+
 std::shared_ptr<ImgHelper> StreamDock::getBgImgHelper() const
 {
 	static std::shared_ptr<ImgHelper> nullKyImgHelper = std::make_shared<ImgHelper>();
@@ -7,7 +7,7 @@
  * - Image rendering (key and background)
  * - Device info, feature flags, and image helpers
  * - Component-based architecture: supports pluggable controllers for input, RGB, GIFs, config, heartbeat, etc.
- * - Event dispatch mechanism via the pure virtual method dispatchEvent()
+ * - Event decoding through a per-model compile-time EventDecodeTable (see eventdecodetable.h)
  *
  * It is designed to be subclassed per device model (e.g., StreamDockM18, StreamDockN4), with specific behaviors
  * implemented in the derived class.
@@ -16,6 +16,7 @@
 #include "hidapi.h"
 #include <TransportCWrapper.h>
 #include <streamdockinfo.h>
+#include <eventdecodetable.h>
 #include <featureoption.h>
 #include <memory>
 #include <Feature/ReadController/readcontroller.h>
@@ -23,6 +24,8 @@
 #include <Feature/GifController/gifcontroller.h>
 #include <Feature/Configer/configer.h>
 #include <Feature/HeartBeat/heartbeat.h>
+#include <statejournal.h>
+#include <devicecache.h>
 #include <ImgHelper.h>
 #include <unordered_map>
 #include <IImageEncoder.h>
@@ -34,6 +37,25 @@ static constexpr auto USE_JPEG_STRICT = true;
 static constexpr auto USE_PNG_STRICT = true;
 static constexpr auto READ_LOOP_TIMEOUT = 100;
 
+/**
+ * @brief How a device encodes an image for one target (key or background).
+ * Devices with the same profile turn the same source image into the same stream.
+ */
+struct ImageEncodeProfile
+{
+	std::shared_ptr<IImageEncoder> encoder;
+	ImgHelper helper;
+	int quality = 95;
+	bool autoFormat = false;	///< FormatSelector picks JPEG or PNG per image.
+	bool keepAlpha = false;		///< With autoFormat: keep transparent images PNG.
+
+	/// Encoder set and target size known.
+	bool valid() const;
+	/// Same encoder type and settings; the encoder instance may differ.
+	bool sameAs(const ImageEncodeProfile& other) const;
+	bool encode(const std::vector<uint8_t>& in, std::vector<uint8_t>& out) const;
+};
+
 class IReadController;
 class IRGBController;
 class IGifController;
@@ -52,7 +74,28 @@ public:
 	virtual ~StreamDock();
 
 protected:
-	virtual RegisterEvent dispatchEvent(uint8_t readValue, uint8_t eventValue) = 0;
+	/**
+	 * @brief Map a hardware code and event byte to the event type.
+	 * The default looks the pair up in the device's decode table; override only for models without one.
+	 */
+	virtual RegisterEvent dispatchEvent(uint8_t readValue, uint8_t eventValue);
+
+	/**
+	 * @brief Install the model's decode table and derive _readValueMap from it. Call from the device constructor.
+	 */
+	void setDecodeTable(const EventDecodeTable& table);
+
+	/**
+	 * @brief Decode one report into (logical key, event). Logical key is EventDecodeTable::NO_KEY when the code is not registered.
+	 */
+	DecodedEvent decodeEvent(uint8_t readValue, uint8_t eventValue);
+
+	/**
+	 * @brief Extract a touch-bar coordinate from a report that does not carry a key event.
+	 * Only called on models with FeatureOption::hasTouchBar; the default recognizes no report.
+	 * @return true if the report is a touch report.
+	 */
+	virtual bool decodeTouch(const uint8_t* report, size_t size, uint16_t& x, uint16_t& y) const;
 
 public:
 	/**
@@ -118,8 +161,9 @@ public:
 	 * @brief Set a key image using raw JPEG/PNG(on N4PRO/M3/XL) data stream.
 	 * @param stream Image byte stream.
 	 * @param keyValue Target key index.
+	 * @return True if the data was valid for the key and the device accepted it.
 	 */
-	virtual void setKeyImgFileStream(const std::string& stream, uint8_t keyValue);
+	virtual bool setKeyImgFileStream(const std::string& stream, uint8_t keyValue);
 
 	/**
 	 * @brief Set the full background image from a file.
@@ -132,8 +176,9 @@ public:
 	 * @brief Set the full background image from jpeg_data(on new firmware) or bitmap_data(on V2 firmware).
 	 * @param stream Image data stream.
 	 * @param timeoutMs Timeout in milliseconds.
+	 * @return True if the data was valid for the device and the device accepted it.
 	 */
-	virtual void setBackgroundImgStream(const std::string& stream, uint32_t timeoutMs = 3000);
+	virtual bool setBackgroundImgStream(const std::string& stream, uint32_t timeoutMs = 3000);
 
 	/**
 	 * @brief Draw a static image on the background framebuffer from a file path.
@@ -179,6 +224,40 @@ public:
 	 */
 	static void disableOutput(bool disable);
 
+public:
+	/**
+	 * @brief Whether the firmware version, report sizes and capability overrides came from DeviceCache.
+	 */
+	bool configuredFromCache() const;
+
+	/**
+	 * @brief Ask the device for its firmware version, bypassing the cached one.
+	 */
+	std::string queryFirmwareVersion();
+
+	/**
+	 * @brief Firmware version and report sizes in use, for DeviceCache::store().
+	 */
+	DeviceCacheEntry cacheEntry() const;
+
+	/**
+	 * @brief Record the state written to this device in `journal` from now on (nullptr stops recording).
+	 * Set it before the device is shared with other threads.
+	 */
+	void setStateJournal(std::shared_ptr<StateJournal> journal);
+
+	/**
+	 * @brief Get the state journal, or nullptr if none is set.
+	 */
+	std::shared_ptr<StateJournal> stateJournal() const;
+
+	/**
+	 * @brief Replay the journal to the device: brightness, background and key images back to back with a
+	 * single refresh, then LEDs and GIF animations.
+	 * @return False if there is no journal or the transport cannot write.
+	 */
+	bool restoreState();
+
 public:
 	/**
 	 * @brief Get device metadata.
@@ -240,11 +319,13 @@ public:
 	 * @brief Check if the given data is JPEG encoded.
 	 */
 	static bool isJpegData(const std::string& originData);
+	static bool isJpegData(const uint8_t* bytes, size_t len);
 
 	/**
 	 * @brief Check if the given data is PNG encoded.
 	 */
 	static bool isPngData(const std::string& originData);
+	static bool isPngData(const uint8_t* bytes, size_t size);
 
 	/**
 	 * @brief Read a GIF file and split it into encoded image frames.
@@ -270,6 +351,29 @@ public:
 	 */
 	void setEncoder(std::shared_ptr<IImageEncoder> encoder);
 
+	/**
+	 * @brief Profile setKeyImgFile() encodes with for `keyValue` (key or second screen).
+	 */
+	ImageEncodeProfile keyEncodeProfile(uint8_t keyValue) const;
+
+	/**
+	 * @brief Profile setBackgroundImgFile() encodes with; invalid on devices without a background.
+	 */
+	ImageEncodeProfile backgroundEncodeProfile() const;
+
+	/**
+	 * @brief Set the PNG encode strategy (palette quantisation, row filter, zlib level) for key and second screen images.
+	 * Only helpers that encode PNG (keys on N4Pro/M3/XL) are changed.
+	 */
+	void setPngOptions(const PngOptions& options);
+
+	/**
+	 * @brief Let setKeyImgFile() pick JPEG or PNG per image on devices that accept both (supportKeyJpegPngStream).
+	 * The first send of an image encodes both and keeps the smaller one within the JPEG quality bound
+	 * (FormatSelector::setMinJpegPsnr); the choice is cached per image. Other devices ignore this.
+	 */
+	void setAutoKeyFormat(bool enable);
+
 	/**
 	 * @brief Get the helper for background image operations.
 	 */
@@ -291,8 +395,23 @@ public:
 	 */
 	std::shared_ptr<ImgHelper> getBackgroundGifHelper(uint16_t keyValue = 0) const;
 
+private:
+	/**
+	 * @brief Validate and send a key image; `record` puts it into the state journal.
+	 * GIF frames are sent with record = false: the journal keeps the animation, not its current frame.
+	 */
+	bool writeKeyImgStream(const std::string& stream, uint8_t keyValue, bool record);
+	bool writeKeyImgStream(const uint8_t* data, size_t size, uint8_t keyValue, bool record);
+
+	/**
+	 * @brief Validate and send a background image, then record it in the state journal.
+	 * The file setters pass their pooled encode buffer here; only the journal keeps a copy.
+	 */
+	bool writeBackgroundImg(const uint8_t* data, size_t size, uint32_t timeoutMs);
+
 protected:
 	std::unordered_map<uint8_t, uint8_t> _readValueMap;       ///< Key mapping table: maps raw read values (e.g., response[9]) to logical key codes registered by the derived class.
+	const EventDecodeTable* _decodeTable = nullptr;           ///< Compile-time decode table of the device model; _readValueMap is generated from it.
 
 	std::unique_ptr<TransportCWrapper> _transport = nullptr;  ///< Communication handler (transport layer wrapper).
 	std::unique_ptr<StreamDockInfo> _info = nullptr;          ///< Device information.
@@ -309,5 +428,8 @@ protected:
 	std::shared_ptr<ImgHelper> _ky_imgHelper = nullptr;         ///< Key image helper.
 	std::shared_ptr<ImgHelper> _2rdsc_imgHelper = nullptr;      ///< Second screen image helper.
 	std::shared_ptr<ImgHelper> _bg_gifHelper = nullptr;         ///< Background GIF animation helper.
+	bool _autoKeyFormat = false;                                ///< Per-image JPEG/PNG choice for key images.
+	std::shared_ptr<StateJournal> _journal = nullptr;          ///< Records written state for restoreState(); optional.
+	std::unique_ptr<DeviceCacheEntry> _cached = nullptr;        ///< DeviceCache entry the device was configured from, if any.
 
 };
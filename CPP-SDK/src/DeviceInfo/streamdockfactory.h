@@ -14,12 +14,12 @@
  *     class StreamDockM18 : public StreamDock {
  *     public:
  *         explicit StreamDockM18(const hid_device_info& device_info);
- *         RegisterEvent dispatchEvent(uint8_t readValue, uint8_t eventValue) override;
  *     private:
  *         static bool registered_M18;
  *     };
  *
- * 2. Register it in its implementation file:
+ * 2. Register it in its implementation file, next to its key decode table (see eventdecodetable.h),
+ *    which the constructor installs with setDecodeTable():
  *
  *     static constexpr auto VID_STREAMDOCK_M18 = 0x6603;
  *     static constexpr auto PID_STREAMDOCK_M18 = 0x1009;
@@ -36,6 +36,7 @@ struct StreamDockInfo
 	uint16_t vendor_id = 0x00;
 	uint16_t product_id = 0x00;
 	std::wstring serialNumber{};   ///< Device serial number
+	std::string devicePath{};      ///< hid_device_info::path the device was opened with
 	std::string firmwareVersion{}; ///< Firmware version
 	uint16_t width = 0;
 	uint16_t height = 0;
@@ -74,5 +75,8 @@ enum class RegisterEvent : uint8_t
 	DIPRight = 0x0D,       ///< DIP switch right event
 	DIPRightEnd = 0x0E,    ///< DIP switch right end event
 	DIPPress = 0x0F,       ///< DIP switch press event
-	DIPRelease = 0x10     ///< DIP switch press end event
+	DIPRelease = 0x10,    ///< DIP switch press end event
+	LongPress = 0x11,     ///< Key or knob held past the long-press threshold (gesture)
+	DoubleTap = 0x12,     ///< Key or knob pressed twice within the double-tap threshold (gesture)
+	Chord = 0x13          ///< Registered key set held together (gesture)
 };
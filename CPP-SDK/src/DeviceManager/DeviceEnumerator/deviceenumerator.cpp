@@ -2,6 +2,7 @@
 #include <iostream>
 #include <iomanip>
 #include <toolkit.h>
+#include <algorithm>
 
 DeviceEnumerator::DeviceInfo::DeviceInfo(const hid_device_info& info)
 {
@@ -48,30 +49,24 @@ DeviceEnumerator::~DeviceEnumerator()
 
 void DeviceEnumerator::enumerate(bool log_out)
 {
-	_deviceList.clear();
-	_pathMap.clear();
-	_vidpidMap.clear();
-
 	struct hid_device_info* devs = hid_enumerate(0x0, 0x0);
 	struct hid_device_info* cur = devs;
 
+	std::unique_lock<std::mutex> lock(_mutex);
+	_deviceList.clear();
+	_pathMap.clear();
+	_vidpidMap.clear();
 	while (cur)
 	{
-		auto dev = std::make_shared<DeviceInfo>(*cur);
-
-		_deviceList.push_back(dev);
-		_pathMap[dev->_path] = dev;
-
-		uint32_t key = (static_cast<uint32_t>(dev->_vendor_id) << 16) | dev->_product_id;
-		_vidpidMap.emplace(key, std::weak_ptr<DeviceInfo>(dev));
-
+		insert(std::make_shared<DeviceInfo>(*cur));
 		cur = cur->next;
 	}
+	lock.unlock();
 
 	if (log_out)
 	{
 		int index = 1;
-		for (const auto& dev : _deviceList)
+		for (const auto& dev : currDevices())
 		{
 			ToolKit::print("\nDevice #", index++, ":");
 			ToolKit::print("  Path:", dev->_path);
@@ -92,8 +87,58 @@ void DeviceEnumerator::enumerate(bool log_out)
 	hid_free_enumeration(devs);
 }
 
-const std::vector<std::shared_ptr<DeviceEnumerator::DeviceInfo>>& DeviceEnumerator::currDevices() const
+void DeviceEnumerator::insert(const std::shared_ptr<DeviceInfo>& dev)
+{
+	_deviceList.push_back(dev);
+	_pathMap[dev->_path] = dev;
+
+	uint32_t key = (static_cast<uint32_t>(dev->_vendor_id) << 16) | dev->_product_id;
+	_vidpidMap.emplace(key, std::weak_ptr<DeviceInfo>(dev));
+}
+
+std::shared_ptr<DeviceEnumerator::DeviceInfo> DeviceEnumerator::add(const hid_device_info& info)
+{
+	auto dev = std::make_shared<DeviceInfo>(info);
+	std::lock_guard<std::mutex> lock(_mutex);
+	erase(dev->_path); // Same node reported again: replace the entry
+	insert(dev);
+	return dev;
+}
+
+bool DeviceEnumerator::remove(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return erase(path);
+}
+
+bool DeviceEnumerator::erase(const std::string& path)
+{
+	auto it = _pathMap.find(path);
+	if (it == _pathMap.end())
+		return false;
+	auto dev = it->second;
+	_pathMap.erase(it);
+
+	auto pos = std::find(_deviceList.begin(), _deviceList.end(), dev);
+	if (pos != _deviceList.end())
+		_deviceList.erase(pos);
+
+	uint32_t key = (static_cast<uint32_t>(dev->_vendor_id) << 16) | dev->_product_id;
+	auto range = _vidpidMap.equal_range(key);
+	for (auto vit = range.first; vit != range.second;)
+	{
+		auto entry = vit->second.lock();
+		if (!entry || entry == dev)
+			vit = _vidpidMap.erase(vit);
+		else
+			++vit;
+	}
+	return true;
+}
+
+std::vector<std::shared_ptr<DeviceEnumerator::DeviceInfo>> DeviceEnumerator::currDevices() const
 {
+	std::lock_guard<std::mutex> lock(_mutex);
 	return _deviceList;
 }
 
@@ -105,6 +150,7 @@ DeviceEnumerator& DeviceEnumerator::instance()
 
 std::shared_ptr<DeviceEnumerator::DeviceInfo> DeviceEnumerator::find_by_path(const std::string& path) const
 {
+	std::lock_guard<std::mutex> lock(_mutex);
 	auto it = _pathMap.find(path);
 	return (it != _pathMap.end()) ? it->second : nullptr;
 }
@@ -114,6 +160,7 @@ std::vector<std::shared_ptr<DeviceEnumerator::DeviceInfo>> DeviceEnumerator::fin
 	std::vector<std::shared_ptr<DeviceInfo>> results;
 	uint32_t key = (static_cast<uint32_t>(vid) << 16) | pid;
 
+	std::lock_guard<std::mutex> lock(_mutex);
 	auto range = _vidpidMap.equal_range(key);
 	for (auto it = range.first; it != range.second; ++it)
 	{
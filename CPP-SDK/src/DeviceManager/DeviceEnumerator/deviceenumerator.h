@@ -4,6 +4,7 @@
  *
  * Overview:
  * - Enumerate currently connected HID devices
+ * - Add or remove single devices on hotplug without rescanning the bus
  * - Find devices by HID path or VID/PID
  * - Open and close device handles
  * - Send raw data to a device
@@ -16,6 +17,7 @@
 #include <hidapi.h>
 #include <unordered_map>
 #include <string>
+#include <mutex>
 
  /**
  * @class DeviceEnumerator
@@ -75,9 +77,22 @@ public:
 	void enumerate(bool log_out = false);
 
 	/**
-	 * @brief Get the current list of enumerated devices.
+	 * @brief Add or replace a single device, e.g. one reported by a hotplug event.
+	 * @param info Device description; copied.
+	 * @return The stored DeviceInfo.
 	 */
-	const std::vector<std::shared_ptr<DeviceInfo>>& currDevices() const;
+	std::shared_ptr<DeviceInfo> add(const hid_device_info& info);
+
+	/**
+	 * @brief Forget the device with the given HID path.
+	 * @return True if the device was known.
+	 */
+	bool remove(const std::string& path);
+
+	/**
+	 * @brief Get a copy of the current list of enumerated devices, taken under the lock that add()/remove() hold.
+	 */
+	std::vector<std::shared_ptr<DeviceInfo>> currDevices() const;
 
 	/**
 	 * @brief Find a device by its HID path.
@@ -119,10 +134,16 @@ private:
 	DeviceEnumerator();
 	~DeviceEnumerator();
 
+	/// Index a device in the list and both maps, under `_mutex`.
+	void insert(const std::shared_ptr<DeviceInfo>& dev);
+	/// Drop a device from the list and both maps, under `_mutex`.
+	bool erase(const std::string& path);
+
 private:
 	hid_device_info* _info_list = nullptr;                                    ///< Raw device info list returned by hidapi.
 	std::vector<std::shared_ptr<DeviceInfo>> _deviceList;                     ///< List of currently enumerated devices.
 	std::unordered_map<std::string, std::shared_ptr<DeviceInfo>> _pathMap;    ///< Mapping from HID path to device info.
 	std::unordered_multimap<uint32_t, std::weak_ptr<DeviceInfo>> _vidpidMap;  ///< Mapping from VID/PID (as a combined key) to device info (non-owning).
+	mutable std::mutex _mutex;                                                ///< Guards the list and maps against the hotplug thread.
 
 };
\ No newline at end of file
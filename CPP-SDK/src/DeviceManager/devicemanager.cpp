@@ -4,6 +4,8 @@
 #include <HotspotDevice/StreamDockM18/streamdockM18.h>
 #include <HotspotDevice/StreamDockN3V25/streamdockN3V25.h>
 #include <unordered_set>
+#include <algorithm>
+#include <BufferPool.h>
 
 DeviceManager &DeviceManager::instance()
 {
@@ -11,67 +13,468 @@ DeviceManager &DeviceManager::instance()
 	return instance;
 }
 
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	std::chrono::microseconds elapsed(Clock::time_point from, Clock::time_point to = Clock::now())
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(to - from);
+	}
+
+	double toMs(std::chrono::microseconds us)
+	{
+		return us.count() / 1000.0;
+	}
+}
+
 void DeviceManager::enumerator()
 {
+	enumeratorAsync();
+	whenAllReady();
+	ToolKit::print("[INFO] streamdock device count:", registry_.size());
+}
+
+void DeviceManager::enumeratorAsync()
+{
+	auto start = Clock::now();
 	DeviceEnumerator::instance().enumerate();
-	const auto &allDevices = DeviceEnumerator::instance().currDevices();
+	const auto allDevices = DeviceEnumerator::instance().currDevices();
 
 	// Collect paths for all current valid devices
 	std::unordered_set<std::string> validPaths;
 	for (const auto &device : allDevices)
 	{
-		if (StreamDockFactory::instance().exist(device->_vendor_id, device->_product_id) &&
-			StreamDock::isStreamDockHidDeviceUsage(device->toPureHidDeviceInfo()))
+		if (isSupported(device->toPureHidDeviceInfo()))
 		{
 			validPaths.insert(device->_path);
 		}
 	}
 
 	// Remove disconnected devices
+	auto removed = registry_.eraseIf([&validPaths](const std::string &path, const std::shared_ptr<StreamDock> &)
+									 { return validPaths.find(path) == validPaths.end(); });
+	for (const auto &entry : removed)
+		ToolKit::print("[INFO] Device disconnected:", entry.first);
+	removed.clear(); // Destroy the devices before bringing new ones up
+
 	{
-		std::lock_guard lock(streamdocksMutex_);
-		auto it = streamdocks_.begin();
-		while (it != streamdocks_.end())
+		std::lock_guard lock(bringUpMutex_);
+		if (bringingUp_ == 0) // Otherwise the previous run is still going; keep adding to its timing
 		{
-			if (validPaths.find(it->first) == validPaths.end())
-			{
-				ToolKit::print("[INFO] Device disconnected:", it->first);
-				it = streamdocks_.erase(it);
-			}
-			else
-			{
-				++it;
-			}
+			timing_ = StartupTiming();
+			enumerationStart_ = start;
 		}
+		timing_.scan = elapsed(start);
 	}
 
-	// 3. Add new devices
+	// 3. Bring new devices up concurrently, one worker per device up to maxDeviceWorkers()
+	std::vector<std::pair<std::shared_ptr<DeviceEnumerator::DeviceInfo>, std::shared_ptr<std::promise<std::shared_ptr<StreamDock>>>>> starting;
+	size_t inFlight = 0;
 	for (const auto &device : allDevices)
 	{
-		if (StreamDockFactory::instance().exist(device->_vendor_id, device->_product_id) && StreamDock::isStreamDockHidDeviceUsage(device->toPureHidDeviceInfo()) /* &&
-			 StreamDock::isStreamDockHidDevice(device->toPureHidDeviceInfo())*/
-		)
+		if (!validPaths.count(device->_path))
+			continue;
+		if (registry_.find(device->_path)) /// exist this device and pass
+			continue;
+		auto promise = std::make_shared<std::promise<std::shared_ptr<StreamDock>>>();
 		{
-			if (streamdocks_.find(device->_path) != streamdocks_.end()) /// exist this device and pass
-				continue;
-			auto dock = StreamDockFactory::instance().create(device->_vendor_id, device->_product_id, device->toPureHidDeviceInfo());
-			if (!dock)
-				continue;
-			std::lock_guard lock(streamdocksMutex_);
-			if (dock->info())
-			{
-				dock->info()->firmwareVersion = dock->getFirmwareVersion();
-				ToolKit::print("Firmware Version:", dock->getFirmwareVersion());
-			}
-			streamdocks_[device->_path] = std::move(dock);
+			std::lock_guard lock(bringUpMutex_);
+			if (bringUp_.find(device->_path) != bringUp_.end())
+				continue; // Already coming up
+			bringUp_[device->_path] = promise->get_future().share();
+			inFlight = ++bringingUp_;
+		}
+		starting.emplace_back(device, std::move(promise));
+	}
+	if (starting.empty())
+		return;
+	auto pool = devicePool(inFlight);
+	for (auto &entry : starting)
+	{
+		pool->post(std::hash<std::string>()(entry.first->_path), [this, device = entry.first, promise = entry.second]
+				   {
+					   DeviceStartupTiming timing;
+					   timing.path = device->_path;
+					   std::shared_ptr<StreamDock> dock;
+					   try
+					   {
+						   dock = attach(device, &timing);
+					   }
+					   catch (const std::exception &e)
+					   {
+						   ToolKit::print("[ERROR] Failed to bring up", device->_path, e.what());
+					   }
+					   catch (...)
+					   {
+						   ToolKit::print("[ERROR] Failed to bring up", device->_path, "(unknown exception)");
+					   }
+					   // Always reached, so whenReady() and whenAllReady() never wait on a lost task
+					   promise->set_value(dock);
+					   finishBringUp(std::move(timing)); });
+	}
+}
+
+std::shared_ptr<CallbackExecutor> DeviceManager::devicePool(size_t workers)
+{
+	std::shared_ptr<CallbackExecutor> pool;
+	{
+		std::lock_guard lock(bringUpMutex_);
+		if (!devicePool_)
+			devicePool_ = std::make_shared<CallbackExecutor>(1, CallbackExecutor::DEFAULT_CAPACITY, OverflowPolicy::Unbounded);
+		pool = devicePool_;
+	}
+	pool->ensureWorkers(std::min(workers, maxDeviceWorkers()));
+	return pool;
+}
+
+size_t DeviceManager::maxDeviceWorkers()
+{
+	return std::max<size_t>(2, std::thread::hardware_concurrency());
+}
+
+void DeviceManager::finishBringUp(DeviceStartupTiming timing)
+{
+	std::lock_guard lock(bringUpMutex_);
+	auto now = Clock::now();
+	timing.ready = elapsed(enumerationStart_, now);
+	if (timing.ok)
+		ToolKit::print("[INFO] Device ready:", timing.path, "after", toMs(timing.ready), "ms (create", toMs(timing.create), "ms, firmware", toMs(timing.firmware), "ms)");
+	bringUp_.erase(timing.path);
+	timing_.devices.push_back(std::move(timing));
+	if (--bringingUp_ == 0)
+	{
+		timing_.total = elapsed(enumerationStart_, now);
+		ToolKit::print("[INFO] All devices ready in", toMs(timing_.total), "ms (scan", toMs(timing_.scan), "ms)");
+		bringUpCv_.notify_all();
+	}
+}
+
+std::shared_future<std::shared_ptr<StreamDock>> DeviceManager::whenReady(const std::string &path)
+{
+	{
+		std::lock_guard lock(bringUpMutex_);
+		auto it = bringUp_.find(path);
+		if (it != bringUp_.end())
+			return it->second;
+	}
+	std::promise<std::shared_ptr<StreamDock>> ready;
+	ready.set_value(registry_.find(path));
+	return ready.get_future().share();
+}
+
+bool DeviceManager::whenAllReady(std::chrono::milliseconds timeout)
+{
+	std::unique_lock lock(bringUpMutex_);
+	if (timeout == std::chrono::milliseconds::max())
+	{
+		bringUpCv_.wait(lock, [this]
+						{ return bringingUp_ == 0; });
+		return true;
+	}
+	return bringUpCv_.wait_for(lock, timeout, [this]
+							   { return bringingUp_ == 0; });
+}
+
+void DeviceManager::setStateRestore(bool enable)
+{
+	stateRestore_ = enable;
+	if (!enable)
+	{
+		std::lock_guard lock(journalsMutex_);
+		journals_.clear();
+	}
+}
+
+StartupTiming DeviceManager::startupTiming() const
+{
+	std::lock_guard lock(bringUpMutex_);
+	return timing_;
+}
+
+bool DeviceManager::isSupported(const hid_device_info &info)
+{
+	return StreamDockFactory::instance().exist(info.vendor_id, info.product_id) && StreamDock::isStreamDockHidDeviceUsage(info) /* &&
+		StreamDock::isStreamDockHidDevice(info)*/;
+}
+
+std::shared_ptr<StreamDock> DeviceManager::attach(const std::shared_ptr<DeviceEnumerator::DeviceInfo> &device, DeviceStartupTiming *timing)
+{
+	if (auto existing = registry_.find(device->_path)) /// exist this device and pass
+		return existing;
+	// Opening the transport and querying the firmware is slow; do it outside the lock
+	auto start = Clock::now();
+	std::shared_ptr<StreamDock> dock = StreamDockFactory::instance().create(device->_vendor_id, device->_product_id, device->toPureHidDeviceInfo());
+	auto created = Clock::now();
+	if (timing)
+		timing->create = elapsed(start, created);
+	if (!dock)
+		return nullptr;
+	bool fromCache = dock->configuredFromCache();
+	if (dock->info())
+	{
+		dock->info()->firmwareVersion = dock->getFirmwareVersion(); /// No round-trip when configured from the cache
+		ToolKit::print("Firmware Version:", dock->info()->firmwareVersion, fromCache ? "(cached)" : "");
+		if (!fromCache && !DeviceCache::trimFirmwareVersion(dock->info()->firmwareVersion).empty())
+			DeviceCache::instance().store(device->_vendor_id, device->_product_id, device->_serial_number, dock->cacheEntry()); // The answer verified the report sizes
+	}
+	auto versioned = Clock::now();
+	if (timing)
+	{
+		timing->firmware = elapsed(created, versioned);
+		timing->ok = true;
+	}
+	if (stateRestore_ && !device->_serial_number.empty())
+	{
+		std::shared_ptr<StateJournal> journal;
+		{
+			std::lock_guard lock(journalsMutex_);
+			auto &slot = journals_[std::to_wstring((static_cast<uint32_t>(device->_vendor_id) << 16) | device->_product_id) + L":" + device->_serial_number];
+			if (!slot.journal)
+				slot.journal = std::make_shared<StateJournal>();
+			slot.lastAttached = Clock::now();
+			journal = slot.journal;
+			pruneJournals();
 		}
+		dock->setStateJournal(journal);
+		if (!journal->empty())
+		{
+			// Same device seen before (hub reset, KVM switch): put its display back without the application
+			size_t bytes = journal->snapshot().payloadBytes();
+			dock->restoreState();
+			auto restored = elapsed(versioned);
+			if (timing)
+				timing->restore = restored;
+			ToolKit::print("[INFO] Restored state of", device->_path, ":", bytes, "bytes in", toMs(restored), "ms");
+		}
+		StreamDock *raw = dock.get();
+		dock->heartbeater()->setRecoveryCallback([raw]
+												 { raw->restoreState(); });
 	}
-	ToolKit::print("[INFO] streamdock device count:", streamdocks_.size());
+	auto registered = registry_.insert(device->_path, std::move(dock));
+	if (fromCache)
+		revalidate(device, registered);
+	return registered;
+}
+
+void DeviceManager::revalidate(const std::shared_ptr<DeviceEnumerator::DeviceInfo> &device, const std::shared_ptr<StreamDock> &dock)
+{
+	std::weak_ptr<StreamDock> weak = dock;
+	// Same key as the bring-up task, so it runs after the device's bring-up and never on the application's executor
+	devicePool(1)->post(std::hash<std::string>()(device->_path), [this, device, weak]
+									 {
+										 auto dock = weak.lock();
+										 if (!dock || registry_.find(device->_path) != dock)
+											 return; // Gone already
+										 std::string cached = DeviceCache::trimFirmwareVersion(dock->info()->firmwareVersion);
+										 std::string current = DeviceCache::trimFirmwareVersion(dock->queryFirmwareVersion());
+										 if (current.empty() || current == cached)
+											 return;
+										 // Firmware was updated: capabilities derived from it may differ, so cache the new version and re-create the device
+										 ToolKit::print("[INFO] Firmware of", device->_path, "changed from", cached, "to", current, "; re-creating the device");
+										 DeviceCacheEntry entry = dock->cacheEntry();
+										 entry.firmwareVersion = current;
+										 DeviceCache::instance().store(device->_vendor_id, device->_product_id, device->_serial_number, entry);
+										 dock.reset();
+										 if (detach(device->_path))
+											 attach(device); });
+}
+
+bool DeviceManager::detach(const std::string &path)
+{
+	return registry_.erase(path) != nullptr;
+}
+
+void DeviceManager::pruneJournals()
+{
+	while (journals_.size() > MAX_STATE_JOURNALS)
+	{
+		// Forget the device attached longest ago that has no StreamDock right now
+		auto oldest = journals_.end();
+		for (auto it = journals_.begin(); it != journals_.end(); ++it)
+		{
+			if (it->second.journal.use_count() == 1 && (oldest == journals_.end() || it->second.lastAttached < oldest->second.lastAttached))
+				oldest = it;
+		}
+		if (oldest == journals_.end())
+			return; // Every journal belongs to a live device
+		journals_.erase(oldest);
+	}
+}
+
+DeviceRegistry::Snapshot DeviceManager::getStreamDocks() const
+{
+	return registry_.snapshot();
+}
+
+DeviceRegistry &DeviceManager::registry()
+{
+	return registry_;
 }
 
-std::unordered_map<std::string, std::shared_ptr<StreamDock>> &DeviceManager::getStreamDocks()
+std::future<std::vector<BroadcastResult>> DeviceManager::broadcast(const BroadcastImage &image, std::function<void(const BroadcastResult &)> onDevice)
 {
-	return streamdocks_;
+	struct Target
+	{
+		size_t index;
+		std::string path;
+		std::shared_ptr<StreamDock> dock;
+	};
+	struct Group
+	{
+		ImageEncodeProfile profile;
+		std::vector<Target> targets;
+	};
+	struct State
+	{
+		std::mutex mutex;
+		std::vector<BroadcastResult> results;
+		size_t remaining = 0;
+		std::promise<std::vector<BroadcastResult>> done;
+		std::function<void(const BroadcastResult &)> onDevice;
+
+		void finish(size_t index, BroadcastResult result)
+		{
+			if (onDevice)
+			{
+				try
+				{
+					onDevice(result);
+				}
+				catch (const std::exception &e)
+				{
+					ToolKit::print("[ERROR] Broadcast callback threw exception:", e.what());
+				}
+				catch (...)
+				{
+					ToolKit::print("[ERROR] Broadcast callback threw an unknown exception");
+				}
+			}
+			std::lock_guard lock(mutex);
+			results[index] = std::move(result);
+			if (--remaining == 0)
+				done.set_value(std::move(results));
+		}
+	};
+
+	auto source = std::make_shared<const std::string>(StreamDock::readImgToString(image.filePath)); // Throws like setKeyImgFile()
+
+	std::vector<std::pair<std::string, std::shared_ptr<StreamDock>>> devices;
+	auto docks = registry_.snapshot();
+	if (image.paths.empty())
+	{
+		devices.assign(docks->begin(), docks->end());
+	}
+	else
+	{
+		for (const auto &path : image.paths)
+		{
+			auto it = docks->find(path);
+			devices.emplace_back(path, it != docks->end() ? it->second : nullptr);
+		}
+	}
+
+	auto state = std::make_shared<State>();
+	state->onDevice = std::move(onDevice);
+	state->results.resize(devices.size());
+	state->remaining = devices.size();
+	auto future = state->done.get_future();
+	if (devices.empty())
+	{
+		state->done.set_value({});
+		return future;
+	}
+
+	// Group the devices that turn the image into the same stream
+	std::vector<Group> groups;
+	std::vector<Target> unsupported;
+	for (size_t i = 0; i < devices.size(); ++i)
+	{
+		Target target{ i, devices[i].first, devices[i].second };
+		ImageEncodeProfile profile;
+		if (target.dock && image.target == BroadcastTarget::Background)
+			profile = target.dock->backgroundEncodeProfile();
+		else if (target.dock && !target.dock->outOfRange(image.keyValue))
+			profile = target.dock->keyEncodeProfile(image.keyValue);
+		if (!profile.valid())
+		{
+			unsupported.push_back(std::move(target)); // Gone, no encoder, or no such key/background
+			continue;
+		}
+		auto group = std::find_if(groups.begin(), groups.end(), [&profile](const Group &candidate)
+								  { return candidate.profile.sameAs(profile); });
+		if (group == groups.end())
+			group = groups.insert(groups.end(), Group{ std::move(profile), {} });
+		group->targets.push_back(std::move(target));
+	}
+	for (const auto &target : unsupported)
+	{
+		BroadcastResult result;
+		result.path = target.path;
+		state->finish(target.index, std::move(result));
+	}
+
+	auto executor = devicePool(std::max(groups.size(), devices.size() - unsupported.size()));
+	BroadcastTarget kind = image.target;
+	uint8_t keyValue = image.keyValue;
+	uint32_t timeoutMs = image.timeoutMs;
+	for (auto &group : groups)
+	{
+		auto shared = std::make_shared<const Group>(std::move(group));
+		executor->post(std::hash<const void *>()(shared.get()), [executor, shared, source, state, kind, keyValue, timeoutMs]
+					   {
+						   auto start = Clock::now();
+						   auto &input = BufferPool::acquireBytes(ByteSlot::Input, source->size());
+						   std::copy(source->begin(), source->end(), input.begin());
+						   auto &output = BufferPool::acquireBytes(ByteSlot::Output);
+						   std::shared_ptr<const std::string> stream;
+						   try
+						   {
+							   if (shared->profile.encode(input, output))
+								   stream = std::make_shared<const std::string>(output.begin(), output.end());
+							   else
+								   ToolKit::print("[ERROR] Failed to encode broadcast image for", shared->targets.size(), "device(s)");
+						   }
+						   catch (const std::exception &e)
+						   {
+							   ToolKit::print("[ERROR] Broadcast encoder threw exception:", e.what());
+						   }
+						   catch (...)
+						   {
+							   ToolKit::print("[ERROR] Broadcast encoder threw an unknown exception");
+						   }
+						   // From here on every target reaches finish(), so the future always resolves
+						   auto encoded = elapsed(start);
+						   for (const auto &target : shared->targets)
+						   {
+							   BroadcastResult result;
+							   result.path = target.path;
+							   result.encode = encoded;
+							   if (!stream)
+							   {
+								   state->finish(target.index, std::move(result));
+								   continue;
+							   }
+							   // One task per device: uploads to different devices run side by side
+							   executor->post(std::hash<std::string>()(target.path), [target, stream, state, kind, keyValue, timeoutMs, result]() mutable
+											  {
+												  auto start = Clock::now();
+												  try
+												  {
+													  if (kind == BroadcastTarget::Key)
+														  result.ok = target.dock->setKeyImgFileStream(*stream, keyValue);
+													  else
+														  result.ok = target.dock->setBackgroundImgStream(*stream, timeoutMs);
+												  }
+												  catch (...)
+												  {
+													  ToolKit::print("[ERROR] Broadcast upload to", target.path, "threw an exception");
+												  }
+												  result.upload = elapsed(start);
+												  state->finish(target.index, std::move(result)); });
+						   } });
+	}
+	return future;
 }
 
 DeviceManager::~DeviceManager()
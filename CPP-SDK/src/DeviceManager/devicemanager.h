@@ -3,9 +3,12 @@
  * @brief Singleton class for managing StreamDock devices with enumeration and plug/unplug monitoring.
  *
  * Main Features:
- * - Enumerate currently connected devices
+ * - Enumerate currently connected devices, bringing them up in parallel
  * - Start a background thread to listen for device events (cross-platform)
- * - Manage and provide access to all active StreamDock instances
+ * - Manage and provide access to all active StreamDock instances through lock-free snapshots
+ * - Keep a state journal per serial number and replay it when the device reconnects
+ * - Configure known devices from the on-disk DeviceCache and revalidate them in the background
+ * - Broadcast an image to many devices, encoding it once per encode profile
  */
 #pragma once
 #ifdef _WIN32
@@ -14,12 +17,70 @@
 #include <Dbt.h>
 #include <regex>
 #endif
+#include <chrono>
+#include <condition_variable>
+#include <future>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include <streamdock.h>
 #include <streamdockfactory.h>
 #include <toolkit.h>
+#include <callbackexecutor.h>
 #include "./DeviceEnumerator/deviceenumerator.h"
+#include "deviceregistry.h"
+
+/**
+ * @brief Bring-up time of one device, per phase.
+ */
+struct DeviceStartupTiming
+{
+	std::string path;
+	std::chrono::microseconds create{ 0 };		///< Factory create: transport open, controller threads.
+	std::chrono::microseconds firmware{ 0 };	///< Firmware version query.
+	std::chrono::microseconds restore{ 0 };		///< Replay of the state journal of a reconnected device.
+	std::chrono::microseconds ready{ 0 };		///< From the start of the enumeration until the device was registered.
+	bool ok = false;							///< False if the device could not be created.
+};
+
+enum class BroadcastTarget : uint8_t
+{
+	Key,
+	Background,
+};
+
+/**
+ * @brief An image to send to several devices with DeviceManager::broadcast().
+ */
+struct BroadcastImage
+{
+	BroadcastTarget target = BroadcastTarget::Key;
+	std::string filePath;
+	uint8_t keyValue = 1;			///< Key to set (BroadcastTarget::Key).
+	uint32_t timeoutMs = 3000;		///< Background upload timeout (BroadcastTarget::Background).
+	std::vector<std::string> paths; ///< HID paths of the devices to send to; empty: every registered device.
+};
+
+/**
+ * @brief Outcome of a broadcast on one device.
+ */
+struct BroadcastResult
+{
+	std::string path;
+	bool ok = false;						///< The stream was valid for the device and the device accepted the write.
+	std::chrono::microseconds encode{ 0 };	///< Encode time of the device's group, shared by every device in it.
+	std::chrono::microseconds upload{ 0 };
+};
+
+/**
+ * @brief Timing of the last enumerator() run.
+ */
+struct StartupTiming
+{
+	std::chrono::microseconds scan{ 0 };	///< Bus scan and filtering.
+	std::chrono::microseconds total{ 0 };	///< Until the last device was ready; readiness is bounded by the slowest device, not the sum.
+	std::vector<DeviceStartupTiming> devices;
+};
 
  /**
   * @class DeviceManager
@@ -44,10 +105,47 @@ public:
 	DeviceManager& operator=(const DeviceManager&) = delete;
 
 	/**
-	 * @brief Enumerate currently connected StreamDock devices.
+	 * @brief Enumerate currently connected StreamDock devices and wait until all of them are ready.
 	 */
 	void enumerator();
 
+	/**
+	 * @brief Enumerate currently connected StreamDock devices without waiting for them.
+	 *
+	 * New devices are created concurrently on the device pool (see devicePool(): one worker per device
+	 * coming up, at most maxDeviceWorkers()), which never drops a task. Use whenReady() or whenAllReady()
+	 * to wait for them.
+	 */
+	void enumeratorAsync();
+
+	/**
+	 * @brief Readiness of the device with the given HID path.
+	 * @return A future holding the device once it is registered, or nullptr if it is unknown or failed to come up.
+	 */
+	std::shared_future<std::shared_ptr<StreamDock>> whenReady(const std::string& path);
+
+	/**
+	 * @brief Wait until every device started by enumeratorAsync() is ready or has failed.
+	 * @return False if `timeout` passed first.
+	 */
+	bool whenAllReady(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+	/**
+	 * @brief Per-phase timing of the last enumeration.
+	 */
+	StartupTiming startupTiming() const;
+
+	/**
+	 * @brief Keep a state journal per device serial number and replay it when that device is attached
+	 * again or its link is recovered (enabled by default). Disabling drops the journals.
+	 * Journals of the MAX_STATE_JOURNALS devices attached most recently are kept; older ones of devices
+	 * that are not connected are dropped.
+	 * @note Devices without a serial number are not journaled. Applies to devices attached afterwards.
+	 */
+	void setStateRestore(bool enable);
+
+	static constexpr size_t MAX_STATE_JOURNALS = 32;
+
 	/**
 	 * @brief Start a background thread to monitor device plug/unplug events.
 	 * @param connect_and_run Optional callback to execute when a new device is connected and initialized.
@@ -61,15 +159,94 @@ public:
 
 	/**
 	 * @brief Get all currently connected StreamDock devices.
-	 * @return A map where the key is the HID path, and the value is the corresponding device object.
+	 * @return An immutable snapshot: a map where the key is the HID path, and the value is the corresponding
+	 * device object. Safe to iterate while devices are plugged and unplugged.
 	 */
-	std::unordered_map<std::string, std::shared_ptr<StreamDock>>& getStreamDocks();
+	DeviceRegistry::Snapshot getStreamDocks() const;
+
+	/**
+	 * @brief The device registry, to subscribe to add/remove notifications.
+	 */
+	DeviceRegistry& registry();
+
+	/**
+	 * @brief Send one image to several devices.
+	 *
+	 * The file is read once and the devices are grouped by their encode profile (ImgHelper, encoder type,
+	 * quality, format selection), so devices of the same model share one encode. Groups are encoded and the
+	 * uploads run on the device pool that also brings devices up: one task per device on up to
+	 * maxDeviceWorkers() workers, and no task is ever dropped. A throwing encoder, upload or `onDevice` is logged and the
+	 * devices concerned finish with ok = false, so the future always resolves.
+	 *
+	 * @param onDevice Optional; called once per device as soon as it is done, on the thread that finished it.
+	 * @return The results in the order of `image.paths` (or of the registry snapshot), once every device is done.
+	 * @throw std::runtime_error if the file can't be read, like StreamDock::setKeyImgFile().
+	 */
+	std::future<std::vector<BroadcastResult>> broadcast(const BroadcastImage& image, std::function<void(const BroadcastResult&)> onDevice = nullptr);
 
 private:
-	std::unordered_map<std::string, std::shared_ptr<StreamDock>> streamdocks_; ///< Map of currently connected StreamDock devices. Key is the HID path, value is the associated device object.
+	/**
+	 * @brief Whether a HID node is a StreamDock control interface this SDK can drive.
+	 */
+	static bool isSupported(const hid_device_info& info);
+
+	/**
+	 * @brief Create the StreamDock for one supported device and register it under its HID path.
+	 * @param timing Optional; receives the create and firmware phase times.
+	 * @return The registered device (the existing one if the path is known), or nullptr if creation failed.
+	 */
+	std::shared_ptr<StreamDock> attach(const std::shared_ptr<DeviceEnumerator::DeviceInfo>& device, DeviceStartupTiming* timing = nullptr);
+
+	/**
+	 * @brief Check a device configured from DeviceCache against its real firmware version on the device
+	 * pool, keyed by HID path like its bring-up; on a mismatch update the cache and re-create the device.
+	 */
+	void revalidate(const std::shared_ptr<DeviceEnumerator::DeviceInfo>& device, const std::shared_ptr<StreamDock>& dock);
+
+	/**
+	 * @brief Pool for per-device I/O (bring-up, broadcast uploads): Unbounded, never hooked, keyed by HID path.
+	 * @param workers Grow the pool to this many workers (one per device being worked on), capped at
+	 * maxDeviceWorkers(). Workers stay for the life of the process, so the cap bounds the idle threads.
+	 */
+	std::shared_ptr<CallbackExecutor> devicePool(size_t workers);
+
+	/// Worker cap of devicePool(): the hardware thread count, at least 2. The tasks are short I/O.
+	static size_t maxDeviceWorkers();
+
+	/**
+	 * @brief Drop the least recently attached journals of disconnected devices beyond MAX_STATE_JOURNALS; under journalsMutex_.
+	 */
+	void pruneJournals();
+
+	/**
+	 * @brief Record the timing of a finished bring-up task and wake whenAllReady() after the last one.
+	 */
+	void finishBringUp(DeviceStartupTiming timing);
+
+	/**
+	 * @brief Unregister the device with the given HID path.
+	 * @return True if a device was removed.
+	 */
+	bool detach(const std::string& path);
+
+	DeviceRegistry registry_;                                                  ///< Currently connected StreamDock devices by HID path.
 	std::thread listener_;                                                     ///< Background thread that listens for device plug/unplug events.
 	std::atomic_bool isListening_ = false;                                     ///< Flag indicating whether the device listener is active.
-	std::mutex streamdocksMutex_;                                              ///< Mutex to protect access to streamdocks_ and ensure thread safety.
+	std::mutex journalsMutex_;                                                 ///< Guards journals_.
+	struct JournalSlot
+	{
+		std::shared_ptr<StateJournal> journal;
+		std::chrono::steady_clock::time_point lastAttached;
+	};
+	std::unordered_map<std::wstring, JournalSlot> journals_;                   ///< State journal per VID/PID and serial number; outlives the device.
+	std::atomic_bool stateRestore_ = true;                                     ///< Whether devices get a journal and are restored from it.
+	std::unordered_map<std::string, std::shared_future<std::shared_ptr<StreamDock>>> bringUp_; ///< Devices being brought up by enumeratorAsync(), by HID path.
+	size_t bringingUp_ = 0;                                                    ///< Bring-up tasks not finished yet.
+	StartupTiming timing_;                                                     ///< Timing of the last enumeration.
+	std::chrono::steady_clock::time_point enumerationStart_;                   ///< Start of the last enumeration.
+	mutable std::mutex bringUpMutex_;                                          ///< Guards bringUp_, bringingUp_ and timing_.
+	std::condition_variable bringUpCv_;                                        ///< Signalled when bringingUp_ drops to zero.
+	std::shared_ptr<CallbackExecutor> devicePool_;                             ///< See devicePool(); guarded by bringUpMutex_.
 #ifdef _WIN32
 	static LRESULT WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam); ///< Windows message handler for receiving device change notifications (e.g., WM_DEVICECHANGE).
 	HWND hwnd_ = nullptr;                                                          ///< Handle to the hidden window used to receive Windows device events.
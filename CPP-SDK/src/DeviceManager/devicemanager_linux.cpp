@@ -9,6 +9,190 @@
 #include <string>
 #include <unistd.h>
 #include <cstring>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	/// Quiet time a node must have before its add/remove is acted on; one plug produces a burst of events.
+	constexpr auto HOTPLUG_DEBOUNCE = std::chrono::milliseconds(150);
+	constexpr auto LISTEN_POLL = std::chrono::milliseconds(500);
+
+	std::wstring toWide(const char* str)
+	{
+		if (!str)
+			return std::wstring();
+		size_t len = std::mbstowcs(nullptr, str, 0);
+		if (len == static_cast<size_t>(-1))
+			return std::wstring(str, str + std::strlen(str));
+		std::wstring out(len, L'\0');
+		std::mbstowcs(&out[0], str, len);
+		return out;
+	}
+
+	/**
+	 * @brief Usage page and usage of every top-level collection in a HID report descriptor,
+	 * the same pairs hid_enumerate reports for a hidraw node.
+	 */
+	std::vector<std::pair<unsigned short, unsigned short>> topLevelUsages(const std::vector<uint8_t>& desc)
+	{
+		std::vector<std::pair<unsigned short, unsigned short>> usages;
+		unsigned short usagePage = 0;
+		unsigned short usage = 0;
+		bool haveUsage = false;
+		int depth = 0;
+		size_t i = 0;
+		while (i < desc.size())
+		{
+			uint8_t key = desc[i];
+			if (key == 0xFE) // Long item: skip its data
+			{
+				if (i + 1 >= desc.size())
+					break;
+				i += 3 + desc[i + 1];
+				continue;
+			}
+			size_t size = key & 0x03;
+			if (size == 3)
+				size = 4;
+			if (i + size >= desc.size())
+				break;
+			uint32_t value = 0;
+			for (size_t k = 0; k < size; ++k)
+				value |= static_cast<uint32_t>(desc[i + 1 + k]) << (8 * k);
+
+			switch (key & 0xFC)
+			{
+			case 0x04: // Usage Page
+				usagePage = static_cast<unsigned short>(value);
+				break;
+			case 0x08: // Usage; a 4-byte usage carries its own page
+				if (!haveUsage)
+				{
+					usage = static_cast<unsigned short>(value & 0xFFFF);
+					if (size == 4)
+						usagePage = static_cast<unsigned short>(value >> 16);
+					haveUsage = true;
+				}
+				break;
+			case 0xA0: // Collection
+				if (depth++ == 0 && haveUsage)
+					usages.emplace_back(usagePage, usage);
+				haveUsage = false;
+				break;
+			case 0xC0: // End Collection
+				if (depth > 0)
+					--depth;
+				haveUsage = false;
+				break;
+			case 0x80: // Input, Output, Feature end the local usage state
+			case 0x90:
+			case 0xB0:
+				haveUsage = false;
+				break;
+			}
+			i += 1 + size;
+		}
+		return usages;
+	}
+
+	/**
+	 * @brief Device description of one hidraw node, built from udev properties and sysfs instead of
+	 * a hid_enumerate() of the whole bus. Owns the strings hid_device_info points to.
+	 */
+	struct HidrawInfo
+	{
+		std::string path;
+		std::wstring serial;
+		std::wstring manufacturer;
+		std::wstring product;
+		hid_device_info info{};
+
+		/// Fill from a hidraw udev device. Returns false if the node is not a HID device or is gone.
+		bool read(udev_device* hidraw)
+		{
+			const char* devNode = udev_device_get_devnode(hidraw);
+			udev_device* hid = udev_device_get_parent_with_subsystem_devtype(hidraw, "hid", nullptr);
+			if (!devNode || !hid)
+				return false;
+			const char* hidId = udev_device_get_property_value(hid, "HID_ID"); // bus:vendor:product, hex
+			unsigned int bus = 0, vid = 0, pid = 0;
+			if (!hidId || std::sscanf(hidId, "%x:%x:%x", &bus, &vid, &pid) != 3)
+				return false;
+			path = devNode;
+			info.path = &path[0];
+			info.vendor_id = static_cast<unsigned short>(vid);
+			info.product_id = static_cast<unsigned short>(pid);
+			return true;
+		}
+
+		/// Read the report descriptor and the USB strings; only done for VID/PIDs the factory knows.
+		bool readDetails(udev_device* hidraw)
+		{
+			udev_device* hid = udev_device_get_parent_with_subsystem_devtype(hidraw, "hid", nullptr);
+			const char* hidPath = hid ? udev_device_get_syspath(hid) : nullptr;
+			if (!hidPath)
+				return false;
+			std::ifstream file(std::string(hidPath) + "/report_descriptor", std::ios::binary);
+			std::vector<uint8_t> desc((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			auto usages = topLevelUsages(desc);
+			if (usages.empty())
+				return false;
+			// Prefer the collection that identifies the StreamDock control interface
+			info.usage_page = usages.front().first;
+			info.usage = usages.front().second;
+			for (const auto& usage : usages)
+			{
+				hid_device_info probe = info;
+				probe.usage_page = usage.first;
+				probe.usage = usage.second;
+				if (StreamDock::isStreamDockHidDeviceUsage(probe))
+				{
+					info.usage_page = usage.first;
+					info.usage = usage.second;
+					break;
+				}
+			}
+
+			serial = toWide(udev_device_get_property_value(hid, "HID_UNIQ"));
+			product = toWide(udev_device_get_property_value(hid, "HID_NAME"));
+			info.interface_number = -1;
+			udev_device* intf = udev_device_get_parent_with_subsystem_devtype(hidraw, "usb", "usb_interface");
+			if (intf)
+			{
+				const char* number = udev_device_get_sysattr_value(intf, "bInterfaceNumber");
+				if (number)
+					info.interface_number = static_cast<int>(std::strtol(number, nullptr, 16));
+			}
+			udev_device* usb = udev_device_get_parent_with_subsystem_devtype(hidraw, "usb", "usb_device");
+			if (usb)
+			{
+				manufacturer = toWide(udev_device_get_sysattr_value(usb, "manufacturer"));
+				if (const char* name = udev_device_get_sysattr_value(usb, "product"))
+					product = toWide(name);
+				if (const char* bcd = udev_device_get_sysattr_value(usb, "bcdDevice"))
+					info.release_number = static_cast<unsigned short>(std::strtol(bcd, nullptr, 16));
+			}
+			info.serial_number = &serial[0];
+			info.manufacturer_string = &manufacturer[0];
+			info.product_string = &product[0];
+			return true;
+		}
+	};
+
+	struct PendingEvent
+	{
+		bool add = false;
+		bool removed = false;	///< A remove was seen; an add after it is a replug, so the old device goes first.
+		std::string syspath;
+		std::chrono::steady_clock::time_point due;
+	};
+}
 
 void DeviceManager::listen(std::function<void(std::shared_ptr<StreamDock>)> connect_and_run)
 {
@@ -28,53 +212,79 @@ void DeviceManager::listen(std::function<void(std::shared_ptr<StreamDock>)> conn
 			int fd = udev_monitor_get_fd(mon);
 			struct pollfd fds = { fd, POLLIN, 0 };
 
+			// Latest event per device node, acted on once the node has been quiet for HOTPLUG_DEBOUNCE
+			std::unordered_map<std::string, PendingEvent> pending;
+
+			auto handleAdd = [&](const std::string& devNode, const std::string& syspath) {
+				struct udev_device* dev = udev_device_new_from_syspath(udev, syspath.c_str());
+				if (!dev)
+					return; // Unplugged again before it settled
+				HidrawInfo hidraw;
+				bool supported = hidraw.read(dev) && hidraw.path == devNode &&
+					StreamDockFactory::instance().exist(hidraw.info.vendor_id, hidraw.info.product_id) &&
+					hidraw.readDetails(dev) && isSupported(hidraw.info);
+				udev_device_unref(dev);
+				if (!supported)
+					return;
+				auto device = DeviceEnumerator::instance().add(hidraw.info);
+				auto dock = attach(device);
+				if (!dock)
+					return;
+				ToolKit::print("[+] HID Device Added: ", devNode);
+				if (connect_and_run)
+					connect_and_run(dock);
+			};
+
+			auto handleRemove = [&](const std::string& devNode) {
+				DeviceEnumerator::instance().remove(devNode);
+				if (detach(devNode))
+					ToolKit::print("[-] HID Device Removed: ", devNode);
+			};
+
 			while (isListening_) {
-				int ret = poll(&fds, 1, 500);
+				auto now = std::chrono::steady_clock::now();
+				auto wait = LISTEN_POLL;
+				for (const auto& entry : pending)
+					wait = std::min(wait, std::chrono::duration_cast<std::chrono::milliseconds>(entry.second.due - now) + std::chrono::milliseconds(1));
+				if (wait < std::chrono::milliseconds(0))
+					wait = std::chrono::milliseconds(0);
+
+				int ret = poll(&fds, 1, static_cast<int>(wait.count()));
 				if (ret > 0 && (fds.revents & POLLIN)) {
 					struct udev_device* dev = udev_monitor_receive_device(mon);
 					if (dev) {
-						std::string action = udev_device_get_action(dev);
-						std::string devNode = udev_device_get_devnode(dev) ? udev_device_get_devnode(dev) : "";
-
-						if (!devNode.empty()) {
-							if (action == "add") {
-								/// if the device support begin
-								bool canConnect = false;
-								hid_device_info* devs = hid_enumerate(0x0, 0x0);
-								auto cur = devs;
-								while (cur) {
-									DeviceEnumerator::DeviceInfo device(*cur);
-									if (StreamDockFactory::instance().exist(device._vendor_id, device._product_id) && StreamDock::isStreamDockHidDeviceUsage(device.toPureHidDeviceInfo())/* &&
-										StreamDock::isStreamDockHidDevice(device.toPureHidDeviceInfo())*/ && (cur->path == devNode))
-										canConnect = true;
-									cur = cur->next;
-								}
-								if (!canConnect) {
-									hid_free_enumeration(devs);
-									continue;
-								}
-								hid_free_enumeration(devs);
-								/// if the device support end
-								enumerator();  // Re-enumerate devices
-								std::lock_guard<std::mutex> lock(streamdocksMutex_);
-								auto it = getStreamDocks().find(devNode);
-								if (it != getStreamDocks().end() && connect_and_run) {
-									connect_and_run(it->second);
-								}
-								ToolKit::print("[+] HID Device Added: ", devNode);
-							}
-							else if (action == "remove") {
-								std::lock_guard<std::mutex> lock(streamdocksMutex_);
-								auto& docks = getStreamDocks();
-								if (docks.find(devNode) != docks.end()) {
-									docks.erase(devNode);
-									ToolKit::print("[-] HID Device Removed: ", devNode);
-								}
+						const char* action = udev_device_get_action(dev);
+						const char* devNode = udev_device_get_devnode(dev);
+						const char* syspath = udev_device_get_syspath(dev);
+						if (action && devNode && syspath) {
+							std::string act = action;
+							if (act == "add" || act == "remove") {
+								// A later event for the same node replaces the earlier one and restarts its quiet time
+								PendingEvent& event = pending[devNode];
+								event.add = act == "add";
+								event.removed = event.removed || !event.add;
+								event.syspath = syspath;
+								event.due = std::chrono::steady_clock::now() + HOTPLUG_DEBOUNCE;
 							}
 						}
 						udev_device_unref(dev);
 					}
 				}
+
+				now = std::chrono::steady_clock::now();
+				for (auto it = pending.begin(); it != pending.end();) {
+					if (it->second.due > now) {
+						++it;
+						continue;
+					}
+					std::string devNode = it->first;
+					PendingEvent event = std::move(it->second);
+					it = pending.erase(it);
+					if (event.removed)
+						handleRemove(devNode);
+					if (event.add)
+						handleAdd(devNode, event.syspath);
+				}
 			}
 
 			udev_monitor_unref(mon);
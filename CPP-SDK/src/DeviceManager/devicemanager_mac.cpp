@@ -16,12 +16,9 @@ void DeviceManager::listen(std::function<void(std::shared_ptr<StreamDock>)> conn
 			std::unordered_set<std::string> currentDevicePaths;
 
 			// Initialize current device list
+			for (const auto& pair : *registry_.snapshot())
 			{
-				std::lock_guard<std::mutex> lock(streamdocksMutex_);
-				for (const auto& pair : streamdocks_)
-				{
-					currentDevicePaths.insert(pair.first);
-				}
+				currentDevicePaths.insert(pair.first);
 			}
 
 			// Polling interval in milliseconds (same as Python SDK)
@@ -33,7 +30,7 @@ void DeviceManager::listen(std::function<void(std::shared_ptr<StreamDock>)> conn
 				{
 					// Enumerate all HID devices
 					DeviceEnumerator::instance().enumerate();
-					const auto& allDevices = DeviceEnumerator::instance().currDevices();
+					const auto allDevices = DeviceEnumerator::instance().currDevices();
 
 					// Collect paths of supported StreamDock devices
 					std::unordered_set<std::string> newDevicePaths;
@@ -69,19 +66,13 @@ void DeviceManager::listen(std::function<void(std::shared_ptr<StreamDock>)> conn
 					}
 
 					// Handle removed devices first
-					if (!removedDevices.empty())
+					for (const auto& path : removedDevices)
 					{
-						std::lock_guard<std::mutex> lock(streamdocksMutex_);
-						for (const auto& path : removedDevices)
+						if (detach(path))
 						{
-							auto it = streamdocks_.find(path);
-							if (it != streamdocks_.end())
-							{
-								std::ostringstream oss;
-								oss << "[-] HID Device Removed: " << path;
-								ToolKit::print(oss.str());
-								streamdocks_.erase(it);
-							}
+							std::ostringstream oss;
+							oss << "[-] HID Device Removed: " << path;
+							ToolKit::print(oss.str());
 						}
 					}
 
@@ -91,11 +82,10 @@ void DeviceManager::listen(std::function<void(std::shared_ptr<StreamDock>)> conn
 						// Re-enumerate to create device objects
 						enumerator();
 
-						std::lock_guard<std::mutex> lock(streamdocksMutex_);
 						for (const auto& path : addedDevices)
 						{
-							auto it = streamdocks_.find(path);
-							if (it != streamdocks_.end())
+							auto dock = registry_.find(path);
+							if (dock)
 							{
 								std::ostringstream oss;
 								oss << "[+] HID Device Added: " << path;
@@ -104,7 +94,7 @@ void DeviceManager::listen(std::function<void(std::shared_ptr<StreamDock>)> conn
 								// Call the callback if provided
 								if (connect_and_run)
 								{
-									connect_and_run(it->second);
+									connect_and_run(dock);
 								}
 							}
 						}
@@ -49,11 +49,9 @@ LRESULT DeviceManager::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lP
 				manager->enumerator();
 				if (!connectCallback)
 					break;
-				std::shared_ptr<StreamDock> dock;
-				{
-					std::lock_guard lock(manager->streamdocksMutex_);
-					dock = (manager->getStreamDocks().find(devicePath))->second;
-				}
+				std::shared_ptr<StreamDock> dock = manager->registry_.find(devicePath);
+				if (!dock)
+					break;
 				ToolKit::print("[+] HID Device Added: ", devicePath);
 				try
 				{
@@ -72,13 +70,8 @@ LRESULT DeviceManager::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lP
 			if (pDevIntf->dbcc_devicetype != DBT_DEVTYP_DEVICEINTERFACE)
 				break;
 			std::string devicePath = pDevIntf->dbcc_name;
-			std::lock_guard lock(manager->streamdocksMutex_);
-			auto found = manager->getStreamDocks().find(devicePath);
-			if (found != manager->getStreamDocks().end())
-			{
-				manager->getStreamDocks().erase(devicePath);
+			if (manager->detach(devicePath))
 				ToolKit::print("[-] HID Device Removed: ", devicePath);
-			}
 			break;
 		}
 		default:
@@ -0,0 +1,136 @@
+#include "deviceregistry.h"
+#include <algorithm>
+#include <toolkit.h>
+
+DeviceRegistry::DeviceRegistry()
+	: _current(std::make_shared<const Map>())
+{
+}
+
+DeviceRegistry::Snapshot DeviceRegistry::snapshot() const
+{
+	return std::atomic_load(&_current);
+}
+
+std::shared_ptr<StreamDock> DeviceRegistry::find(const std::string& path) const
+{
+	auto current = snapshot();
+	auto it = current->find(path);
+	return it != current->end() ? it->second : nullptr;
+}
+
+size_t DeviceRegistry::size() const
+{
+	return snapshot()->size();
+}
+
+std::shared_ptr<StreamDock> DeviceRegistry::insert(const std::string& path, std::shared_ptr<StreamDock> device)
+{
+	std::unique_lock<std::mutex> lock(_writeMutex);
+	auto current = std::atomic_load(&_current);
+	auto it = current->find(path);
+	if (it != current->end())
+		return it->second;
+	auto next = std::make_shared<Map>(*current);
+	(*next)[path] = device;
+	publish(lock, std::move(next), DeviceChange::Added, { { path, device } });
+	return device;
+}
+
+std::shared_ptr<StreamDock> DeviceRegistry::erase(const std::string& path)
+{
+	std::unique_lock<std::mutex> lock(_writeMutex);
+	auto current = std::atomic_load(&_current);
+	auto it = current->find(path);
+	if (it == current->end())
+		return nullptr;
+	auto device = it->second;
+	auto next = std::make_shared<Map>(*current);
+	next->erase(path);
+	publish(lock, std::move(next), DeviceChange::Removed, { { path, device } });
+	return device;
+}
+
+std::vector<std::pair<std::string, std::shared_ptr<StreamDock>>> DeviceRegistry::eraseIf(const std::function<bool(const std::string& path, const std::shared_ptr<StreamDock>& device)>& remove)
+{
+	std::unique_lock<std::mutex> lock(_writeMutex);
+	auto current = std::atomic_load(&_current);
+	Changes removed;
+	for (const auto& entry : *current)
+	{
+		if (remove(entry.first, entry.second))
+			removed.emplace_back(entry.first, entry.second);
+	}
+	if (removed.empty())
+		return removed;
+	auto next = std::make_shared<Map>(*current);
+	for (const auto& entry : removed)
+		next->erase(entry.first);
+	publish(lock, std::move(next), DeviceChange::Removed, removed);
+	return removed;
+}
+
+void DeviceRegistry::publish(std::unique_lock<std::mutex>& lock, std::shared_ptr<Map> next, DeviceChange change, const Changes& changes)
+{
+	std::atomic_store(&_current, Snapshot(std::move(next)));
+	{
+		// Queued before the next writer gets in, so events keep the publish order
+		std::lock_guard<std::mutex> events(_eventMutex);
+		for (const auto& entry : changes)
+			_events.push_back({ change, entry.first, entry.second });
+	}
+	lock.unlock();
+	deliver();
+}
+
+void DeviceRegistry::deliver()
+{
+	std::unique_lock<std::mutex> events(_eventMutex);
+	if (_delivering)
+		return; // That thread picks up our events too
+	_delivering = true;
+	while (!_events.empty())
+	{
+		Event event = std::move(_events.front());
+		_events.pop_front();
+		events.unlock();
+		std::vector<std::pair<ListenerId, Listener>> listeners;
+		{
+			std::lock_guard<std::mutex> listenerLock(_listenerMutex);
+			listeners = _listeners;
+		}
+		for (const auto& listener : listeners)
+		{
+			try
+			{
+				listener.second(event.change, event.path, event.device);
+			}
+			catch (const std::exception& e)
+			{
+				ToolKit::print("[ERROR] Device registry listener threw exception:", e.what());
+			}
+			catch (...)
+			{
+				ToolKit::print("[ERROR] Device registry listener threw an unknown exception");
+			}
+		}
+		events.lock();
+	}
+	_delivering = false;
+}
+
+DeviceRegistry::ListenerId DeviceRegistry::subscribe(Listener listener)
+{
+	std::lock_guard<std::mutex> lock(_listenerMutex);
+	ListenerId id = _nextListener++;
+	_listeners.emplace_back(id, std::move(listener));
+	return id;
+}
+
+void DeviceRegistry::unsubscribe(ListenerId id)
+{
+	std::lock_guard<std::mutex> lock(_listenerMutex);
+	_listeners.erase(std::remove_if(_listeners.begin(), _listeners.end(), [id](const std::pair<ListenerId, Listener>& entry)
+									{ return entry.first == id; }),
+					 _listeners.end());
+}
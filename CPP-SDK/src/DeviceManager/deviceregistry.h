@@ -0,0 +1,108 @@
+/**
+ * @file deviceregistry.h
+ * @brief Registry of active StreamDock devices that publishes immutable snapshots.
+ *
+ * Every change copies the map, applies the change and publishes the copy; readers take the current
+ * snapshot without locking and can iterate it for as long as they like while hotplug adds and removes
+ * devices. Changes are rare (plug, unplug) and the map is small, so the copy is cheap.
+ *
+ * Listeners are told about every add and remove, one at a time and in the order the changes were
+ * published, on the thread that made the change (or on a thread that is already delivering earlier ones).
+ *
+ * Example usage:
+ *   auto docks = DeviceManager::instance().getStreamDocks();
+ *   for (const auto& device : *docks)
+ *       device.second->refresh();
+ *   auto id = DeviceManager::instance().registry().subscribe([](DeviceChange change, const std::string& path, const std::shared_ptr<StreamDock>& device) { ... });
+ */
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class StreamDock;
+
+enum class DeviceChange : uint8_t
+{
+	Added,
+	Removed,
+};
+
+class DeviceRegistry
+{
+public:
+	using Map = std::unordered_map<std::string, std::shared_ptr<StreamDock>>;	///< HID path -> device.
+	using Snapshot = std::shared_ptr<const Map>;
+	using Listener = std::function<void(DeviceChange change, const std::string& path, const std::shared_ptr<StreamDock>& device)>;
+	using ListenerId = uint64_t;
+
+	DeviceRegistry();
+
+	DeviceRegistry(const DeviceRegistry&) = delete;
+	DeviceRegistry& operator=(const DeviceRegistry&) = delete;
+
+	/// Current devices; never null, never changes after it is returned.
+	Snapshot snapshot() const;
+
+	/// Device registered under `path`, or nullptr.
+	std::shared_ptr<StreamDock> find(const std::string& path) const;
+
+	size_t size() const;
+
+	/**
+	 * @brief Register `device` under `path` unless a device is registered there already.
+	 * @return The registered device: `device`, or the one that was there first.
+	 */
+	std::shared_ptr<StreamDock> insert(const std::string& path, std::shared_ptr<StreamDock> device);
+
+	/**
+	 * @brief Unregister the device under `path`.
+	 * @return The removed device, or nullptr.
+	 */
+	std::shared_ptr<StreamDock> erase(const std::string& path);
+
+	/**
+	 * @brief Unregister every device for which `remove` returns true, as one change.
+	 * @return The removed devices.
+	 */
+	std::vector<std::pair<std::string, std::shared_ptr<StreamDock>>> eraseIf(const std::function<bool(const std::string& path, const std::shared_ptr<StreamDock>& device)>& remove);
+
+	/**
+	 * @brief Call `listener` for every later add and remove.
+	 * A listener may change the registry; that change is delivered after the current one.
+	 */
+	ListenerId subscribe(Listener listener);
+
+	/// Stop calling a listener. A call already in progress on another thread still finishes.
+	void unsubscribe(ListenerId id);
+
+private:
+	using Changes = std::vector<std::pair<std::string, std::shared_ptr<StreamDock>>>;
+
+	struct Event
+	{
+		DeviceChange change;
+		std::string path;
+		std::shared_ptr<StreamDock> device;
+	};
+
+	/// Publish `next` and queue `changes`; called with `lock` (on _writeMutex) held, releases it and delivers.
+	void publish(std::unique_lock<std::mutex>& lock, std::shared_ptr<Map> next, DeviceChange change, const Changes& changes);
+	/// Deliver queued events unless another thread is doing so already.
+	void deliver();
+
+	Snapshot _current;									///< Accessed with std::atomic_load/atomic_store.
+	std::mutex _writeMutex;								///< Serializes writers.
+	std::mutex _eventMutex;								///< Guards _events and _delivering.
+	std::deque<Event> _events;							///< Published changes not delivered yet, in publish order.
+	bool _delivering = false;
+	mutable std::mutex _listenerMutex;
+	std::vector<std::pair<ListenerId, Listener>> _listeners;
+	ListenerId _nextListener = 1;
+};
@@ -7,6 +7,30 @@ static constexpr auto PID_K1Pro = 0x1015;
 static constexpr auto VID_K1ProEU = 0x6603;
 static constexpr auto PID_K1ProEU = 0x1019;
 
+static constexpr KeyDecode K1Pro_KEYS[] = {
+	/// Normal keys: 1-6 (logical) -> hardware codes for event decoding
+	/// KEY_1=0x05, KEY_2=0x03, KEY_3=0x01, KEY_4=0x06, KEY_5=0x04, KEY_6=0x02
+	{1, 0x05},
+	{2, 0x03},
+	{3, 0x01},
+	{4, 0x06},
+	{5, 0x04},
+	{6, 0x02},
+	/// Knob press events: 7-9 correspond to knobs 1, 2, 3
+	{7, 0x25, RegisterEvent::KnobRelease, RegisterEvent::KnobPress},
+	{8, 0x30, RegisterEvent::KnobRelease, RegisterEvent::KnobPress},
+	{9, 0x31, RegisterEvent::KnobRelease, RegisterEvent::KnobPress},
+	/// Knob rotate left: 10-12 correspond to knobs 1, 2, 3
+	{10, 0x50, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	{11, 0x60, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	{12, 0x90, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	/// Knob rotate right: 13-15 correspond to knobs 1, 2, 3
+	{13, 0x51, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+	{14, 0x61, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+	{15, 0x91, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+};
+static constexpr EventDecodeTable K1Pro_DECODE_TABLE(K1Pro_KEYS);
+
 bool K1Pro::registered_K1Pro = []()
 {
 	StreamDockFactory::instance().registerDevice(VID_K1Pro, PID_K1Pro,
@@ -57,58 +81,9 @@ K1Pro::K1Pro(const hid_device_info &device_info)
 
 	// K1Pro key mapping: 6 keys with hardware values 0x05, 0x03, 0x01, 0x06, 0x04, 0x02
 	// Normal keys: 1-6 map to hardware codes for image setting
-	_readValueMap = {
-		/// Normal keys: 1-6 (logical) -> hardware codes for event decoding
-		/// KEY_1=0x05, KEY_2=0x03, KEY_3=0x01, KEY_4=0x06, KEY_5=0x04, KEY_6=0x02
-		{1, 0x05},
-		{2, 0x03},
-		{3, 0x01},
-		{4, 0x06},
-		{5, 0x04},
-		{6, 0x02},
-		/// Knob press events: 7-9 correspond to knobs 1, 2, 3
-		{7, 0x25},
-		{8, 0x30},
-		{9, 0x31},
-		/// Knob rotate left: 10-12 correspond to knobs 1, 2, 3
-		{10, 0x50},
-		{11, 0x60},
-		{12, 0x90},
-		/// Knob rotate right: 13-15 correspond to knobs 1, 2, 3
-		{13, 0x51},
-		{14, 0x61},
-		{15, 0x91},
-	};
+	setDecodeTable(K1Pro_DECODE_TABLE);
 }
 
-RegisterEvent K1Pro::dispatchEvent(uint8_t readValue, uint8_t eventValue)
-{
-	// Normal key press/release events (hardware codes: 0x05, 0x03, 0x01, 0x06, 0x04, 0x02)
-	if ((readValue == 0x05 || readValue == 0x03 || readValue == 0x01 ||
-		 readValue == 0x06 || readValue == 0x04 || readValue == 0x02) &&
-		eventValue == 0x01)
-		return RegisterEvent::KeyPress;
-	if ((readValue == 0x05 || readValue == 0x03 || readValue == 0x01 ||
-		 readValue == 0x06 || readValue == 0x04 || readValue == 0x02) &&
-		eventValue == 0x00)
-		return RegisterEvent::KeyRelease;
-
-	// Knob press events (0x25, 0x30, 0x31)
-	if ((readValue == 0x25 || readValue == 0x30 || readValue == 0x31) && eventValue == 0x01)
-		return RegisterEvent::KnobPress;
-	if ((readValue == 0x25 || readValue == 0x30 || readValue == 0x31) && eventValue == 0x00)
-		return RegisterEvent::KnobRelease;
-
-	// Knob rotate left events (0x50, 0x60, 0x90)
-	if ((readValue == 0x50 || readValue == 0x60 || readValue == 0x90) && eventValue == 0x00)
-		return RegisterEvent::KnobLeft;
-
-	// Knob rotate right events (0x51, 0x61, 0x91)
-	if ((readValue == 0x51 || readValue == 0x61 || readValue == 0x91) && eventValue == 0x00)
-		return RegisterEvent::KnobRight;
-
-	return RegisterEvent::EveryThing;
-}
 
 void K1Pro::setBackgroundImgFile(const std::string &filePath, uint32_t timeoutMs)
 {
@@ -10,7 +10,6 @@ class K1Pro : public StreamDock
 {
 public:
 	explicit K1Pro(const hid_device_info& device_info);
-	virtual RegisterEvent dispatchEvent(uint8_t readValue, uint8_t eventValue) override;
 	void setBackgroundImgFile(const std::string& filePath, uint32_t timeoutMs = 3000) override;
 
 	// Keyboard backlight functions
@@ -4,6 +4,14 @@
 static constexpr auto VID_STREAMDOCK_293V2 = 0x5500;
 static constexpr auto PID_STREAMDOCK_293V2 = 0x1001;
 
+static constexpr KeyDecode STREAMDOCK_293V2_KEYS[] = {
+	/// Normal keys, starting from the bottom-left corner, counted left to right and bottom to top, correspond to keys 1 to 15
+	{1, 0x0B},{2, 0x0C},{3, 0x0D},{4, 0x0E},{5, 0x0F},
+	{6, 0x06},{7, 0x07},{8, 0x08},{9, 0x09},{10, 0x0A},
+	{11, 0x01},{12, 0x02},{13, 0x03},{14, 0x04},{15, 0x05},
+};
+static constexpr EventDecodeTable STREAMDOCK_293V2_DECODE_TABLE(STREAMDOCK_293V2_KEYS);
+
 bool StreamDock293V2::registered_293V2 = []()
 	{
 		StreamDockFactory::instance().registerDevice(VID_STREAMDOCK_293V2, PID_STREAMDOCK_293V2,
@@ -35,19 +43,5 @@ StreamDock293V2::StreamDock293V2(const hid_device_info& device_info)
 	_info->bg_rotate_angle = 180.0f;
 	_info->backgroundEncodeType = ImgType::RAW;
 	_info->backgroundEncodeFormat = ImgFormat::BGR888;
-	_readValueMap = {
-		/// Normal keys, starting from the bottom-left corner, counted left to right and bottom to top, correspond to keys 1 to 15
-		{1, 0x0B},{2, 0x0C},{3, 0x0D},{4, 0x0E},{5, 0x0F},
-		{6, 0x06},{7, 0x07},{8, 0x08},{9, 0x09},{10, 0x0A},
-		{11, 0x01},{12, 0x02},{13, 0x03},{14, 0x04},{15, 0x05},
-	};
-}
-
-RegisterEvent StreamDock293V2::dispatchEvent(uint8_t readValue, uint8_t eventValue)
-{
-	if ((0x01 <= readValue && readValue <= 0x0F) && eventValue == 0x00)
-		return RegisterEvent::KeyRelease; ///  Normal key release event
-	else if ((0x01 <= readValue && readValue <= 0x0F) && eventValue == 0x01)
-		return RegisterEvent::KeyPress; /// Normal key press event
-	return RegisterEvent::EveryThing;
+	setDecodeTable(STREAMDOCK_293V2_DECODE_TABLE);
 }
@@ -4,6 +4,15 @@
 static constexpr auto VID_STREAMDOCK_293sV3 = 0x6603;
 static constexpr auto PID_STREAMDOCK_293sV3 = 0x1014;
 
+static constexpr KeyDecode STREAMDOCK_293sV3_KEYS[] = {
+	/// Normal keys, starting from the top-right corner, counted top to bottom and right to left, correspond to keys 1 to 15
+	/// The secondary screen of the 293sV3 has no press or release actions; it only supports display functionality
+	{1, 0x01}, {2, 0x02}, {3, 0x03}, {4, 0x04}, {5, 0x05},
+	{6, 0x06}, {7, 0x07}, {8, 0x08}, {9, 0x09}, {10, 0x0A},
+	{11, 0x0B},{12, 0x0C},{13, 0x0D},{14, 0x0E},{15, 0x0F},
+};
+static constexpr EventDecodeTable STREAMDOCK_293sV3_DECODE_TABLE(STREAMDOCK_293sV3_KEYS);
+
 bool StreamDock293sV3::registered_293sV3 = []()
 	{
 		StreamDockFactory::instance().registerDevice(VID_STREAMDOCK_293sV3, PID_STREAMDOCK_293sV3,
@@ -40,20 +49,5 @@ StreamDock293sV3::StreamDock293sV3(const hid_device_info& device_info)
 	_feature->max2rdScreenKey = 18;
 	_feature->_2rdScreenWidth = 80;
 	_feature->_2rdScreenHeights = 80;
-	_readValueMap = {
-		/// Normal keys, starting from the top-right corner, counted top to bottom and right to left, correspond to keys 1 to 15
-		/// The secondary screen of the 293sV3 has no press or release actions; it only supports display functionality
-		{1, 0x01}, {2, 0x02}, {3, 0x03}, {4, 0x04}, {5, 0x05},
-		{6, 0x06}, {7, 0x07}, {8, 0x08}, {9, 0x09}, {10, 0x0A},
-		{11, 0x0B},{12, 0x0C},{13, 0x0D},{14, 0x0E},{15, 0x0F},
-	};
-}
-
-RegisterEvent StreamDock293sV3::dispatchEvent(uint8_t readValue, uint8_t eventValue)
-{
-	if ((0x01 <= readValue && readValue <= 0x0F) && eventValue == 0x00)
-		return RegisterEvent::KeyRelease; /// Normal key release event
-	else if ((0x01 <= readValue && readValue <= 0x0F) && eventValue == 0x01)
-		return RegisterEvent::KeyPress; /// Normal key press event
-	return RegisterEvent::EveryThing;
+	setDecodeTable(STREAMDOCK_293sV3_DECODE_TABLE);
 }
@@ -8,7 +8,6 @@ class StreamDock293sV3 : public StreamDock
 {
 public:
 	explicit StreamDock293sV3(const hid_device_info& device_info);
-	virtual RegisterEvent dispatchEvent(uint8_t readValue, uint8_t eventValue) override;
 
 private:
 	static bool registered_293sV3;
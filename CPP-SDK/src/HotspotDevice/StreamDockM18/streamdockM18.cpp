@@ -7,6 +7,18 @@ static constexpr auto PID_STREAMDOCK_M18 = 0x1009;
 static constexpr auto VID_STREAMDOCK_M18E = 0x6603;
 static constexpr auto PID_STREAMDOCK_M18E = 0x1012;
 
+// clang-format off
+static constexpr KeyDecode STREAMDOCK_M18_KEYS[] = {
+	/// Normal keys, starting from the bottom-left corner, counted left to right and bottom to top, correspond to keys 1 to 15
+	{1, 0x0B}, {2, 0x0C}, {3, 0x0D}, {4, 0x0E}, {5, 0x0F},
+	{6, 0x06}, {7, 0x07}, {8, 0x08}, {9, 0x09}, {10,0x0A},
+	{11,0x01}, {12,0x02}, {13,0x03}, {14,0x04}, {15,0x05},
+	/// The following three buttons, from left to right, are 25, 30, and 31
+	{16,0x25}, {17,0x30}, {18,0x31}
+};
+// clang-format on
+static constexpr EventDecodeTable STREAMDOCK_M18_DECODE_TABLE(STREAMDOCK_M18_KEYS);
+
 bool StreamDockM18::registered_M18 = []()
 {
 	StreamDockFactory::instance().registerDevice(VID_STREAMDOCK_M18, PID_STREAMDOCK_M18,
@@ -53,16 +65,7 @@ StreamDockM18::StreamDockM18(const hid_device_info &device_info)
 	_feature->isDualDevice = true;
 	_feature->hasRGBLed = true;
 	_feature->ledCounts = 24;
-	// clang-format off
-	_readValueMap = {
-		/// Normal keys, starting from the bottom-left corner, counted left to right and bottom to top, correspond to keys 1 to 15
-		{1, 0x0B}, {2, 0x0C}, {3, 0x0D}, {4, 0x0E}, {5, 0x0F},
-		{6, 0x06}, {7, 0x07}, {8, 0x08}, {9, 0x09}, {10,0x0A},
-		{11,0x01}, {12,0x02}, {13,0x03}, {14,0x04}, {15,0x05},
-		/// The following three buttons, from left to right, are 25, 30, and 31
-		{16,0x25}, {17,0x30}, {18,0x31}
-	};
-	// clang-format on
+	setDecodeTable(STREAMDOCK_M18_DECODE_TABLE);
 	changeFirmwareVersionMode();
 }
 
@@ -72,18 +75,6 @@ void StreamDockM18::changeV2Mode()
 	_feature->supportBackGroundGif = false;
 }
 
-RegisterEvent StreamDockM18::dispatchEvent(uint8_t readValue, uint8_t eventValue)
-{
-	if ((0x01 <= readValue && readValue <= 0x0F) && eventValue == 0x00)
-		return RegisterEvent::KeyRelease; /// Normal key release event
-	else if ((0x01 <= readValue && readValue <= 0x0F) && eventValue == 0x01)
-		return RegisterEvent::KeyPress; /// Normal key press event
-	if ((0x25 <= readValue && readValue <= 0x31) && eventValue == 0x00)
-		return RegisterEvent::KeyRelease; /// Bottom button release event
-	else if ((0x25 <= readValue && readValue <= 0x31) && eventValue == 0x01)
-		return RegisterEvent::KeyPress; /// Bottom button press event
-	return RegisterEvent::EveryThing;
-}
 
 void StreamDockM18::changeFirmwareVersionMode()
 {
@@ -122,4 +113,4 @@ void StreamDockM18::changeFirmwareVersionMode()
 		changeV3Mode();
 		std::wcout << "StreamDockM18V3: " << _info->serialNumber << std::endl;
 	}
-}
\ No newline at end of file
+}
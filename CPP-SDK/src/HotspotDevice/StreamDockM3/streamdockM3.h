@@ -7,7 +7,6 @@ class StreamDockM3 : public StreamDock
 {
 public:
 	explicit StreamDockM3(const hid_device_info& device_info);
-	virtual RegisterEvent dispatchEvent(uint8_t readValue, uint8_t eventValue) override;
 
     void magneticCalibration();
 
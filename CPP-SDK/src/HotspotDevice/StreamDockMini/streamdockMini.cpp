@@ -7,6 +7,22 @@ static constexpr auto PID_STREAMDOCK_MINI = 0x1036;
 static constexpr auto VID_STREAMDOCK_MINIW = 0x5548;
 static constexpr auto PID_STREAMDOCK_MINIW = 0x1037;
 
+// clang-format off
+static constexpr KeyDecode STREAMDOCK_MINI_KEYS[] = {
+	/// Normal keys, starting from the top-left corner, counted left to right and top to bottom, correspond to keys 1 to 6
+	{1, 0x01}, {2, 0x02}, {3, 0x03}, {4, 0x04}, {5, 0x05}, {6, 0x06},
+	/// Mini DIP switch 1: 7 left, 8 right, 9 press
+	{7, 0x24, RegisterEvent::DIPLeftEnd, RegisterEvent::DIPLeft},
+	{8, 0x26, RegisterEvent::DIPRightEnd, RegisterEvent::DIPRight},
+	{9, 0x25, RegisterEvent::DIPRelease, RegisterEvent::DIPPress},
+	/// Mini DIP switch 2: 10 left, 11 right, 12 press
+	{10, 0x21, RegisterEvent::DIPLeftEnd, RegisterEvent::DIPLeft},
+	{11, 0x23, RegisterEvent::DIPRightEnd, RegisterEvent::DIPRight},
+	{12, 0x22, RegisterEvent::DIPRelease, RegisterEvent::DIPPress},
+};
+// clang-format on
+static constexpr EventDecodeTable STREAMDOCK_MINI_DECODE_TABLE(STREAMDOCK_MINI_KEYS);
+
 bool StreamDockMini::registered_Mini = []()
 {
 	StreamDockFactory::instance().registerDevice(VID_STREAMDOCK_MINI, PID_STREAMDOCK_MINI,
@@ -57,35 +73,5 @@ StreamDockMini::StreamDockMini(const hid_device_info& device_info)
 	_feature->hasRGBLed = true;
 	_feature->supportConfig = false;
 	_feature->ledCounts = 12;
-	// clang-format off
-	_readValueMap = {
-		/// Normal keys, starting from the top-left corner, counted left to right and top to bottom, correspond to keys 1 to 6
-		{1, 0x01}, {2, 0x02}, {3, 0x03}, {4, 0x04}, {5, 0x05}, {6, 0x06},
-		/// Mini DIP switch 1: 7 left, 8 right, 9 press
-		{7, 0x24}, {8, 0x26}, {9, 0x25},
-		/// Mini DIP switch 2: 10 left, 11 right, 12 press
-		{10, 0x21}, {11, 0x23}, {12, 0x22},
-	};
-	// clang-format on
-}
-
-RegisterEvent StreamDockMini::dispatchEvent(uint8_t readValue, uint8_t eventValue)
-{
-	if ((0x01 <= readValue && readValue <= 0x06) && eventValue == 0x00)
-		return RegisterEvent::KeyRelease;
-	if ((0x01 <= readValue && readValue <= 0x06) && eventValue == 0x01)
-		return RegisterEvent::KeyPress;
-	if ((readValue == 0x24 || readValue == 0x21) && eventValue == 0x01)
-		return RegisterEvent::DIPLeft;
-	if ((readValue == 0x24 || readValue == 0x21) && eventValue == 0x00)
-		return RegisterEvent::DIPLeftEnd;
-	if ((readValue == 0x26 || readValue == 0x23) && eventValue == 0x01)
-		return RegisterEvent::DIPRight;
-	if ((readValue == 0x26 || readValue == 0x23) && eventValue == 0x00)
-		return RegisterEvent::DIPRightEnd;
-	if ((readValue == 0x25 || readValue == 0x22) && eventValue == 0x01)
-		return RegisterEvent::DIPPress;
-	if ((readValue == 0x25 || readValue == 0x22) && eventValue == 0x00)
-		return RegisterEvent::DIPRelease;
-	return RegisterEvent::EveryThing;
+	setDecodeTable(STREAMDOCK_MINI_DECODE_TABLE);
 }
@@ -6,7 +6,6 @@ class StreamDockMini : public StreamDock
 {
 public:
 	explicit StreamDockMini(const hid_device_info& device_info);
-	virtual RegisterEvent dispatchEvent(uint8_t readValue, uint8_t eventValue) override;
 
 private:
 	static bool registered_Mini;
@@ -8,6 +8,23 @@ static constexpr auto PID_STREAMDOCK_N1 = 0x1011;
 static constexpr auto VID_STREAMDOCK_N1E = 0x6603;
 static constexpr auto PID_STREAMDOCK_N1E = 0x1000;
 
+// clang-format off
+static constexpr KeyDecode STREAMDOCK_N1_KEYS[] = {
+	/// Normal keys, starting from the top-left corner, counted left to right and top to bottom, correspond to keys 1 to 15
+	{1, 0x01}, {2, 0x02}, {3, 0x03}, {4, 0x04}, {5, 0x05},
+	{6, 0x06},{7, 0x07},{8, 0x08},{9, 0x09},{10, 0x0A},
+	{11, 0x0B},{12, 0x0C},{13, 0x0D},{14, 0x0E},{15, 0x0F},
+	/// The two top buttons
+	{16, 0x1E},{17, 0x1F},
+	/// Knob press
+	{18, 0x23, RegisterEvent::KnobRelease, RegisterEvent::KnobPress},
+	/// Knob rotate left and right
+	{19, 0x32, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	{20, 0x33, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+};
+// clang-format on
+static constexpr EventDecodeTable STREAMDOCK_N1_DECODE_TABLE(STREAMDOCK_N1_KEYS);
+
 bool StreamDockN1::registered_N1 = []()
 {
 	StreamDockFactory::instance().registerDevice(VID_STREAMDOCK_N1, PID_STREAMDOCK_N1,
@@ -57,42 +74,9 @@ StreamDockN1::StreamDockN1(const hid_device_info &device_info)
 	_feature->max2rdScreenKey = 18;
 	_feature->_2rdScreenWidth = 64;
 	_feature->_2rdScreenHeights = 64;
-	// clang-format off
-	_readValueMap = {
-		/// Normal keys, starting from the top-left corner, counted left to right and top to bottom, correspond to keys 1 to 15
-		{1, 0x01}, {2, 0x02}, {3, 0x03}, {4, 0x04}, {5, 0x05},
-		{6, 0x06},{7, 0x07},{8, 0x08},{9, 0x09},{10, 0x0A},
-		{11, 0x0B},{12, 0x0C},{13, 0x0D},{14, 0x0E},{15, 0x0F},
-		/// The two top buttons
-		{16, 0x1E},{17, 0x1F},
-		/// Knob press
-		{18, 0x23},
-		/// Knob rotate left and right
-		{19, 0x32},{20, 0x33}
-	};
-	// clang-format on
+	setDecodeTable(STREAMDOCK_N1_DECODE_TABLE);
 }
 
-RegisterEvent StreamDockN1::dispatchEvent(uint8_t readValue, uint8_t eventValue)
-{
-	if ((0x01 <= readValue && readValue <= 0x0F) && eventValue == 0x00)
-		return RegisterEvent::KeyRelease; /// Normal key release event
-	else if ((0x01 <= readValue && readValue <= 0x0F) && eventValue == 0x01)
-		return RegisterEvent::KeyPress; /// Normal key press event
-	if ((0x1E == readValue || readValue == 0x1F) && eventValue == 0x00)
-		return RegisterEvent::KeyRelease; /// Top button release event
-	else if ((0x1E == readValue || readValue == 0x1F) && eventValue == 0x01)
-		return RegisterEvent::KeyPress; /// Top button press event
-	if (0x23 == readValue && eventValue == 0x00)
-		return RegisterEvent::KnobRelease; /// Knob release event
-	else if (0x23 == readValue && eventValue == 0x01)
-		return RegisterEvent::KnobPress; /// Knob press event
-	if (0x32 == readValue && eventValue == 0x00)
-		return RegisterEvent::KnobLeft; /// Knob rotate left event
-	else if (0x33 == readValue && eventValue == 0x00)
-		return RegisterEvent::KnobRight; /// Knob rotate right event
-	return RegisterEvent::EveryThing;
-}
 
 void StreamDockN1::changeMode(N1MODE mode)
 {
@@ -208,8 +192,9 @@ void StreamDockN1::setBackgroundImgFile(const std::string &filePath, uint32_t ti
 	if (extract_last_number(info()->firmwareVersion) >= 13)
 		StreamDock::setBackgroundImgFile(filePath, timeoutMs);
 }
-void StreamDockN1::setBackgroundImgStream(const std::string &stream, uint32_t timeoutMs)
+bool StreamDockN1::setBackgroundImgStream(const std::string &stream, uint32_t timeoutMs)
 {
 	if (extract_last_number(info()->firmwareVersion) >= 13)
-		StreamDock::setBackgroundImgStream(stream, timeoutMs);
-}
\ No newline at end of file
+		return StreamDock::setBackgroundImgStream(stream, timeoutMs);
+	return false;
+}
@@ -7,6 +7,26 @@ static constexpr auto PID_STREAMDOCK_N3V2 = 0x1000;
 static constexpr auto VID_STREAMDOCK_N3V2E = 0x6602;
 static constexpr auto PID_STREAMDOCK_N3V2E = 0x1002;
 
+static constexpr KeyDecode STREAMDOCK_N3V2_KEYS[] = {
+	/// Normal keys, starting from the top-left corner, counted left to right and top to bottom, correspond to keys 1 to 6
+	{1, 0x01}, {2, 0x02}, {3, 0x03}, {4, 0x04},{5, 0x05},{6, 0x06},
+	/// Three black buttons at the bottom, from left to right: 25, 30, 31
+	{7, 0x25},{8, 0x30},{9, 0x31},
+	/// Three knob press buttons on the left side: bottom-left is 33, bottom-right is 34, top is 35
+	{10, 0x33, RegisterEvent::KnobPress, RegisterEvent::EveryThing},
+	{11, 0x34, RegisterEvent::KnobPress, RegisterEvent::EveryThing},
+	{12, 0x35, RegisterEvent::KnobPress, RegisterEvent::EveryThing},
+	/// Three knob left rotations on the left side: bottom-left is 90, bottom-right is 60, top is 50
+	{13, 0x90, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	{14, 0x60, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	{15, 0x50, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	/// Three knob right rotations on the left side: bottom-left is 91, bottom-right is 61, top is 51
+	{16, 0x91, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+	{17, 0x61, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+	{18, 0x51, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+};
+static constexpr EventDecodeTable STREAMDOCK_N3V2_DECODE_TABLE(STREAMDOCK_N3V2_KEYS);
+
 bool StreamDockN3::registered_N3V2 = []()
 	{
 		StreamDockFactory::instance().registerDevice(VID_STREAMDOCK_N3V2, PID_STREAMDOCK_N3V2,
@@ -52,35 +72,5 @@ StreamDockN3::StreamDockN3(const hid_device_info& device_info)
 	_info->maxKey = 6;
 	_info->key_rotate_angle = 0.0f;
 	_info->bg_rotate_angle = 90.0f;
-	_readValueMap = {
-		/// Normal keys, starting from the top-left corner, counted left to right and top to bottom, correspond to keys 1 to 6
-		{1, 0x01}, {2, 0x02}, {3, 0x03}, {4, 0x04},{5, 0x05},{6, 0x06},
-		/// Three black buttons at the bottom, from left to right: 25, 30, 31
-		{7, 0x25},{8, 0x30},{9, 0x31},
-		/// Three knob press buttons on the left side: bottom-left is 33, bottom-right is 34, top is 35
-		{10, 0x33},{11, 0x34},{12, 0x35},
-		/// Three knob left rotations on the left side: bottom-left is 90, bottom-right is 60, top is 50
-		{13, 0x90},{14, 0x60},{15, 0x50},
-		/// Three knob right rotations on the left side: bottom-left is 91, bottom-right is 61, top is 51
-		{16, 0x91},{17, 0x61},{18, 0x51},
-	};
-}
-
-RegisterEvent StreamDockN3::dispatchEvent(uint8_t readValue, uint8_t eventValue)
-{
-	if ((0x01 <= readValue && readValue <= 0x06) && eventValue == 0x00)
-		return RegisterEvent::KeyRelease; /// Normal key release event
-	if ((0x01 <= readValue && readValue <= 0x06) && eventValue == 0x01)
-		return RegisterEvent::KeyPress; /// Normal key press event
-	if ((0x25 <= readValue && readValue <= 0x31) && eventValue == 0x00)
-		return RegisterEvent::KeyRelease; /// Bottom button release event
-	if ((0x25 <= readValue && readValue <= 0x31) && eventValue == 0x01)
-		return RegisterEvent::KeyPress; /// Bottom button press event
-	if ((0x33 <= readValue && readValue <= 0x35) && eventValue == 0x00)
-		return RegisterEvent::KnobPress; /// Knob press event
-	if ((0x90 == readValue || readValue == 0x60 || readValue == 0x50) && eventValue == 0x00)
-		return RegisterEvent::KnobLeft; /// Knob rotate left event
-	if ((0x91 == readValue || readValue == 0x61 || readValue == 0x51) && eventValue == 0x00)
-		return RegisterEvent::KnobRight; /// Knob rotate right event
-	return RegisterEvent::EveryThing;
+	setDecodeTable(STREAMDOCK_N3V2_DECODE_TABLE);
 }
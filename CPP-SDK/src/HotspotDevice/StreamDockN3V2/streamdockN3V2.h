@@ -6,7 +6,6 @@ class StreamDockN3 : public StreamDock
 {
 public:
 	explicit StreamDockN3(const hid_device_info& device_info);
-	virtual RegisterEvent dispatchEvent(uint8_t readValue, uint8_t eventValue) override;
 
 private:
 	static bool registered_N3V2;
@@ -8,7 +8,6 @@ class StreamDockN3V25 : public StreamDock
 {
 public:
 	explicit StreamDockN3V25(const hid_device_info &device_info);
-	virtual RegisterEvent dispatchEvent(uint8_t readValue, uint8_t eventValue) override;
 	void changeFirmwareVersionMode();
 private:
 	static bool registered_N3V25;
@@ -7,6 +7,34 @@ static constexpr auto PID_STREAMDOCK_N4 = 0x1001;
 static constexpr auto VID_STREAMDOCK_N4E = 0x6603;
 static constexpr auto PID_STREAMDOCK_N4E = 0x1007;
 
+static constexpr KeyDecode STREAMDOCK_N4_KEYS[] = {
+	/// Secondary screen buttons, from left to right: 40, 41, 42, 43 (only press events are available for the secondary screen)
+	{1, 0x40, RegisterEvent::KeyRelease, RegisterEvent::EveryThing},
+	{2, 0x41, RegisterEvent::KeyRelease, RegisterEvent::EveryThing},
+	{3, 0x42, RegisterEvent::KeyRelease, RegisterEvent::EveryThing},
+	{4, 0x43, RegisterEvent::KeyRelease, RegisterEvent::EveryThing},
+	/// Normal keys, starting from the bottom-left corner, counted left to right and bottom to top, correspond to keys 6 to 15
+	{6, 0x06},{7, 0x07},{8, 0x08},{9, 0x09}, {10, 0x0A}, {11, 0x01},{12, 0x02},{13, 0x03},{14, 0x04},{15, 0x05},
+	/// N4 knob group: 16, 18, 20, 22 represent left rotation; 17, 19, 21, 23 represent right rotation
+	{16, 0xA0, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	{17, 0xA1, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+	{18, 0x50, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	{19, 0x51, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+	{20, 0x90, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	{21, 0x91, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+	{22, 0x70, RegisterEvent::KnobLeft, RegisterEvent::EveryThing},
+	{23, 0x71, RegisterEvent::KnobRight, RegisterEvent::EveryThing},
+	/// N4 knob group press events: 24 to 27 correspond to knobs 1, 2, 3, and 4 respectively
+	{24, 0x37, RegisterEvent::KnobPress, RegisterEvent::EveryThing},
+	{25, 0x35, RegisterEvent::KnobPress, RegisterEvent::EveryThing},
+	{26, 0x33, RegisterEvent::KnobPress, RegisterEvent::EveryThing},
+	{27, 0x36, RegisterEvent::KnobPress, RegisterEvent::EveryThing},
+	/// N4 secondary screen swipe
+	{28, 0x38, RegisterEvent::SwipeLeft, RegisterEvent::EveryThing},
+	{29, 0x39, RegisterEvent::SwipeRight, RegisterEvent::EveryThing},
+};
+static constexpr EventDecodeTable STREAMDOCK_N4_DECODE_TABLE(STREAMDOCK_N4_KEYS);
+
 bool StreamDockN4::registered_N4 = []()
 	{
 		StreamDockFactory::instance().registerDevice(VID_STREAMDOCK_N4, PID_STREAMDOCK_N4,
@@ -56,37 +84,5 @@ StreamDockN4::StreamDockN4(const hid_device_info& device_info)
 	_feature->max2rdScreenKey = 4;
 	_feature->_2rdScreenWidth = 176;
 	_feature->_2rdScreenHeights = 112;
-	_readValueMap = {
-		/// Secondary screen buttons, from left to right: 40, 41, 42, 43 (only press events are available for the secondary screen)
-		{1, 0x40}, {2, 0x41}, {3, 0x42}, {4, 0x43}, 
-		/// Normal keys, starting from the bottom-left corner, counted left to right and bottom to top, correspond to keys 6 to 15
-		{6, 0x06},{7, 0x07},{8, 0x08},{9, 0x09}, {10, 0x0A}, {11, 0x01},{12, 0x02},{13, 0x03},{14, 0x04},{15, 0x05},
-		/// N4 knob group: 16, 18, 20, 22 represent left rotation; 17, 19, 21, 23 represent right rotation
-		{16, 0xA0},{17, 0xA1},{18, 0x50},{19, 0x51},{20, 0x90},{21, 0x91},{22, 0x70},{23, 0x71},
-		/// N4 knob group press events: 24 to 27 correspond to knobs 1, 2, 3, and 4 respectively
-		{24, 0x37},{25, 0x35},{26, 0x33},{27, 0x36},
-		/// N4 secondary screen swipe
-		{28, 0x38}, {29, 0x39}
-	};
-}
-
-RegisterEvent StreamDockN4::dispatchEvent(uint8_t readValue, uint8_t eventValue)
-{
-	if ((0x01 <= readValue && readValue <= 0x0A) && eventValue == 0x00)
-		return RegisterEvent::KeyRelease; /// Normal key release event
-	else if ((0x01 <= readValue && readValue <= 0x0A) && eventValue == 0x01)
-		return RegisterEvent::KeyPress; /// Normal key press event
-	if ((0x40 <= readValue && readValue <= 0x43) && eventValue == 0x00)
-		return RegisterEvent::KeyRelease; /// Secondary screen button release event
-	if ((0xA0 == readValue || 0x50 == readValue || 0x90 == readValue || 0x70 == readValue) && eventValue == 0x00)
-		return RegisterEvent::KnobLeft; /// Knob group rotate left event
-	if ((0xA1 == readValue || 0x51 == readValue || 0x91 == readValue || 0x71 == readValue) && eventValue == 0x00)
-		return RegisterEvent::KnobRight; /// Knob group rotate right event
-	if ((0x37 == readValue || 0x35 == readValue || 0x33 == readValue || 0x36 == readValue) && eventValue == 0x00)
-		return RegisterEvent::KnobPress; /// Knob group press event
-	if ((0x38 == readValue) && eventValue == 0x00)
-		return RegisterEvent::SwipeLeft; /// Secondary screen swipe left event
-	if ((0x39 == readValue) && eventValue == 0x00)
-		return RegisterEvent::SwipeRight; /// Secondary screen swipe right event
-	return RegisterEvent::EveryThing;
+	setDecodeTable(STREAMDOCK_N4_DECODE_TABLE);
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "DeviceInfo/streamdock.h"
 #include "DeviceInfo/streamdockfactory.h"
+#include "DeviceInfo/Feature/ReadController/touchtracker.h"
 
 enum class N4ProBackgroundGifPostion : uint8_t {
 	KeyScreen = 0x01,
@@ -13,8 +14,15 @@ class StreamDockN4Pro : public StreamDock
 public:
 public:
 	explicit StreamDockN4Pro(const hid_device_info& device_info);
-	virtual RegisterEvent dispatchEvent(uint8_t readValue, uint8_t eventValue) override;
-	void registerTouchBarCallback(std::function<void(const std::vector<uint8_t>)> callback, bool asyncRun);
+	/**
+	 * @brief Receive decoded touch-bar events; shorthand for reader()->registerTouchCallback().
+	 * @param callback Function receiving each touch event; nullptr to unregister.
+	 * @param asyncRun Whether to invoke the callback asynchronously (Moved events are then coalesced).
+	 */
+	void registerTouchBarCallback(std::function<void(const TouchEvent&)> callback, bool asyncRun);
+
+protected:
+	bool decodeTouch(const uint8_t* report, size_t size, uint16_t& x, uint16_t& y) const override;
 
 private:
 	static bool registered_N4Pro;
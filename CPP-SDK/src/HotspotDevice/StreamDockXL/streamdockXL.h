@@ -6,7 +6,6 @@ class StreamDockXL : public StreamDock
 {
 public:
     explicit StreamDockXL(const hid_device_info &device_info);
-    virtual RegisterEvent dispatchEvent(uint8_t readValue, uint8_t eventValue) override;
 
 private:
     static bool registered_XL;
@@ -0,0 +1,258 @@
+#include "callbackexecutor.h"
+#include <algorithm>
+#include <exception>
+#include <toolkit.h>
+
+std::mutex CallbackExecutor::_sharedMutex;
+std::shared_ptr<CallbackExecutor> CallbackExecutor::_shared;
+
+CallbackExecutor::CallbackExecutor(size_t workers, size_t capacity, OverflowPolicy policy)
+	: _capacity(std::max<size_t>(capacity, 1)), _policy(policy)
+{
+	workers = std::max<size_t>(workers, 1);
+	_workers.reserve(workers);
+	for (size_t i = 0; i < workers; ++i)
+		_workers.emplace_back(&CallbackExecutor::workerLoop, this);
+}
+
+CallbackExecutor::~CallbackExecutor()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_workCv.notify_all();
+	_spaceCv.notify_all();
+	for (auto &worker : _workers)
+	{
+		if (worker.joinable())
+			worker.join();
+	}
+}
+
+bool CallbackExecutor::post(uint64_t key, Task task, uint64_t coalesceTag)
+{
+	if (!task)
+		return false;
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (_hook)
+	{
+		PostHook hook = _hook;
+		++_stats.posted;
+		++_stats.executed;
+		lock.unlock();
+		hook(std::move(task));
+		return true;
+	}
+	if (_stop)
+		return false;
+	if (_pending >= _capacity && !makeRoom(lock, key, task, coalesceTag))
+		return !_stop; // Coalesced into a pending task, or stopped while waiting
+
+	Strand &strand = _strands[key];
+	strand.tasks.push_back({std::move(task), coalesceTag});
+	++_pending;
+	++_stats.posted;
+	if (strand.queued)
+		return true; // The worker running this key picks it up next
+	strand.queued = true;
+	_ready.push_back(key);
+	lock.unlock();
+	_workCv.notify_one();
+	return true;
+}
+
+bool CallbackExecutor::makeRoom(std::unique_lock<std::mutex> &lock, uint64_t key, Task &task, uint64_t tag)
+{
+	OverflowPolicy policy = _policy;
+	if (policy == OverflowPolicy::Block && onWorkerThread())
+		policy = OverflowPolicy::DropOldest; // Waiting here could wait on ourselves
+	switch (policy)
+	{
+	case OverflowPolicy::Unbounded:
+		return true;
+	case OverflowPolicy::Block:
+		++_stats.blocked;
+		_spaceCv.wait(lock, [this]
+					  { return _stop || _pending < _capacity; });
+		return !_stop;
+	case OverflowPolicy::Coalesce:
+		if (tag != 0)
+		{
+			auto it = _strands.find(key);
+			if (it != _strands.end())
+			{
+				for (auto pending = it->second.tasks.rbegin(); pending != it->second.tasks.rend(); ++pending)
+				{
+					if (pending->tag == tag)
+					{
+						pending->task = std::move(task);
+						++_stats.posted;
+						++_stats.coalesced;
+						return false;
+					}
+				}
+			}
+		}
+		dropOldest(key);
+		return true;
+	case OverflowPolicy::DropOldest:
+	default:
+		dropOldest(key);
+		return true;
+	}
+}
+
+void CallbackExecutor::dropOldest(uint64_t key)
+{
+	auto it = _strands.find(key);
+	if (it == _strands.end() || it->second.tasks.empty())
+	{
+		// Nothing pending for this key: take from the key that has been runnable longest
+		it = _strands.end();
+		for (uint64_t readyKey : _ready)
+		{
+			auto candidate = _strands.find(readyKey);
+			if (candidate != _strands.end() && !candidate->second.tasks.empty())
+			{
+				it = candidate;
+				break;
+			}
+		}
+		if (it == _strands.end())
+		{
+			it = std::find_if(_strands.begin(), _strands.end(), [](const auto &entry)
+							  { return !entry.second.tasks.empty(); });
+			if (it == _strands.end())
+				return;
+		}
+	}
+	it->second.tasks.pop_front();
+	--_pending;
+	++_stats.dropped;
+}
+
+void CallbackExecutor::workerLoop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true)
+	{
+		_workCv.wait(lock, [this]
+					 { return _stop || !_ready.empty(); });
+		if (_ready.empty())
+			return; // Stopped and drained
+
+		uint64_t key = _ready.front();
+		_ready.pop_front();
+		auto it = _strands.find(key);
+		if (it == _strands.end())
+			continue;
+		if (it->second.tasks.empty())
+		{ // Everything pending for this key was dropped
+			_strands.erase(it);
+			continue;
+		}
+		Task task = std::move(it->second.tasks.front().task);
+		it->second.tasks.pop_front();
+		--_pending;
+		lock.unlock();
+		_spaceCv.notify_one();
+
+		try
+		{
+			task();
+		}
+		catch (const std::exception &e)
+		{
+			ToolKit::print("[ERROR] Async callback threw:", e.what());
+		}
+		catch (...)
+		{
+			ToolKit::print("[ERROR] Async callback threw an unknown exception");
+		}
+		task = nullptr; // Release captures outside the lock
+
+		lock.lock();
+		++_stats.executed;
+		it = _strands.find(key); // Still present: a queued strand is never erased by others
+		if (it->second.tasks.empty())
+			_strands.erase(it);
+		else
+		{
+			_ready.push_back(key); // Back of the line, so one busy key cannot starve the rest
+			_workCv.notify_one();
+		}
+	}
+}
+
+bool CallbackExecutor::onWorkerThread() const
+{
+	const auto self = std::this_thread::get_id();
+	return std::any_of(_workers.begin(), _workers.end(), [self](const std::thread &worker)
+					   { return worker.get_id() == self; });
+}
+
+void CallbackExecutor::setPostHook(PostHook hook)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_hook = std::move(hook);
+	}
+	_spaceCv.notify_all();
+}
+
+void CallbackExecutor::setOverflowPolicy(OverflowPolicy policy)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_policy = policy;
+	}
+	_spaceCv.notify_all();
+}
+
+size_t CallbackExecutor::workerCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _workers.size();
+}
+
+void CallbackExecutor::ensureWorkers(size_t workers)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_stop)
+		return;
+	while (_workers.size() < workers)
+		_workers.emplace_back(&CallbackExecutor::workerLoop, this);
+}
+
+OverflowPolicy CallbackExecutor::overflowPolicy() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _policy;
+}
+
+CallbackExecutorStats CallbackExecutor::stats() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _stats;
+}
+
+std::shared_ptr<CallbackExecutor> CallbackExecutor::shared()
+{
+	std::lock_guard<std::mutex> lock(_sharedMutex);
+	if (!_shared)
+		_shared = std::make_shared<CallbackExecutor>();
+	return _shared;
+}
+
+void CallbackExecutor::setShared(std::shared_ptr<CallbackExecutor> executor)
+{
+	std::lock_guard<std::mutex> lock(_sharedMutex);
+	_shared = std::move(executor);
+}
+
+std::shared_ptr<CallbackExecutor> CallbackExecutor::internal()
+{
+	static std::shared_ptr<CallbackExecutor> executor = std::make_shared<CallbackExecutor>(INTERNAL_WORKERS, DEFAULT_CAPACITY, OverflowPolicy::Unbounded);
+	return executor;
+}
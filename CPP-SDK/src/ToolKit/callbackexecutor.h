@@ -0,0 +1,133 @@
+/**
+ * @file callbackexecutor.h
+ * @brief Bounded worker pool for asynchronous device callbacks, with per-key FIFO ordering.
+ *
+ * Tasks are posted with an ordering key (ReadController uses one key per device and logical key).
+ * Tasks sharing a key run one at a time in posting order; different keys run in parallel on a fixed
+ * number of workers. The number of pending tasks is capped; when the cap is reached the overflow
+ * policy decides between waiting, dropping the oldest pending task of that key, or replacing a
+ * pending task with the same coalesce tag.
+ *
+ * A post hook can route every task into the application's own event loop instead of the workers.
+ *
+ * shared() runs the application's callbacks and is theirs to configure. The SDK's own device work
+ * (heartbeats, GIF frames, bring-up, broadcast uploads) runs on internal(), which is Unbounded and has no
+ * post hook, so a full callback queue or an application event loop never holds it up.
+ *
+ * Example usage:
+ *   auto executor = std::make_shared<CallbackExecutor>(4, 1024, OverflowPolicy::Coalesce);
+ *   device->reader()->setCallbackExecutor(executor);
+ *   CallbackExecutor::shared()->setPostHook([&loop](CallbackExecutor::Task task) { loop.post(std::move(task)); });
+ */
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class OverflowPolicy : uint8_t
+{
+	Block,		///< post() waits until a task finishes (never from a worker thread: degrades to DropOldest there)
+	DropOldest, ///< Drop the oldest pending task of the same key, or the oldest pending task overall
+	Coalesce,	///< Replace the newest pending task of the same key and tag; otherwise DropOldest
+	Unbounded,	///< Never wait and never drop: the queue grows past the capacity
+};
+
+struct CallbackExecutorStats
+{
+	uint64_t posted = 0;	///< Tasks accepted by post()
+	uint64_t executed = 0;	///< Tasks run by workers or handed to the post hook
+	uint64_t dropped = 0;	///< Tasks discarded by DropOldest
+	uint64_t coalesced = 0; ///< Tasks replaced by a newer task with the same tag
+	uint64_t blocked = 0;	///< post() calls that had to wait for space
+};
+
+class CallbackExecutor
+{
+public:
+	using Task = std::function<void()>;
+	using PostHook = std::function<void(Task)>;
+
+	static constexpr size_t DEFAULT_WORKERS = 2;
+	static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+	explicit CallbackExecutor(size_t workers = DEFAULT_WORKERS, size_t capacity = DEFAULT_CAPACITY, OverflowPolicy policy = OverflowPolicy::Block);
+	/// Runs the tasks still pending, then joins the workers. Tasks must not hold the last reference to their executor.
+	~CallbackExecutor();
+
+	CallbackExecutor(const CallbackExecutor&) = delete;
+	CallbackExecutor& operator=(const CallbackExecutor&) = delete;
+
+	/**
+	 * @brief Queue a task behind earlier tasks with the same key.
+	 * @param key Ordering key.
+	 * @param task Task to run.
+	 * @param coalesceTag Non-zero tag; under OverflowPolicy::Coalesce a pending task with the same key and tag is replaced.
+	 * @return False if the task will not run: the executor is stopping. A task accepted here can still be
+	 * dropped later to make room for another one unless the policy is Unbounded.
+	 */
+	bool post(uint64_t key, Task task, uint64_t coalesceTag = 0);
+
+	/**
+	 * @brief Hand every task to `hook` instead of the workers (e.g. to post into the application's event loop).
+	 * The hook is called on the posting thread in posting order. Pass nullptr to go back to the workers.
+	 */
+	void setPostHook(PostHook hook);
+
+	void setOverflowPolicy(OverflowPolicy policy);
+	OverflowPolicy overflowPolicy() const;
+	size_t workerCount() const;
+	/// Start more workers until there are at least `workers`; never stops any.
+	void ensureWorkers(size_t workers);
+	size_t capacity() const { return _capacity; }
+
+	CallbackExecutorStats stats() const;
+
+	/// Process-wide executor used by every ReadController unless one is set explicitly.
+	static std::shared_ptr<CallbackExecutor> shared();
+	/// Replace the process-wide executor (e.g. with a different worker count). Controllers created earlier keep theirs.
+	static void setShared(std::shared_ptr<CallbackExecutor> executor);
+	/// Process-wide executor for the SDK's own device work: Unbounded, never hooked, not replaceable.
+	static std::shared_ptr<CallbackExecutor> internal();
+	static constexpr size_t INTERNAL_WORKERS = 4;
+
+private:
+	struct Pending
+	{
+		Task task;
+		uint64_t tag = 0;
+	};
+
+	struct Strand
+	{
+		std::deque<Pending> tasks;
+		bool queued = false;	///< Key is in _ready or being run by a worker
+	};
+
+	void workerLoop();
+	bool onWorkerThread() const;
+	/// Make room for one task under `lock`. Returns false when the task was coalesced into a pending one or the executor stopped.
+	bool makeRoom(std::unique_lock<std::mutex>& lock, uint64_t key, Task& task, uint64_t tag);
+	void dropOldest(uint64_t key);
+
+	mutable std::mutex _mutex;
+	std::condition_variable _workCv;
+	std::condition_variable _spaceCv;
+	std::unordered_map<uint64_t, Strand> _strands;
+	std::deque<uint64_t> _ready; ///< Keys with pending tasks, in the order they became runnable
+	size_t _pending = 0;
+	size_t _capacity;
+	OverflowPolicy _policy;
+	PostHook _hook;
+	bool _stop = false;
+	std::vector<std::thread> _workers;
+	CallbackExecutorStats _stats;
+
+	static std::mutex _sharedMutex;
+	static std::shared_ptr<CallbackExecutor> _shared;
+};
@@ -0,0 +1,240 @@
+#include "inputreactor.h"
+#include <algorithm>
+#include <exception>
+#include <toolkit.h>
+#if __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+std::mutex InputReactor::_sharedMutex;
+std::shared_ptr<InputReactor> InputReactor::_shared;
+
+InputReactor::InputReactor(size_t workers)
+{
+#if __linux__
+	_epollFd = epoll_create1(EPOLL_CLOEXEC);
+	_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (_epollFd >= 0 && _wakeFd >= 0)
+	{
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.u64 = INVALID_SOURCE;
+		if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, _wakeFd, &event) == 0)
+		{
+			_pollThread = std::thread(&InputReactor::pollLoop, this);
+			workers = std::max<size_t>(workers, 1);
+			_workers.reserve(workers);
+			for (size_t i = 0; i < workers; ++i)
+				_workers.emplace_back(&InputReactor::workerLoop, this);
+			return;
+		}
+	}
+	ToolKit::print("[ERROR] InputReactor: epoll setup failed, devices keep their own read threads.");
+	if (_epollFd >= 0)
+		::close(_epollFd);
+	if (_wakeFd >= 0)
+		::close(_wakeFd);
+	_epollFd = -1;
+	_wakeFd = -1;
+#endif
+}
+
+InputReactor::~InputReactor()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+#if __linux__
+	uint64_t one = 1;
+	if (_wakeFd >= 0 && ::write(_wakeFd, &one, sizeof(one)) < 0)
+		one = 0; // Counter saturated: the loop is waking anyway
+#endif
+	_workCv.notify_all();
+	if (_pollThread.joinable())
+		_pollThread.join();
+	for (auto &worker : _workers)
+		worker.join();
+#if __linux__
+	if (_epollFd >= 0)
+		::close(_epollFd);
+	if (_wakeFd >= 0)
+		::close(_wakeFd);
+#endif
+}
+
+InputReactor::SourceId InputReactor::add(int fd, Handler handler)
+{
+	if (!available() || fd < 0 || !handler)
+		return INVALID_SOURCE;
+	auto source = std::make_shared<Source>();
+	source->fd = fd;
+	source->handler = std::move(handler);
+	std::lock_guard<std::mutex> lock(_mutex);
+	source->id = _nextId++;
+#if __linux__
+	epoll_event event{};
+	event.events = EPOLLIN | EPOLLONESHOT;
+	event.data.u64 = source->id;
+	if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+	{
+		ToolKit::print("[ERROR] InputReactor: cannot watch fd ", fd, ", errno ", errno);
+		return INVALID_SOURCE;
+	}
+#endif
+	_sources.emplace(source->id, source);
+	return source->id;
+}
+
+void InputReactor::rearm(SourceId id)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _sources.find(id);
+	if (it != _sources.end())
+		arm(*it->second);
+}
+
+void InputReactor::post(SourceId id)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _sources.find(id);
+	if (it != _sources.end())
+		trigger(it->second);
+}
+
+void InputReactor::remove(SourceId id)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto it = _sources.find(id);
+	if (it == _sources.end())
+		return;
+	std::shared_ptr<Source> source = std::move(it->second);
+	_sources.erase(it);
+	source->removed = true;
+#if __linux__
+	// Fails harmlessly when the owner already closed the fd (closing drops it from the epoll set)
+	epoll_ctl(_epollFd, EPOLL_CTL_DEL, source->fd, nullptr);
+#endif
+	if (source->runner != std::this_thread::get_id())
+		_doneCv.wait(lock, [&source]
+					 { return !source->running; });
+}
+
+size_t InputReactor::sourceCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _sources.size();
+}
+
+void InputReactor::trigger(const std::shared_ptr<Source> &source)
+{
+	if (source->removed)
+		return;
+	if (source->running)
+		source->again = true;
+	else if (!source->scheduled)
+	{
+		source->scheduled = true;
+		_ready.push_back(source);
+		_workCv.notify_one();
+	}
+}
+
+void InputReactor::arm(const Source &source)
+{
+#if __linux__
+	epoll_event event{};
+	event.events = EPOLLIN | EPOLLONESHOT;
+	event.data.u64 = source.id;
+	epoll_ctl(_epollFd, EPOLL_CTL_MOD, source.fd, &event);
+#endif
+}
+
+void InputReactor::pollLoop()
+{
+#if __linux__
+	epoll_event events[32];
+	while (true)
+	{
+		int ready = epoll_wait(_epollFd, events, 32, -1);
+		if (ready < 0 && errno != EINTR)
+		{
+			ToolKit::print("[ERROR] InputReactor: epoll_wait failed, errno ", errno);
+			break;
+		}
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_stop)
+			break;
+		for (int i = 0; i < ready; ++i)
+		{
+			auto it = _sources.find(events[i].data.u64);
+			if (it != _sources.end())
+				trigger(it->second);
+		}
+	}
+#endif
+}
+
+void InputReactor::workerLoop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true)
+	{
+		_workCv.wait(lock, [this]
+					 { return _stop || !_ready.empty(); });
+		if (_stop)
+			break;
+		std::shared_ptr<Source> source = std::move(_ready.front());
+		_ready.pop_front();
+		if (source->removed)
+			continue;
+		source->running = true;
+		source->runner = std::this_thread::get_id();
+		lock.unlock();
+		bool keepWatching = true; // A handler that throws keeps its device watched
+		try
+		{
+			keepWatching = source->handler();
+		}
+		catch (const std::exception &e)
+		{
+			ToolKit::print("[ERROR] InputReactor handler threw: ", e.what());
+		}
+		catch (...)
+		{
+			ToolKit::print("[ERROR] InputReactor handler threw an unknown exception");
+		}
+		lock.lock();
+		source->running = false;
+		source->runner = std::thread::id();
+		if (!source->removed)
+		{
+			if (keepWatching)
+				arm(*source);
+			if (source->again)
+			{
+				source->again = false;
+				_ready.push_back(source);
+				_workCv.notify_one();
+			}
+			else
+				source->scheduled = false;
+		}
+		_doneCv.notify_all();
+	}
+}
+
+std::shared_ptr<InputReactor> InputReactor::shared()
+{
+	std::lock_guard<std::mutex> lock(_sharedMutex);
+	return _shared;
+}
+
+void InputReactor::setShared(std::shared_ptr<InputReactor> reactor)
+{
+	std::lock_guard<std::mutex> lock(_sharedMutex);
+	_shared = std::move(reactor);
+}
@@ -0,0 +1,118 @@
+/**
+ * @file inputreactor.h
+ * @brief Shared epoll loop that watches the input of every device, so device count does not set thread count.
+ *
+ * Without a reactor every ReadController runs its own read thread. Once a reactor is installed with
+ * setShared(), controllers created afterwards register their device's pollable fd here instead: one
+ * thread waits on all fds with epoll, and a small fixed set of workers runs the per-device handlers.
+ *
+ * Sources are armed one-shot: after a source became readable it is not reported again until its handler
+ * returned true, so one device is never handled by two workers at once and reports stay in order.
+ * post() runs a handler without input (e.g. for a timer deadline); triggers that arrive while the
+ * handler runs are merged into one more run.
+ *
+ * Handlers should only do the I/O: ReadController hands the reports to its own dispatch executor, so
+ * application callbacks never occupy the reactor workers.
+ *
+ * Linux only; elsewhere available() is false and controllers keep their read threads.
+ *
+ * Example usage:
+ *   InputReactor::setShared(std::make_shared<InputReactor>(2));	// before the devices are created
+ *   DeviceManager manager;
+ *   manager.enumerator();
+ */
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class InputReactor
+{
+public:
+	using SourceId = uint64_t;
+	/// Runs on a worker. Return true to keep watching the fd, false to leave it disarmed until rearm().
+	/// A handler that throws is logged and its fd is watched again.
+	using Handler = std::function<bool()>;
+
+	static constexpr SourceId INVALID_SOURCE = 0;
+	static constexpr size_t DEFAULT_WORKERS = 2;
+
+	explicit InputReactor(size_t workers = DEFAULT_WORKERS);
+	/// Joins the threads. Sources still registered are dropped without running their handlers again.
+	~InputReactor();
+
+	InputReactor(const InputReactor&) = delete;
+	InputReactor& operator=(const InputReactor&) = delete;
+
+	/// Whether the epoll loop is running.
+	bool available() const { return _epollFd >= 0 && _wakeFd >= 0; }
+
+	/**
+	 * @brief Watch `fd` for input. The fd stays owned by the caller and must outlive remove().
+	 * @return Source id, or INVALID_SOURCE when the fd could not be added.
+	 */
+	SourceId add(int fd, Handler handler);
+
+	/// Watch the source again after its handler returned false.
+	void rearm(SourceId id);
+
+	/// Run the source's handler on a worker as soon as possible, without input.
+	void post(SourceId id);
+
+	/**
+	 * @brief Stop watching a source. If its handler is running on another thread, waits for it to finish.
+	 * Safe from inside the handler itself.
+	 */
+	void remove(SourceId id);
+
+	/// Number of registered sources.
+	size_t sourceCount() const;
+	size_t workerCount() const { return _workers.size(); }
+
+	/// Reactor ReadControllers register with, or nullptr (the default) for one read thread per device.
+	static std::shared_ptr<InputReactor> shared();
+	/// Install the process-wide reactor. Controllers created earlier keep their read threads.
+	static void setShared(std::shared_ptr<InputReactor> reactor);
+
+private:
+	struct Source
+	{
+		SourceId id = INVALID_SOURCE;
+		int fd = -1;
+		Handler handler;
+		bool scheduled = false;	///< In _ready or running.
+		bool again = false;		///< Triggered while running; run once more.
+		bool running = false;
+		bool removed = false;
+		std::thread::id runner;
+	};
+
+	void pollLoop();
+	void workerLoop();
+	/// Queue a run of the source under `_mutex`.
+	void trigger(const std::shared_ptr<Source>& source);
+	/// Re-enable the one-shot watch under `_mutex`.
+	void arm(const Source& source);
+
+	int _epollFd = -1;
+	int _wakeFd = -1;	///< Ends epoll_wait() for shutdown.
+	SourceId _nextId = 1;
+	bool _stop = false;
+
+	mutable std::mutex _mutex;
+	std::condition_variable _workCv;
+	std::condition_variable _doneCv;	///< Signalled when a handler finishes, for remove().
+	std::unordered_map<SourceId, std::shared_ptr<Source>> _sources;
+	std::deque<std::shared_ptr<Source>> _ready;
+	std::thread _pollThread;
+	std::vector<std::thread> _workers;
+
+	static std::mutex _sharedMutex;
+	static std::shared_ptr<InputReactor> _shared;
+};
@@ -0,0 +1,68 @@
+#include "scheduledtask.h"
+#include <toolkit.h>
+
+ScheduledTask::ScheduledTask(Task task, std::shared_ptr<CallbackExecutor> executor, std::shared_ptr<TimerWheel> wheel)
+	: _state(std::make_shared<State>()), _executor(executor ? std::move(executor) : CallbackExecutor::internal()), _wheel(wheel ? std::move(wheel) : TimerWheel::shared())
+{
+	_state->task = std::move(task);
+}
+
+ScheduledTask::~ScheduledTask()
+{
+	cancel();
+}
+
+void ScheduledTask::runAfter(std::chrono::milliseconds delay)
+{
+	reschedule(delay, false);
+}
+
+void ScheduledTask::runEvery(std::chrono::milliseconds period)
+{
+	reschedule(period, true);
+}
+
+void ScheduledTask::reschedule(std::chrono::milliseconds delay, bool periodic)
+{
+	std::lock_guard<std::mutex> lock(_timerMutex);
+	if (_timer != TimerWheel::INVALID_TIMER)
+		_wheel->cancel(_timer); // The timer task only queues a run, so this never waits long
+	auto fireTask = [state = _state, executor = _executor]
+	{ fire(state, executor); };
+	_timer = periodic ? _wheel->scheduleEvery(delay, fireTask) : _wheel->schedule(delay, fireTask);
+}
+
+void ScheduledTask::cancel()
+{
+	// Hold the run lock so a running task cannot reschedule itself between the timer cancel and the generation bump
+	std::unique_lock<std::mutex> run(_state->mutex, std::defer_lock);
+	if (_state->runner.load() != std::this_thread::get_id())
+		run.lock();
+	std::lock_guard<std::mutex> lock(_timerMutex);
+	if (_timer != TimerWheel::INVALID_TIMER)
+		_wheel->cancel(_timer); // Waits for a fire() in progress
+	_timer = TimerWheel::INVALID_TIMER;
+	++_state->generation;
+	_state->queued = false;
+}
+
+void ScheduledTask::fire(const std::shared_ptr<State> &state, const std::shared_ptr<CallbackExecutor> &executor)
+{
+	if (state->queued.exchange(true))
+		return; // Previous run still waiting for a worker
+	uint64_t generation = state->generation;
+	bool posted = executor->post(reinterpret_cast<uintptr_t>(state.get()), [state, generation]
+				   {
+					   std::lock_guard<std::mutex> lock(state->mutex);
+					   if (generation != state->generation)
+						   return; // Cancelled while queued
+					   state->queued = false;
+					   state->runner = std::this_thread::get_id();
+					   state->task();
+					   state->runner = std::thread::id(); });
+	if (!posted)
+	{
+		state->queued = false; // Let the next tick try again
+		ToolKit::print("[ERROR] Scheduled task was not queued: executor is stopping");
+	}
+}
@@ -0,0 +1,69 @@
+/**
+ * @file scheduledtask.h
+ * @brief A task run on the SDK's internal CallbackExecutor when a TimerWheel timer fires.
+ *
+ * Device features that used to own a sleeping thread (heartbeat, GIF playback) keep one ScheduledTask
+ * instead: the wheel only decides when, the work itself (USB writes, frame uploads) runs on an executor
+ * worker so it never holds up other timers. At most one run is queued at a time; a timer firing while a
+ * run is still queued is dropped, so a slow device never builds up a backlog.
+ *
+ * The executor must never drop a queued run (the default, CallbackExecutor::internal(), is Unbounded):
+ * a dropped run would leave the task marked queued and stop it for good.
+ *
+ * After cancel() or destruction returns, the task is neither running nor going to run, so it may
+ * capture the owning object.
+ *
+ * Example usage:
+ *   ScheduledTask beat([this] { _instance->heartbeat(); });
+ *   beat.runEvery(std::chrono::seconds(10));
+ *   ScheduledTask frame([this] { showNextFrame(); frame.runAfter(nextDelay()); });
+ */
+#pragma once
+#include "callbackexecutor.h"
+#include "timerwheel.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class ScheduledTask
+{
+public:
+	using Task = std::function<void()>;
+
+	explicit ScheduledTask(Task task, std::shared_ptr<CallbackExecutor> executor = CallbackExecutor::internal(), std::shared_ptr<TimerWheel> wheel = TimerWheel::shared());
+	/// cancel(); safe from inside the task.
+	~ScheduledTask();
+
+	ScheduledTask(const ScheduledTask&) = delete;
+	ScheduledTask& operator=(const ScheduledTask&) = delete;
+
+	/// Run once after `delay`, replacing any earlier schedule. Safe from inside the task.
+	void runAfter(std::chrono::milliseconds delay);
+
+	/// Run every `period`, replacing any earlier schedule.
+	void runEvery(std::chrono::milliseconds period);
+
+	/// Drop the schedule and a queued run; waits for a running task unless called from it.
+	void cancel();
+
+private:
+	struct State
+	{
+		std::mutex mutex;	///< Held while the task runs.
+		Task task;
+		std::atomic<std::thread::id> runner{};
+		std::atomic<uint64_t> generation{ 0 };	///< Bumped by cancel(); queued runs of older generations are skipped.
+		std::atomic<bool> queued{ false };
+	};
+
+	/// Timer callback: queue one run on the executor unless one is queued already.
+	static void fire(const std::shared_ptr<State>& state, const std::shared_ptr<CallbackExecutor>& executor);
+	void reschedule(std::chrono::milliseconds delay, bool periodic);
+
+	std::shared_ptr<State> _state;
+	std::shared_ptr<CallbackExecutor> _executor;
+	std::shared_ptr<TimerWheel> _wheel;
+	std::mutex _timerMutex;
+	TimerWheel::TimerId _timer = TimerWheel::INVALID_TIMER;
+};
@@ -0,0 +1,218 @@
+#include "timerwheel.h"
+#include <algorithm>
+#include <exception>
+#include <toolkit.h>
+
+TimerWheel::TimerWheel(std::chrono::milliseconds tick, size_t slots)
+	: _tick(std::max(tick, std::chrono::milliseconds(1)))
+{
+	uint64_t span = 1;
+	for (size_t level = 0; level < LEVELS; ++level)
+	{
+		_levels.emplace_back(level == 0 ? std::max<size_t>(slots, 1) : UPPER_SLOTS);
+		_span.push_back(span);
+		span *= _levels.back().size();
+	}
+	_thread = std::thread(&TimerWheel::run, this);
+}
+
+TimerWheel::~TimerWheel()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	if (_thread.joinable())
+		_thread.join();
+}
+
+TimerWheel::TimerId TimerWheel::schedule(std::chrono::milliseconds delay, Task task)
+{
+	return add(delay, 0, std::move(task));
+}
+
+TimerWheel::TimerId TimerWheel::scheduleEvery(std::chrono::milliseconds period, Task task)
+{
+	return add(period, ticksFor(period), std::move(task));
+}
+
+uint64_t TimerWheel::ticksFor(std::chrono::milliseconds delay) const
+{
+	// Round up so a timer never fires early
+	return std::max<uint64_t>(1, (std::max<int64_t>(delay.count(), 0) + _tick.count() - 1) / _tick.count());
+}
+
+uint64_t TimerWheel::expiryFor(Clock::time_point due) const
+{
+	// Tick _current + 1 is due at _nextTick, which may be almost now (or past, while the wheel catches up),
+	// so count from _nextTick rather than from _current: the first tick due at or after `due`
+	if (due <= _nextTick)
+		return _current + 1;
+	const auto ahead = std::chrono::duration_cast<std::chrono::nanoseconds>(due - _nextTick).count();
+	const auto tick = std::chrono::duration_cast<std::chrono::nanoseconds>(_tick).count();
+	return _current + 1 + static_cast<uint64_t>((ahead + tick - 1) / tick);
+}
+
+TimerWheel::TimerId TimerWheel::add(std::chrono::milliseconds delay, uint64_t period, Task task)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	bool wasIdle = _index.empty();
+	if (wasIdle)
+		_nextTick = Clock::now() + _tick; // Wheel was idle: start ticking from now
+	TimerId id = _nextId++;
+	insert({id, expiryFor(Clock::now() + std::max(delay, std::chrono::milliseconds(0))), period, std::move(task)});
+	lock.unlock();
+	if (wasIdle)
+		_cv.notify_one();
+	return id;
+}
+
+void TimerWheel::insert(Timer timer)
+{
+	timer.expires = std::max(timer.expires, _current + 1);
+	size_t level = 0;
+	while (level + 1 < LEVELS && timer.expires / _span[level] - _current / _span[level] >= _levels[level].size())
+		++level;
+	if (timer.expires / _span[level] - _current / _span[level] >= _levels[level].size())
+		timer.expires = (_current / _span[level] + _levels[level].size() - 1) * _span[level]; // Beyond the top level
+	Slot &bucket = _levels[level][(timer.expires / _span[level]) % _levels[level].size()];
+	TimerId id = timer.id;
+	bucket.push_back(std::move(timer));
+	_index[id] = std::make_pair(&bucket, std::prev(bucket.end()));
+}
+
+void TimerWheel::cascade()
+{
+	// Highest level first: its timers may land in the lower bucket reached at the same tick
+	for (size_t level = LEVELS - 1; level > 0; --level)
+	{
+		if (_current % _span[level] != 0)
+			continue;
+		Slot bucket;
+		bucket.swap(_levels[level][(_current / _span[level]) % _levels[level].size()]);
+		for (auto &timer : bucket)
+			insert(std::move(timer));
+	}
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto it = _index.find(id);
+	if (it != _index.end())
+	{
+		Task task = std::move(it->second.second->task);
+		it->second.first->erase(it->second.second);
+		_index.erase(it);
+		lock.unlock(); // Destroy the task's captures outside the lock
+		return true;
+	}
+	for (auto &timer : _expired)
+	{ // Due this tick but not started yet
+		if (timer.id == id && timer.task)
+		{
+			Task task = std::move(timer.task);
+			timer.task = nullptr;
+			lock.unlock();
+			return true;
+		}
+	}
+	if (_running != id)
+		return false;
+	_runningCancelled = true;
+	if (std::this_thread::get_id() != _thread.get_id())
+		_doneCv.wait(lock, [this, id]
+					 { return _running != id; });
+	return true;
+}
+
+size_t TimerWheel::pending() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _index.size();
+}
+
+void TimerWheel::run()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_stop)
+	{
+		if (_index.empty())
+		{
+			_cv.wait(lock, [this]
+					 { return _stop || !_index.empty(); });
+			continue;
+		}
+		if (Clock::now() < _nextTick)
+		{
+			_cv.wait_until(lock, _nextTick);
+			continue;
+		}
+
+		++_current;
+		_nextTick += _tick;
+		cascade();
+		Slot &bucket = _levels[0][_current % _levels[0].size()];
+		for (auto &timer : bucket)
+		{
+			_index.erase(timer.id);
+			_expired.push_back(std::move(timer));
+		}
+		bucket.clear();
+
+		for (size_t i = 0; i < _expired.size() && !_stop; ++i)
+		{
+			Task task = std::move(_expired[i].task);
+			if (!task)
+				continue; // Cancelled after it was due
+			_expired[i].task = nullptr;
+			_running = _expired[i].id;
+			_runningCancelled = false;
+			lock.unlock();
+			try
+			{
+				task();
+			}
+			catch (const std::exception &e)
+			{
+				ToolKit::print("[ERROR] Timer task threw:", e.what());
+			}
+			catch (...)
+			{
+				ToolKit::print("[ERROR] Timer task threw an unknown exception");
+			}
+			Timer &timer = _expired[i];
+			if (!timer.period)
+				task = nullptr;
+			lock.lock();
+			if (timer.period && !_runningCancelled && !_stop)
+			{
+				// Stay on the period grid; skip runs the wheel fell behind on
+				uint64_t late = _current - timer.expires;
+				timer.expires += (late / timer.period + 1) * timer.period;
+				timer.task = std::move(task);
+				insert(std::move(timer));
+			}
+			_running = INVALID_TIMER;
+			_doneCv.notify_all();
+			if (task)
+			{ // Cancelled periodic timer: destroy its captures outside the lock
+				lock.unlock();
+				task = nullptr;
+				lock.lock();
+			}
+		}
+		_expired.clear();
+	}
+}
+
+std::shared_ptr<TimerWheel> TimerWheel::shared()
+{
+	static std::mutex mutex;
+	static std::shared_ptr<TimerWheel> wheel;
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!wheel)
+		wheel = std::make_shared<TimerWheel>();
+	return wheel;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file timerwheel.h
+ * @brief Hierarchical timing wheel: one thread and one set of slot arrays for every timer in the process.
+ *
+ * Level 0 has `slots` buckets of one tick each. Each higher level has UPPER_SLOTS buckets, each spanning
+ * a full revolution of the level below. A timer goes into the lowest level whose range covers it, and
+ * moves down one level when the wheel reaches its bucket. Every tick the wheel visits one level-0
+ * bucket, so scheduling, cancelling and expiring are O(1) however many timers are pending and however
+ * far out they are (heartbeats every few seconds, long presses, animation frame deadlines). The thread
+ * sleeps without a timeout while no timer is pending, so an idle wheel costs nothing.
+ *
+ * Timers are one-shot (schedule()) or periodic (scheduleEvery()). Tasks run on the wheel thread and
+ * should be short (post longer work to a CallbackExecutor, or use ScheduledTask).
+ *
+ * Example usage:
+ *   auto wheel = TimerWheel::shared();
+ *   TimerWheel::TimerId id = wheel->schedule(std::chrono::milliseconds(500), [] { onLongPress(); });
+ *   wheel->cancel(id);	// once this returns the task is neither running nor going to run
+ */
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class TimerWheel
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	using TimerId = uint64_t;
+	using Task = std::function<void()>;
+
+	static constexpr TimerId INVALID_TIMER = 0;
+	static constexpr std::chrono::milliseconds DEFAULT_TICK{ 10 };
+	static constexpr size_t DEFAULT_SLOTS = 512;
+	static constexpr size_t UPPER_SLOTS = 64;	///< Buckets of every level above 0.
+	static constexpr size_t LEVELS = 4;		///< With the defaults: 5.12 s, 5.5 min, 5.8 h, 15.5 days; later timers are clamped.
+
+	/**
+	 * @param tick Resolution; timers fire up to one tick late, never early.
+	 * @param slots Level-0 buckets.
+	 */
+	explicit TimerWheel(std::chrono::milliseconds tick = DEFAULT_TICK, size_t slots = DEFAULT_SLOTS);
+	/// Drops pending timers and joins the thread.
+	~TimerWheel();
+
+	TimerWheel(const TimerWheel&) = delete;
+	TimerWheel& operator=(const TimerWheel&) = delete;
+
+	/// Run `task` once after `delay`. Returns an id for cancel(), never INVALID_TIMER.
+	TimerId schedule(std::chrono::milliseconds delay, Task task);
+
+	/**
+	 * @brief Run `task` every `period` until cancelled. Expiries are kept on the period grid; if the
+	 * wheel falls behind, missed runs are skipped rather than run back to back.
+	 */
+	TimerId scheduleEvery(std::chrono::milliseconds period, Task task);
+
+	/**
+	 * @brief Cancel a timer. If its task is running on another thread, waits for it to finish.
+	 * A periodic timer may cancel itself from its own task.
+	 * @return true if the timer was still pending.
+	 */
+	bool cancel(TimerId id);
+
+	/// Number of pending timers.
+	size_t pending() const;
+
+	std::chrono::milliseconds tick() const { return _tick; }
+
+	/// Process-wide wheel shared by every device.
+	static std::shared_ptr<TimerWheel> shared();
+
+private:
+	struct Timer
+	{
+		TimerId id;
+		uint64_t expires;	///< Absolute tick.
+		uint64_t period;	///< Ticks between runs; 0 for one-shot timers.
+		Task task;
+	};
+	using Slot = std::list<Timer>;
+
+	TimerId add(std::chrono::milliseconds delay, uint64_t period, Task task);
+	uint64_t ticksFor(std::chrono::milliseconds delay) const;
+	/// First tick that is due no earlier than `due`, under `_mutex`.
+	uint64_t expiryFor(Clock::time_point due) const;
+	/// Put a timer into the bucket matching its expiry and index it, under `_mutex`.
+	void insert(Timer timer);
+	/// Move the timers of the higher-level buckets reached at tick _current one level down.
+	void cascade();
+	void run();
+
+	const std::chrono::milliseconds _tick;
+	std::vector<std::vector<Slot>> _levels;
+	std::vector<uint64_t> _span;	///< Ticks covered by one bucket of each level.
+	std::unordered_map<TimerId, std::pair<Slot*, Slot::iterator>> _index;	///< id -> bucket and position, for O(1) cancel.
+	uint64_t _current = 0;			///< Last tick processed.
+	Clock::time_point _nextTick;	///< When tick _current + 1 is due.
+	TimerId _nextId = 1;
+	std::vector<Timer> _expired;		///< Due timers of the current tick; cancel() clears their task.
+	TimerId _running = INVALID_TIMER;	///< Timer whose task is running now.
+	bool _runningCancelled = false;		///< cancel() was called for _running; a periodic timer is not re-armed.
+	bool _stop = false;
+
+	mutable std::mutex _mutex;
+	std::condition_variable _cv;
+	std::condition_variable _doneCv;	///< Signalled when a task finishes, for cancel().
+	std::thread _thread;
+};
@@ -1,10 +1,25 @@
 #include "TransportCWrapper.h"
+#include <mutex>
 #include <stdexcept>
 #include <iostream>
 
+namespace
+{
+	int64_t nowTicks()
+	{
+		return LinkActivity::Clock::now().time_since_epoch().count();
+	}
+
+	LinkActivity::Clock::time_point fromTicks(int64_t ticks)
+	{
+		return LinkActivity::Clock::time_point(LinkActivity::Clock::duration(ticks));
+	}
+}
+
 TransportCWrapper::TransportCWrapper(const hid_device_info &device_info)
 {
-	transport_create(&device_info, &_handle);
+	keepDeviceInfo(device_info);
+	transport_create(&_deviceInfo, &_handle);
 }
 
 TransportCWrapper::~TransportCWrapper()
@@ -20,31 +35,139 @@ TransportCWrapper::TransportCWrapper(TransportCWrapper &&other) noexcept
 	: _handle(other._handle)
 {
 	other._handle = nullptr;
+	keepDeviceInfo(other._deviceInfo);
+	_input_report_size = other._input_report_size;
+	_output_report_size = other._output_report_size;
+	_feature_report_size = other._feature_report_size;
 }
 
 TransportCWrapper &TransportCWrapper::operator=(TransportCWrapper &&other) noexcept
 {
 	if (this != &other)
 	{
+		std::unique_lock<std::shared_mutex> lock(_handleMutex);
 		if (_handle)
 			transport_destroy(_handle);
 		_handle = other._handle;
 		other._handle = nullptr;
+		keepDeviceInfo(other._deviceInfo);
+		_input_report_size = other._input_report_size;
+		_output_report_size = other._output_report_size;
+		_feature_report_size = other._feature_report_size;
 	}
 	return *this;
 }
 
+void TransportCWrapper::keepDeviceInfo(const hid_device_info &device_info)
+{
+	_path = device_info.path ? device_info.path : "";
+	_serialNumber = device_info.serial_number ? device_info.serial_number : L"";
+	_manufacturer = device_info.manufacturer_string ? device_info.manufacturer_string : L"";
+	_product = device_info.product_string ? device_info.product_string : L"";
+	_deviceInfo = device_info;
+	_deviceInfo.path = _path.data();
+	_deviceInfo.serial_number = _serialNumber.data();
+	_deviceInfo.manufacturer_string = _manufacturer.data();
+	_deviceInfo.product_string = _product.data();
+	_deviceInfo.next = nullptr;
+}
+
+bool TransportCWrapper::reopen()
+{
+	std::unique_lock<std::shared_mutex> lock(_handleMutex);
+	uint8_t report_id = 0x00;
+	if (_handle)
+	{
+		transport_reportID(_handle, &report_id);
+		transport_destroy(_handle);
+		_handle = nullptr;
+	}
+	TransportResult result = transport_create(&_deviceInfo, &_handle);
+	if (result != TRANSPORT_SUCCESS || !_handle)
+	{
+		noteError(result, nowTicks());
+		return false;
+	}
+	++_reopens;
+	if (report_id != 0x00)
+		transport_set_reportID(_handle, report_id);
+	if (_input_report_size || _output_report_size || _feature_report_size)
+		transport_set_reportSize(_handle, _input_report_size, _output_report_size, _feature_report_size);
+	_writeFailures = 0;
+	_readFailures = 0;
+	int can_write = 0;
+	transport_can_write(_handle, &can_write);
+	return can_write != 0;
+}
+
+LinkActivity TransportCWrapper::activity() const
+{
+	LinkActivity activity;
+	activity.lastTx = fromTicks(_lastTx);
+	activity.lastRx = fromTicks(_lastRx);
+	activity.lastError = fromTicks(_lastError);
+	activity.lastErrorCode = _lastErrorCode;
+	activity.consecutiveWriteFailures = _writeFailures;
+	activity.consecutiveReadFailures = _readFailures;
+	activity.writes = _writes;
+	activity.reads = _reads;
+	activity.errors = _errors;
+	activity.reopens = _reopens;
+	return activity;
+}
+
+bool TransportCWrapper::noteWrite(TransportResult result) const
+{
+	int64_t now = nowTicks();
+	if (result == TRANSPORT_SUCCESS)
+	{
+		_lastTx = now;
+		_writeFailures = 0;
+		++_writes;
+		return true;
+	}
+	++_writeFailures;
+	noteError(result, now);
+	return false;
+}
+
+void TransportCWrapper::noteRead(TransportResult result, size_t length) const
+{
+	int64_t now = nowTicks();
+	if (result == TRANSPORT_SUCCESS || result == TRANSPORT_ERROR_TIMEOUT_READ)
+	{
+		_readFailures = 0;
+		if (result == TRANSPORT_SUCCESS && length > 0)
+		{
+			_lastRx = now;
+			++_reads;
+		}
+		return;
+	}
+	++_readFailures;
+	noteError(result, now);
+}
+
+void TransportCWrapper::noteError(TransportResult result, int64_t now) const
+{
+	_lastError = now;
+	_lastErrorCode = result;
+	++_errors;
+}
+
 std::string TransportCWrapper::getFirmwareVesion() const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return "";
 	std::string firmwareVersion(_input_report_size, '\0');
-	transport_get_firmware_version(_handle, firmwareVersion.data(), firmwareVersion.size());
+	noteWrite(transport_get_firmware_version(_handle, firmwareVersion.data(), firmwareVersion.size()));
 	return firmwareVersion;
 }
 
 void TransportCWrapper::clearTaskQueue() const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
 	transport_clear_task_queue(_handle);
@@ -52,6 +175,7 @@ void TransportCWrapper::clearTaskQueue() const
 
 bool TransportCWrapper::canWrite() const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return false;
 	int can_write = 0;
@@ -61,65 +185,77 @@ bool TransportCWrapper::canWrite() const
 
 void TransportCWrapper::read(uint8_t *response, size_t *length, int32_t timeoutMs) const
 {
-	if (!_handle || !response || !length)
+	if (!response || !length)
+		throw std::invalid_argument("Invalid arguments for read operation.");
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
+	if (!_handle)
 		throw std::invalid_argument("Invalid arguments for read operation.");
-	transport_read(_handle, response, length, timeoutMs);
+	TransportResult result = transport_read(_handle, response, length, timeoutMs);
+	noteRead(result, result == TRANSPORT_SUCCESS ? *length : 0);
 }
 
 void TransportCWrapper::wakeupScreen() const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_wakeup_screen(_handle);
+	noteWrite(transport_wakeup_screen(_handle));
 }
 
 void TransportCWrapper::setKeyBrightness(uint8_t brightness) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_set_key_brightness(_handle, brightness);
+	noteWrite(transport_set_key_brightness(_handle, brightness));
 }
 
 void TransportCWrapper::clearAllKeys() const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_clear_all_keys(_handle);
+	noteWrite(transport_clear_all_keys(_handle));
 }
 
 void TransportCWrapper::clearKey(uint8_t key_value) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_clear_key(_handle, key_value);
+	noteWrite(transport_clear_key(_handle, key_value));
 }
 
 void TransportCWrapper::refresh() const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_refresh(_handle);
+	noteWrite(transport_refresh(_handle));
 }
 
 void TransportCWrapper::sleep() const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_sleep(_handle);
+	noteWrite(transport_sleep(_handle));
 }
 
 void TransportCWrapper::disconnected() const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_disconnected(_handle);
+	noteWrite(transport_disconnected(_handle));
 }
 
 void TransportCWrapper::heartbeat() const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_heartbeat(_handle);
+	noteWrite(transport_heartbeat(_handle));
 }
 
 // void TransportCWrapper::setKeyBitmap(const std::string &bitmapStream, uint8_t keyValue) const
@@ -128,11 +264,17 @@ void TransportCWrapper::heartbeat() const
 //     transport_set_key_bitmap(_handle, bitmapStream.data(), bitmapStream.size(), keyValue);
 // }
 
-void TransportCWrapper::setBackgroundBitmap(const std::string &bitmapStream, int32_t timeoutMs) const
+bool TransportCWrapper::setBackgroundBitmap(const std::string &bitmapStream, int32_t timeoutMs) const
 {
+	return setBackgroundBitmap(reinterpret_cast<const uint8_t *>(bitmapStream.data()), bitmapStream.size(), timeoutMs);
+}
+
+bool TransportCWrapper::setBackgroundBitmap(const uint8_t *data, size_t size, int32_t timeoutMs) const
+{
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
-		return;
-	transport_set_background_bitmap(_handle, bitmapStream.data(), bitmapStream.size(), timeoutMs);
+		return false;
+	return noteWrite(transport_set_background_bitmap(_handle, reinterpret_cast<const char *>(data), size, timeoutMs));
 }
 
 // void TransportCWrapper::setKeyImgFile(const std::string &filePath, uint8_t keyValue) const
@@ -141,11 +283,17 @@ void TransportCWrapper::setBackgroundBitmap(const std::string &bitmapStream, int
 //     transport_set_key_image(_handle, filePath.data(), keyValue);
 // }
 
-void TransportCWrapper::setKeyImgFileStream(const std::string &jpegData, uint8_t keyValue) const
+bool TransportCWrapper::setKeyImgFileStream(const std::string &jpegData, uint8_t keyValue) const
+{
+	return setKeyImgFileStream(reinterpret_cast<const uint8_t *>(jpegData.data()), jpegData.size(), keyValue);
+}
+
+bool TransportCWrapper::setKeyImgFileStream(const uint8_t *data, size_t size, uint8_t keyValue) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
-		return;
-	transport_set_key_image_stream(_handle, jpegData.data(), jpegData.size(), keyValue);
+		return false;
+	return noteWrite(transport_set_key_image_stream(_handle, reinterpret_cast<const char *>(data), size, keyValue));
 }
 
 // void TransportCWrapper::setBackgroundImgFile(const std::string &filePath, int32_t timeoutMs) const
@@ -154,71 +302,86 @@ void TransportCWrapper::setKeyImgFileStream(const std::string &jpegData, uint8_t
 //     transport_set_background_image(_handle, filePath.data(), timeoutMs);
 // }
 
-void TransportCWrapper::setBackgroundImgStream(const std::string &jpegData, int32_t timeoutMs) const
+bool TransportCWrapper::setBackgroundImgStream(const std::string &jpegData, int32_t timeoutMs) const
 {
+	return setBackgroundImgStream(reinterpret_cast<const uint8_t *>(jpegData.data()), jpegData.size(), timeoutMs);
+}
+
+bool TransportCWrapper::setBackgroundImgStream(const uint8_t *data, size_t size, int32_t timeoutMs) const
+{
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
-		return;
-	transport_set_background_image_stream(_handle, jpegData.data(), jpegData.size(), timeoutMs);
+		return false;
+	return noteWrite(transport_set_background_image_stream(_handle, reinterpret_cast<const char *>(data), size, timeoutMs));
 }
 
 void TransportCWrapper::setBackgroundFrameStream(const std::string &jpegData, uint16_t width, uint16_t height, uint16_t x, uint16_t y, uint8_t FBlayer) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_set_background_frame_stream(_handle, jpegData.data(), jpegData.size(), width, height, x, y, FBlayer);
+	noteWrite(transport_set_background_frame_stream(_handle, jpegData.data(), jpegData.size(), width, height, x, y, FBlayer));
 }
 
 void TransportCWrapper::clearBackgroundFrameStream(uint8_t postion) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_clear_background_frame_stream(_handle, postion);
+	noteWrite(transport_clear_background_frame_stream(_handle, postion));
 }
 
 void TransportCWrapper::setLedBrightness(uint8_t brightness) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_set_led_brightness(_handle, brightness);
+	noteWrite(transport_set_led_brightness(_handle, brightness));
 }
 
 void TransportCWrapper::setLedColor(uint16_t count, uint8_t r, uint8_t g, uint8_t b) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_set_led_color(_handle, count, r, g, b);
+	noteWrite(transport_set_led_color(_handle, count, r, g, b));
 }
 
 void TransportCWrapper::setSingleLedColor(const std::vector<std::array<uint8_t, 3>> &colors) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle || colors.empty())
 		return;
-	transport_set_single_led_color(_handle, static_cast<uint16_t>(colors.size()), reinterpret_cast<const uint8_t(*)[3]>(colors.data()));
+	noteWrite(transport_set_single_led_color(_handle, static_cast<uint16_t>(colors.size()), reinterpret_cast<const uint8_t(*)[3]>(colors.data())));
 }
 
 void TransportCWrapper::resetLedColor() const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_reset_led_color(_handle);
+	noteWrite(transport_reset_led_color(_handle));
 }
 
 void TransportCWrapper::setDeviceConfig(std::vector<uint8_t> configs) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_set_device_config(_handle, configs.data(), configs.size());
+	noteWrite(transport_set_device_config(_handle, configs.data(), configs.size()));
 }
 
 void TransportCWrapper::changeMode(uint8_t mode) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_change_mode(_handle, mode);
+	noteWrite(transport_change_mode(_handle, mode));
 }
 
 void TransportCWrapper::setReportID(uint8_t reportID) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
 	transport_set_reportID(_handle, reportID);
@@ -226,6 +389,7 @@ void TransportCWrapper::setReportID(uint8_t reportID) const
 
 uint8_t TransportCWrapper::reportID() const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return 0x00;
 	uint8_t report_id = 0x00;
@@ -235,6 +399,7 @@ uint8_t TransportCWrapper::reportID() const
 
 void TransportCWrapper::setReportSize(uint16_t input_report_size, uint16_t output_report_size, uint16_t feature_report_size)
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
 	_input_report_size = input_report_size;
@@ -245,6 +410,7 @@ void TransportCWrapper::setReportSize(uint16_t input_report_size, uint16_t outpu
 
 void TransportCWrapper::rawHidLastError(wchar_t *errMsg, size_t *length) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
 	transport_raw_hid_last_error(_handle, errMsg, length);
@@ -257,55 +423,63 @@ void TransportCWrapper::disableOutput(bool isDisable)
 
 void TransportCWrapper::setKeyboardBacklightBrightness(uint8_t brightness) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_set_keyboard_backlight_brightness(_handle, brightness);
+	noteWrite(transport_set_keyboard_backlight_brightness(_handle, brightness));
 }
 
 void TransportCWrapper::setKeyboardLightingEffects(uint8_t effect) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_set_keyboard_lighting_effects(_handle, effect);
+	noteWrite(transport_set_keyboard_lighting_effects(_handle, effect));
 }
 
 void TransportCWrapper::setKeyboardLightingSpeed(uint8_t speed) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_set_keyboard_lighting_speed(_handle, speed);
+	noteWrite(transport_set_keyboard_lighting_speed(_handle, speed));
 }
 
 void TransportCWrapper::setKeyboardRgbBacklight(uint8_t red, uint8_t green, uint8_t blue) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_set_keyboard_rgb_backlight(_handle, red, green, blue);
+	noteWrite(transport_set_keyboard_rgb_backlight(_handle, red, green, blue));
 }
 
 void TransportCWrapper::keyboardOsModeSwitch(uint8_t os_mode) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_keyboard_os_mode_switch(_handle, os_mode);
+	noteWrite(transport_keyboard_os_mode_switch(_handle, os_mode));
 }
 
 void TransportCWrapper::magneticCalibration() const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_magnetic_calibration(_handle);
+	noteWrite(transport_magnetic_calibration(_handle));
 }
 
 void TransportCWrapper::changePage(uint8_t page) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_change_page(_handle, page);
+	noteWrite(transport_change_page(_handle, page));
 }
 void TransportCWrapper::setN1SkinBitmap(const std::string &bitmap, uint8_t skin_mode, uint8_t skin_page, uint8_t skin_status, uint8_t key_index, int32_t timeout_ms) const
 {
+	std::shared_lock<std::shared_mutex> lock(_handleMutex);
 	if (!_handle)
 		return;
-	transport_set_n1_skin_bitmap(_handle, bitmap.data(), bitmap.size(), skin_mode, skin_page, skin_status, key_index, timeout_ms);
+	noteWrite(transport_set_n1_skin_bitmap(_handle, bitmap.data(), bitmap.size(), skin_mode, skin_page, skin_status, key_index, timeout_ms));
 }
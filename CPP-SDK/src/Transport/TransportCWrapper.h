@@ -7,6 +7,7 @@
  * - Provides C++-style interfaces for the C-based transport_c.h library
  * - Manages TransportHandle lifetime with RAII
  * - Supports move semantics; copy is disabled
+ * - Records the outcome of every call (LinkActivity) and can reopen the handle in place for link recovery
  *
  * Common Interfaces:
  *   - read() / canWrite(): device I/O
@@ -23,12 +24,34 @@
 
 #pragma once
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 #include <cstdint>
 #include "hidapi.h"
 #include "./TransportDLL/transport_c.h"
 
+/**
+ * @brief Snapshot of a transport's traffic, used to tell an idle link from a wedged one.
+ * Time points are default-constructed (epoch) until the first such event.
+ */
+struct LinkActivity
+{
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point lastTx;				///< Last write the transport accepted.
+	Clock::time_point lastRx;				///< Last report read.
+	Clock::time_point lastError;			///< Last failed call (read timeouts are not failures).
+	TransportResult lastErrorCode = TRANSPORT_SUCCESS;
+	uint32_t consecutiveWriteFailures = 0;	///< Failed writes since the last successful one.
+	uint32_t consecutiveReadFailures = 0;	///< Failed reads since the last successful one.
+	uint64_t writes = 0;
+	uint64_t reads = 0;						///< Reads that returned a report.
+	uint64_t errors = 0;
+	uint32_t reopens = 0;
+};
+
 /**
  * @class TransportCWrapper
  * @brief C++ wrapper for transport_c.h to simplify HID device interaction.
@@ -61,6 +84,18 @@ public:
 	TransportCWrapper(TransportCWrapper &&other) noexcept;
 	TransportCWrapper &operator=(TransportCWrapper &&other) noexcept;
 
+	/**
+	 * @brief Close and recreate the transport handle for the same device, keeping report ID and sizes.
+	 * Waits for calls in progress on other threads; calls made meanwhile wait for the new handle.
+	 * @return true if the new handle can write.
+	 */
+	bool reopen();
+
+	/**
+	 * @brief Traffic and error counters since the handle was created.
+	 */
+	LinkActivity activity() const;
+
 	/**
 	 * @brief Get firmware version string from the device.
 	 * @return Firmware version as a string.
@@ -118,8 +153,11 @@ public:
 	 * @brief Set the full-screen background using raw bitmap data.
 	 * @param bitmapStream Raw bitmap bytes.
 	 * @param timeoutMs Transmission timeout (default 3000ms).
+	 * @return True if the device accepted the write.
 	 */
-	void setBackgroundBitmap(const std::string &bitmapStream, int32_t timeoutMs = 5000) const;
+	bool setBackgroundBitmap(const std::string &bitmapStream, int32_t timeoutMs = 5000) const;
+	/// Same as above for bytes the caller keeps in its own buffer (no std::string copy).
+	bool setBackgroundBitmap(const uint8_t *data, size_t size, int32_t timeoutMs = 5000) const;
 
 	// void setKeyImgFile(const std::string &filePath, uint8_t keyValue) const;
 
@@ -127,16 +165,22 @@ public:
 	 * @brief Set JPEG image to a specific key.
 	 * @param jpegData JPEG image data.
 	 * @param keyValue Target key index.
+	 * @return True if the device accepted the write.
 	 */
-	void setKeyImgFileStream(const std::string &jpegData, uint8_t keyValue) const;
+	bool setKeyImgFileStream(const std::string &jpegData, uint8_t keyValue) const;
+	/// Same as above for bytes the caller keeps in its own buffer (no std::string copy).
+	bool setKeyImgFileStream(const uint8_t *data, size_t size, uint8_t keyValue) const;
 
 	// void setBackgroundImgFile(const std::string &filePath, int32_t timeoutMs = 3000) const;
 	/**
 	 * @brief Set JPEG image as full-screen background.
 	 * @param jpegData JPEG image data.
 	 * @param timeoutMs Transmission timeout.
+	 * @return True if the device accepted the write.
 	 */
-	void setBackgroundImgStream(const std::string &jpegData, int32_t timeoutMs = 3000) const;
+	bool setBackgroundImgStream(const std::string &jpegData, int32_t timeoutMs = 3000) const;
+	/// Same as above for bytes the caller keeps in its own buffer (no std::string copy).
+	bool setBackgroundImgStream(const uint8_t *data, size_t size, int32_t timeoutMs = 3000) const;
 
 	/**
 	 * @brief Draw a JPEG frame at a specific position (used for animated backgrounds).
@@ -252,5 +296,32 @@ public:
 	uint16_t _feature_report_size = 0; ///< Feature report size.
 
 private:
+	/// Record the result of a write-type call. Returns true on success.
+	bool noteWrite(TransportResult result) const;
+	/// Record the result of a read; `length` is the report size (0 on timeout).
+	void noteRead(TransportResult result, size_t length) const;
+	void noteError(TransportResult result, int64_t now) const;
+	/// Point _deviceInfo at the strings owned by this object.
+	void keepDeviceInfo(const hid_device_info &device_info);
+
 	TransportHandle _handle = nullptr; ///< Actual communication handle.
+	mutable std::shared_mutex _handleMutex; ///< Shared by every call, exclusive while reopen() swaps the handle.
+
+	hid_device_info _deviceInfo{}; ///< Copy of the descriptor the handle was created from, for reopen().
+	std::string _path;
+	std::wstring _serialNumber;
+	std::wstring _manufacturer;
+	std::wstring _product;
+
+	/// Counters behind activity(); times are steady_clock ticks, 0 for never.
+	mutable std::atomic<int64_t> _lastTx{0};
+	mutable std::atomic<int64_t> _lastRx{0};
+	mutable std::atomic<int64_t> _lastError{0};
+	mutable std::atomic<TransportResult> _lastErrorCode{TRANSPORT_SUCCESS};
+	mutable std::atomic<uint32_t> _writeFailures{0};
+	mutable std::atomic<uint32_t> _readFailures{0};
+	mutable std::atomic<uint64_t> _writes{0};
+	mutable std::atomic<uint64_t> _reads{0};
+	mutable std::atomic<uint64_t> _errors{0};
+	std::atomic<uint32_t> _reopens{0};
 };
@@ -26,8 +26,8 @@ int main()
 	DeviceManager::instance().enumerator();
 	DeviceManager::instance().listen([](std::shared_ptr<StreamDock> device)
 									 { doSomething(device); });
-	auto &streamdocks = DeviceManager::instance().getStreamDocks();
-	for (const auto &device : streamdocks)
+	auto streamdocks = DeviceManager::instance().getStreamDocks();
+	for (const auto &device : *streamdocks)
 	{
 		try
 		{
@@ -42,7 +42,7 @@ int main()
 			std::cerr << "Unknown exception occurred" << std::endl;
 		}
 	}
-	if(streamdocks.empty())
+	if(streamdocks->empty())
 	{
 		std::cout << "No StreamDock devices found. Connect a device to run tests and check your PID && VID." << std::endl;
 	}
@@ -505,7 +505,8 @@ namespace TEST_N4Pro
 		device->reader()->registerReadCallback(24, []()
 											   { debugPrint("knob 1 Press"); }, RegisterEvent::KnobPress, true);
 		auto N4pro = std::dynamic_pointer_cast<StreamDockN4Pro>(device);
-		N4pro->registerTouchBarCallback(nullptr, true);
+		N4pro->registerTouchBarCallback([](const TouchEvent& touch)
+										{ std::cerr << "point: (" << touch.x << ", " << touch.y << ")" << std::endl; }, true);
 	}
 }
 
@@ -0,0 +1,119 @@
+/**
+ * @file broadcast_check.cpp
+ * @brief Checks that DeviceManager::broadcast() resolves when the encoder and the callback throw.
+ *
+ * Two devices share a profile whose encoder throws (one group), a third throws a non-std
+ * exception, and `onDevice` throws as well. Every device must still get a result with
+ * ok = false and the future must resolve instead of ending in broken_promise. No hardware
+ * is needed: the devices are registered under made-up HID paths and never reach an upload.
+ */
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <DeviceManager/devicemanager.h>
+
+#ifndef STREAMDOCK_TEST_DATA_DIR
+#define STREAMDOCK_TEST_DATA_DIR "img"
+#endif
+
+namespace
+{
+/// Throws from every entry point; `standard` picks std::runtime_error or a plain int.
+class ThrowingEncoder : public IImageEncoder
+{
+public:
+	explicit ThrowingEncoder(bool standard) : _standard(standard) {}
+
+	bool encodeToFile(const std::string&, const RawCanvas&, int, const ImgHelper&) const override { return fail(); }
+	bool encodeToMemory(std::vector<uint8_t>&, const RawCanvas&, int, const ImgHelper&) const override { return fail(); }
+	bool encodeToFile(const std::string&, std::vector<uint8_t>&, int, const ImgHelper&) const override { return fail(); }
+	bool encodeToMemory(std::vector<uint8_t>&, const std::vector<uint8_t>&, int, const ImgHelper&) const override { return fail(); }
+	bool encodeToBitmap(std::vector<uint8_t>&, const std::vector<uint8_t>&, const ImgHelper&) const override { return fail(); }
+
+private:
+	bool fail() const
+	{
+		if (_standard)
+			throw std::runtime_error("encoder failure");
+		throw 42;
+	}
+
+	bool _standard;
+};
+
+/// A 15-key device with 64x64 key images and no hardware behind its path.
+class FakeDock : public StreamDock
+{
+public:
+	FakeDock(const hid_device_info& info, bool standardThrow)
+		: StreamDock(info)
+	{
+		_info->keyWidth = 64;
+		_info->keyHeight = 64;
+		_info->minKey = 1;
+		_info->maxKey = 15;
+		initImgHelper();
+		setEncoder(std::make_shared<ThrowingEncoder>(standardThrow));
+	}
+};
+
+std::shared_ptr<StreamDock> fakeDock(const std::string& path, bool standardThrow)
+{
+	hid_device_info info{};
+	info.path = const_cast<char*>(path.c_str());
+	return std::make_shared<FakeDock>(info, standardThrow);
+}
+}
+
+int main()
+{
+	const std::vector<std::string> paths = { "broadcast-check:1", "broadcast-check:2", "broadcast-check:3" };
+	auto& manager = DeviceManager::instance();
+	manager.registry().insert(paths[0], fakeDock(paths[0], true));
+	manager.registry().insert(paths[1], fakeDock(paths[1], true));
+	manager.registry().insert(paths[2], fakeDock(paths[2], false));
+
+	BroadcastImage image;
+	image.filePath = std::string(STREAMDOCK_TEST_DATA_DIR) + "/button_test.jpg";
+	image.keyValue = 1;
+	image.paths = paths;
+	auto future = manager.broadcast(image, [](const BroadcastResult&)
+		{ throw std::runtime_error("callback failure"); });
+
+	int failures = 0;
+	if (future.wait_for(std::chrono::seconds(10)) != std::future_status::ready)
+	{
+		std::printf("FAIL broadcast did not resolve\n");
+		return 1;
+	}
+	std::vector<BroadcastResult> results;
+	try
+	{
+		results = future.get();
+	}
+	catch (const std::exception& e)
+	{
+		std::printf("FAIL broadcast future threw: %s\n", e.what());
+		return 1;
+	}
+	if (results.size() != paths.size())
+	{
+		std::printf("FAIL %zu results for %zu devices\n", results.size(), paths.size());
+		return 1;
+	}
+	for (size_t i = 0; i < paths.size(); ++i)
+	{
+		if (results[i].path != paths[i] || results[i].ok)
+		{
+			std::printf("FAIL %s: path %s, ok %d\n", paths[i].c_str(), results[i].path.c_str(), results[i].ok ? 1 : 0);
+			++failures;
+		}
+	}
+
+	for (const auto& path : paths)
+		manager.registry().erase(path);
+	std::printf("%zu devices resolved, %d failures\n", results.size(), failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file timerwheel_check.cpp
+ * @brief Checks that TimerWheel never fires a timer before its delay, even while the wheel is behind.
+ *
+ * A periodic task keeps a 10 ms wheel busy by sleeping longer than a tick now and then, so
+ * the wheel runs catch-up ticks back to back. One-shot timers added at random points of
+ * that cycle must still fire no earlier than their delay. Returns non-zero on the first
+ * early fire.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <random>
+#include <thread>
+#include "timerwheel.h"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr int RUNS = 40;
+constexpr std::chrono::milliseconds TICK{ 10 };
+const std::chrono::milliseconds DELAYS[] = { std::chrono::milliseconds(1), std::chrono::milliseconds(10),
+	std::chrono::milliseconds(25), std::chrono::milliseconds(50) };
+}
+
+int main()
+{
+	TimerWheel wheel(TICK);
+	std::atomic<unsigned> beat{ 0 };
+	const TimerWheel::TimerId busy = wheel.scheduleEvery(TICK, [&beat]
+		{
+			// Every third run overruns by more than a tick: the wheel falls behind and catches up
+			if (beat.fetch_add(1) % 3 == 0)
+				std::this_thread::sleep_for(std::chrono::milliseconds(17));
+		});
+
+	std::mt19937 rng(0x7153);
+	std::uniform_int_distribution<int> jitter(0, 9999);
+	int early = 0;
+	for (int run = 0; run < RUNS; ++run)
+	{
+		for (std::chrono::milliseconds delay : DELAYS)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(jitter(rng)));
+			std::promise<Clock::time_point> fired;
+			auto firedAt = fired.get_future();
+			const Clock::time_point start = Clock::now();
+			wheel.schedule(delay, [&fired] { fired.set_value(Clock::now()); });
+			const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(firedAt.get() - start);
+			if (elapsed < delay)
+			{
+				std::printf("FAIL run %d: %lld ms timer fired after %.1f ms\n", run,
+					static_cast<long long>(delay.count()), elapsed.count() / 1000.0);
+				++early;
+			}
+		}
+	}
+	wheel.cancel(busy);
+
+	std::printf("%d runs, %d early fires\n", RUNS, early);
+	return early == 0 ? 0 : 1;
+}